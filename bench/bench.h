@@ -0,0 +1,73 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench.h
+ * @brief common declarations of tomload benchmarks.
+ * @note target version of C++ is C++14.
+ */
+
+#ifndef TOMLOAD_BENCH_BENCH_H_
+#define TOMLOAD_BENCH_BENCH_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+namespace bench {
+
+/*
+ * @brief Run `func` `repeat` times and return the best elapsed time in milliseconds.
+ */
+template <typename FUNC>
+double measure_ms(FUNC func, int repeat = 5) {
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+        if ((i == 0) || (ms < best)) {
+            best = ms;
+        }
+    }
+    return best;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get argv[index] as size_t, or `default_value` if it is not given.
+ */
+inline size_t arg_size(int argc, char** argv, int index, size_t default_value) {
+    return (index < argc) ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : default_value;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Each benchmark receives the arguments after its name.
+ * @return exit code.
+ */
+int dedup(int argc, char** argv);
+int memory(int argc, char** argv);
+int lazy(int argc, char** argv);
+int update(int argc, char** argv);
+int copy(int argc, char** argv);
+int equal(int argc, char** argv);
+int diff(int argc, char** argv);
+int overlay(int argc, char** argv);
+int sax(int argc, char** argv);
+int reader(int argc, char** argv);
+int stream(int argc, char** argv);
+int file(int argc, char** argv);
+int istream(int argc, char** argv);
+int validate(int argc, char** argv);
+int try_parse(int argc, char** argv);
+int locate(int argc, char** argv);
+int lint(int argc, char** argv);
+int depth(int argc, char** argv);
+int headers(int argc, char** argv);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
+
+#endif  // TOMLOAD_BENCH_BENCH_H_
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_copy.cpp
+ * @brief benchmark of item_t::copy_to().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int copy(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 100000);
+    std::string src = "weights = [";
+    for (size_t i = 0; i < size; ++i) {
+        src += (i != 0 ? ", " : "") + std::to_string(i) + ".5";
+    }
+    src += "]\n";
+    tomload::item_t item(src);
+    const tomload::item_t& weights = item["weights"];
+
+    std::vector<float> out(size);
+    double get_ms = measure_ms([&] {
+        size_t i = 0;
+        for (const tomload::item_t& w : weights.array_range()) {
+            w.get(out[i++]);
+        }
+    });
+    double copy_ms = measure_ms([&] { weights.copy_to(out.data(), out.size()); });
+
+    std::cout << "array: " << size << " floats" << std::endl;
+    std::cout << "get<float>() per element: " << get_ms << " ms" << std::endl;
+    std::cout << "copy_to(float*, size_t): " << copy_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
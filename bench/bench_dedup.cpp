@@ -0,0 +1,60 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_dedup.cpp
+ * @brief benchmark of parse_options_t::dedup_strings.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace {
+
+/*
+ * @brief inventory-style document; most string values repeat across hosts.
+ */
+std::string make_inventory(size_t hosts) {
+    const char* regions[] = {"us-east-1", "us-west-2", "eu-central-1", "ap-northeast-1"};
+    const char* states[] = {"enabled", "disabled", "draining"};
+
+    std::string ret = "[hosts]\n";
+    for (size_t i = 0; i < hosts; ++i) {
+        std::string region = regions[i % 4];
+        ret += "h" + std::to_string(i) + " = { fqdn = \"h" + std::to_string(i) + ".example.com\", region = \"" + region + "\", zone = \"" + region +
+               static_cast<char>('a' + (i % 3)) + "\", state = \"" + states[i % 3] +
+               "\", role = \"frontend-service-pool\", tags = [\"production\", \"managed-by-terraform\"] }\n";
+    }
+    return ret;
+}
+
+}  // namespace
+
+namespace bench {
+
+int dedup(int argc, char** argv) {
+    size_t hosts = arg_size(argc, argv, 1, 100000);
+    std::string src = make_inventory(hosts);
+
+    tomload::parse_options_t plain;
+    tomload::parse_options_t pooled;
+    tomload::parse_stats_t stats;
+    pooled.dedup_strings = true;
+    pooled.stats = &stats;
+
+    double plain_ms = measure_ms([&] { tomload::item_t item(src, plain); });
+    double pooled_ms = measure_ms([&] { tomload::item_t item(src, pooled); });
+
+    std::cout << "document: " << hosts << " hosts, " << src.size() << " bytes" << std::endl;
+    std::cout << "strings: " << stats.strings << ", unique: " << stats.unique_strings
+              << ", dedup ratio: " << stats.dedup_ratio() << std::endl;
+    std::cout << "parse (plain): " << plain_ms << " ms" << std::endl;
+    std::cout << "parse (dedup): " << pooled_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,66 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_depth.cpp
+ * @brief benchmark of parse_events() for deeply nested arrays, compared with flat arrays.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/sax.h"
+
+namespace bench {
+
+namespace {
+
+/*
+ * @brief Count the arrays, which needs no tree.
+ */
+struct array_counter_t : tomload::handler_t {
+    size_t arrays = 0;
+    void on_array_begin(void) override { ++arrays; }
+};
+
+}  // namespace
+
+int depth(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 100000);
+    std::string deep = "a = " + std::string(size, '[') + "1" + std::string(size, ']') + "\n";
+    std::string flat = "a = [";
+    for (size_t i = 1; i < size; ++i) {
+        flat += "[1],";
+    }
+    flat += "]\n";
+
+    size_t arrays = 0;
+    size_t flat_arrays = 0;
+    double deep_ms = measure_ms([&] {
+        array_counter_t handler;
+        handler.set_max_depth(size);
+        tomload::parse_events(deep, handler);
+        arrays = handler.arrays;
+    });
+    double flat_ms = measure_ms([&] {
+        array_counter_t handler;
+        tomload::parse_events(flat, handler);
+        flat_arrays = handler.arrays;
+    });
+    double limit_ms = measure_ms([&] {
+        array_counter_t handler;
+        try {
+            tomload::parse_events(deep, handler);
+        } catch (const tomload::parse_error&) {
+        }
+    });
+
+    std::cout << "nested " << arrays << " deep: " << deep_ms << " ms" << std::endl;
+    std::cout << "flat " << flat_arrays << " arrays: " << flat_ms << " ms" << std::endl;
+    std::cout << "nested, rejected at depth " << tomload::DEFAULT_MAX_DEPTH << ": " << limit_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,43 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_diff.cpp
+ * @brief benchmark of tomload::diff().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/diff.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int diff(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 10000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "[server" + std::to_string(i) + "]\nhost = \"10.0.0." + std::to_string(i % 256) +
+               "\"\nports = [80, 443]\nweight = 0.5\n";
+    }
+    tomload::item_t before(src);
+    tomload::item_t reloaded(src + "[extra]\nenabled = true\n");
+    tomload::item_t updated = before.with({"server0", "weight"}, tomload::item_t("w = 0.25\n")["w"]);
+
+    size_t reloaded_changes = 0;
+    size_t updated_changes = 0;
+    double reloaded_ms = measure_ms([&] { reloaded_changes = tomload::diff(before, reloaded).size(); });
+    double updated_ms = measure_ms([&] { updated_changes = tomload::diff(before, updated).size(); });
+
+    std::cout << "document: " << size << " tables" << std::endl;
+    std::cout << "diff against reparsed document: " << reloaded_ms << " ms, "
+              << reloaded_changes << " changes" << std::endl;
+    std::cout << "diff against updated document (shared subtrees): " << updated_ms << " ms, "
+              << updated_changes << " changes" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,43 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_equal.cpp
+ * @brief benchmark of item_t::operator==() and item_t::hash().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int equal(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 10000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "[server" + std::to_string(i) + "]\nhost = \"10.0.0." + std::to_string(i % 256) +
+               "\"\nports = [80, 443]\nweight = 0.5\n";
+    }
+    tomload::item_t lhs(src);
+    tomload::item_t rhs(src);
+    tomload::item_t changed = rhs.with({"server0", "weight"}, tomload::item_t("w = 0.25\n")["w"]);
+
+    bool result = false;
+    double first_ms = measure_ms([&] { result = (lhs == rhs); }, 1);
+    double equal_ms = measure_ms([&] { result = (lhs == rhs); });
+    double changed_ms = measure_ms([&] { result = (lhs == changed); });
+    double hash_ms = measure_ms([&] { result = (lhs.hash() != 0); });
+
+    std::cout << "document: " << size << " tables" << std::endl;
+    std::cout << "first comparison (hashes computed): " << first_ms << " ms" << std::endl;
+    std::cout << "equal documents (hash cached): " << equal_ms << " ms" << std::endl;
+    std::cout << "one value changed (hash mismatch): " << changed_ms << " ms" << std::endl;
+    std::cout << "hash() again: " << hash_ms << " ms (" << result << ")" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,79 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_file.cpp
+ * @brief benchmark of load_file(), compared with reading the file into a buffer first.
+ * @note target version of C++ is C++14.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "bench/bench.h"
+#include "tomload/file.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+namespace {
+
+/*
+ * @brief Ask the kernel to drop the cached pages of the file, so that each run starts cold.
+ * @note best effort. it does nothing if the platform does not support it.
+ */
+void drop_cache(const std::string& path) {
+#if defined(__unix__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+int file(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 200000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "key" + std::to_string(i) + " = \"value " + std::to_string(i) + "\"\n";
+    }
+    const std::string path = "bench_file.toml";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << src;
+    }
+
+    double buffer_ms = measure_ms([&] {
+        drop_cache(path);
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        tomload::item_t item(tomload::view_t(buffer.data(), buffer.size()));
+    });
+    double mapped_ms = measure_ms([&] {
+        drop_cache(path);
+        tomload::document_t doc = tomload::load_file(path);
+    });
+    std::remove(path.c_str());
+
+    std::cout << "document: " << size << " keys, " << src.size() << " bytes" << std::endl;
+    std::cout << "ifstream into buffer: " << buffer_ms << " ms" << std::endl;
+    std::cout << "load_file: " << mapped_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,43 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_headers.cpp
+ * @brief benchmark of documents with many table headers, by item_t and validate().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+#include "tomload/validate.h"
+
+namespace bench {
+
+int headers(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 40000);
+    for (size_t count = size / 4; count <= size; count *= 2) {
+        std::string src;
+        for (size_t i = 0; i < count; ++i) {
+            std::string n = std::to_string(i);
+            src += "[zone" + std::to_string(i % 100) + ".host" + n + "]\n";
+            src += "name = \"host" + n + "\"\n";
+            src += "net.port = " + std::to_string(8000 + i % 1000) + "\n";
+            src += "net.tags = [\"a\", \"b\"]\n";
+        }
+
+        size_t tables = 0;
+        bool valid = false;
+        double item_ms = measure_ms([&] { tables = tomload::item_t(src).size(); });
+        double validate_ms = measure_ms([&] { valid = tomload::validate(src).valid; });
+
+        std::cout << count << " headers, " << src.size() << " bytes, " << tables << " zones, valid " << valid << std::endl;
+        std::cout << "  item_t: " << item_ms << " ms, " << (item_ms * 1000.0 / count) << " us/header" << std::endl;
+        std::cout << "  validate(): " << validate_ms << " ms, " << (validate_ms * 1000.0 / count) << " us/header" << std::endl;
+    }
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,101 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_istream.cpp
+ * @brief benchmark of parse_stream() over a generated std::istream of any size.
+ * @note target version of C++ is C++14.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <streambuf>
+#include <string>
+#if defined(__unix__)
+#include <sys/resource.h>
+#endif
+#include "bench/bench.h"
+#include "tomload/sax.h"
+#include "tomload/stream_parser.h"
+
+namespace bench {
+
+namespace {
+
+/*
+ * @brief Stream buffer which generates key-value pairs on the fly, so the input is never held in memory.
+ */
+class generator_buf_t : public std::streambuf {
+ public:
+    explicit generator_buf_t(size_t bytes) : rest_(bytes) {}
+
+ protected:
+    int_type underflow(void) override {
+        if (rest_ == 0) {
+            return traits_type::eof();
+        }
+        line_ = "key" + std::to_string(count_) + " = " + std::to_string(count_) + "\n";
+        ++count_;
+        if (line_.size() > rest_) {
+            // end with a comment, so that the document stays valid
+            line_.assign(rest_, '#');
+            line_.back() = '\n';
+        }
+        rest_ -= line_.size();
+        setg(&line_[0], &line_[0], &line_[0] + line_.size());
+        return traits_type::to_int_type(line_[0]);
+    }
+
+ private:
+    size_t rest_;
+    size_t count_ = 0;
+    std::string line_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+struct sum_handler_t : tomload::handler_t {
+    int64_t sum = 0;
+    void on_integer(int64_t value) override { sum += value; }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Peak resident set size in KiB, or 0 if it is not available.
+ */
+long peak_rss_kb(void) {
+#if defined(__unix__)
+    struct rusage usage;
+    std::memset(&usage, 0, sizeof(usage));
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+int istream(int argc, char** argv) {
+    size_t megabytes = arg_size(argc, argv, 1, 256);
+    size_t buffer_size = arg_size(argc, argv, 2, tomload::default_stream_buffer_size);
+
+    long rss_before = peak_rss_kb();
+    sum_handler_t handler;
+    double ms = measure_ms([&] {
+        generator_buf_t buf(megabytes * 1024 * 1024);
+        std::istream in(&buf);
+        handler.sum = 0;
+        tomload::parse_stream(in, handler, buffer_size);
+    }, 1);
+    long rss_after = peak_rss_kb();
+
+    std::cout << "input: " << megabytes << " MiB, read buffer: " << buffer_size << " bytes" << std::endl;
+    std::cout << "parse_stream: " << ms << " ms (" << (megabytes * 1000.0 / ms) << " MiB/s), sum " << handler.sum << std::endl;
+    std::cout << "peak RSS: " << rss_before << " KiB before, " << rss_after << " KiB after" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
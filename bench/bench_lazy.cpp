@@ -0,0 +1,77 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_lazy.cpp
+ * @brief benchmark of parse_options_t::lazy_numbers.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace {
+
+/*
+ * @brief tuning-table-style document; each table has many numbers, and few of them are read.
+ */
+std::string make_tuning(size_t tables) {
+    std::string ret;
+    for (size_t i = 0; i < tables; ++i) {
+        ret += "[t" + std::to_string(i) + "]\n";
+        ret += "weights = [";
+        for (size_t j = 0; j < 16; ++j) {
+            ret += (j != 0 ? ", " : "") + std::to_string(i * 16 + j) + ".125";
+        }
+        ret += "]\n";
+        ret += "thresholds = [";
+        for (size_t j = 0; j < 16; ++j) {
+            ret += (j != 0 ? ", " : "") + std::to_string(1000000 + i * 16 + j);
+        }
+        ret += "]\n";
+        ret += "limit = 1_000_000\nratio = 6.02e23\n";
+    }
+    return ret;
+}
+
+/*
+ * @brief read 1 number out of each table (about 3% of the numbers).
+ */
+double sparse_read(const tomload::item_t& item) {
+    double sum = 0.0;
+    for (const auto& table : item.table_range()) {
+        sum += table.second["weights"][3].get_float();
+    }
+    return sum;
+}
+
+}  // namespace
+
+namespace bench {
+
+int lazy(int argc, char** argv) {
+    size_t tables = arg_size(argc, argv, 1, 20000);
+    std::string src = make_tuning(tables);
+
+    tomload::parse_options_t eager;
+    tomload::parse_options_t lazy;
+    lazy.lazy_numbers = true;
+
+    volatile double sink = 0.0;
+    double eager_ms = measure_ms([&] { tomload::item_t item(src, eager); });
+    double lazy_ms = measure_ms([&] { tomload::item_t item(src, lazy); });
+    double eager_read_ms = measure_ms([&] { tomload::item_t item(src, eager); sink = sparse_read(item); });
+    double lazy_read_ms = measure_ms([&] { tomload::item_t item(src, lazy); sink = sparse_read(item); });
+
+    std::cout << "document: " << tables << " tables, " << tables * 34 << " numbers, " << src.size() << " bytes" << std::endl;
+    std::cout << "load (eager): " << eager_ms << " ms" << std::endl;
+    std::cout << "load (lazy): " << lazy_ms << " ms" << std::endl;
+    std::cout << "load + sparse read (eager): " << eager_read_ms << " ms" << std::endl;
+    std::cout << "load + sparse read (lazy): " << lazy_read_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
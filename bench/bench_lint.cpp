@@ -0,0 +1,48 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_lint.cpp
+ * @brief benchmark of lint(), compared with validate().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/validate.h"
+
+namespace bench {
+
+int lint(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 20000);
+    std::string valid;
+    std::string invalid;
+    for (size_t i = 0; i < size; ++i) {
+        std::string n = std::to_string(i);
+        std::string lines = (i % 1000 == 0) ? "[group" + n + "]\n" : "";
+        lines += "service" + n + ".name = \"service \\\"" + n + "\\\"\"\n";
+        lines += "service" + n + ".port = " + std::to_string(8000 + i) + "\n";
+        lines += "service" + n + ".limits = { cpu = 1.5, memory = \"512Mi\", tags = [\"a\", \"b\", \"c\"] }\n";
+        valid += lines;
+        invalid += lines;
+        if (i % 100 == 0) {  // one error in every 100 services
+            invalid += "service" + n + ((i % 200 == 0) ? ".port = 1\n" : ".ratio = 0.\n");
+        }
+    }
+
+    bool ok = false;
+    size_t errors = 0;
+    double validate_ms = measure_ms([&] { ok = tomload::validate(valid).valid; });
+    double valid_ms = measure_ms([&] { ok = ok && tomload::lint(valid).errors.empty(); });
+    double invalid_ms = measure_ms([&] { errors = tomload::lint(invalid, size).errors.size(); });
+
+    std::cout << "document: " << size << " services, " << valid.size() << " bytes, valid " << ok << std::endl;
+    std::cout << "validate(): " << validate_ms << " ms" << std::endl;
+    std::cout << "lint(): " << valid_ms << " ms" << std::endl;
+    std::cout << "lint() with " << errors << " errors: " << invalid_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
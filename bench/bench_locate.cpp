@@ -0,0 +1,54 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_locate.cpp
+ * @brief benchmark of locating a parse error by line and column.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int locate(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 1000000);
+    std::string valid;
+    for (size_t i = 0; i < size; ++i) {
+        valid += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+    }
+    std::string invalid = valid + "broken = [1 2]\n";  // the error is on the last line
+
+    double valid_ms = measure_ms([&] { tomload::item_t item(valid); });
+    size_t offset = 0;
+    double invalid_ms = measure_ms([&] {
+        try {
+            tomload::item_t item(invalid);
+        } catch (const tomload::parse_error& e) {
+            offset = e.offset();
+        }
+    });
+
+    tomload::source_location_t location;
+    double locate_ms = measure_ms([&] { location = tomload::locate(invalid, offset); });
+    size_t line = 0;
+    double scalar_ms = measure_ms([&] {
+        line = 1;
+        for (size_t i = 0; i < offset; ++i) {
+            line += (invalid[i] == '\n') ? 1 : 0;
+        }
+    });
+
+    std::cout << "document: " << size << " lines, " << invalid.size() << " bytes" << std::endl;
+    std::cout << "item_t (valid): " << valid_ms << " ms" << std::endl;
+    std::cout << "item_t (invalid, offset " << offset << "): " << invalid_ms << " ms" << std::endl;
+    std::cout << "locate(): " << locate_ms << " ms, line " << location.line << ", column " << location.column << std::endl;
+    std::cout << "byte loop: " << scalar_ms << " ms, line " << line << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_memory.cpp
+ * @brief print memory usage of a TOML file, see item_t::memory_usage().
+ * @note target version of C++ is C++14.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace {
+
+/*
+ * @brief memory_resource which counts the bytes outstanding, to compare with the estimate.
+ */
+class counting_resource_t : public tomload::memory_resource {
+ public:
+    size_t outstanding = 0;
+
+ private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        outstanding += bytes;
+        return tomload::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        tomload::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const tomload::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void print_usage(const std::string& name, const tomload::memory_usage_t& usage) {
+    std::cout << name << ": total " << usage.total() << " (nodes " << usage.nodes << ", keys " << usage.keys
+              << ", strings " << usage.strings << ", slack " << usage.slack << ")" << std::endl;
+}
+
+}  // namespace
+
+namespace bench {
+
+int memory(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "no file is given" << std::endl;
+        return 1;
+    }
+    std::ifstream ifs(argv[1], std::ios::binary);
+    if (not ifs) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string src{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+
+    counting_resource_t resource;
+    tomload::parse_options_t options;
+    options.resource = &resource;
+    tomload::item_t item(src, options);
+
+    tomload::memory_usage_t usage;
+    double ms = measure_ms([&] { usage = item.memory_usage(); });
+
+    std::cout << "document: " << src.size() << " bytes" << std::endl;
+    print_usage("document", usage);
+    std::cout << "allocated: " << resource.outstanding << std::endl;
+    std::cout << "memory_usage(): " << ms << " ms" << std::endl;
+    for (const auto& i : item.table_range()) {
+        print_usage("  " + std::string(i.first.data(), i.first.size()), i.second.memory_usage());
+    }
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_overlay.cpp
+ * @brief benchmark of overlay_t, compared with merging into an empty document.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/overlay.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int overlay(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 10000);
+    tomload::item_t host("[server0]\nweight = 0.25\n[server1]\nports = [8080]\n");
+
+    for (size_t n = size / 10; n <= size; n *= 10) {
+        std::string src;
+        for (size_t i = 0; i < n; ++i) {
+            src += "[server" + std::to_string(i) + "]\nhost = \"10.0.0." + std::to_string(i % 256) +
+                   "\"\nports = [80, 443]\nweight = 0.5\n";
+        }
+        tomload::item_t defaults(src);
+        tomload::overlay_t config({defaults, host});
+
+        double lookup_ms = measure_ms([&] { config["server1"]["ports"].item().size(); });
+        double flatten_ms = measure_ms([&] { config.flatten(); });
+        double copy_ms = measure_ms([&] { tomload::item_t("").merged(defaults).merged(host); });
+
+        std::cout << "defaults: " << n << " tables" << std::endl;
+        std::cout << "  lookup through layers: " << lookup_ms << " ms" << std::endl;
+        std::cout << "  flatten(): " << flatten_ms << " ms" << std::endl;
+        std::cout << "  merge into empty document: " << copy_ms << " ms" << std::endl;
+    }
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
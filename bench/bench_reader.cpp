@@ -0,0 +1,73 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_reader.cpp
+ * @brief benchmark of reader_t, compared with parse_events().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/reader.h"
+#include "tomload/sax.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+namespace {
+
+struct sum_handler_t : tomload::handler_t {
+    tomload::integer_t sum = 0;
+    void on_integer(tomload::integer_t value) override { sum += value; }
+};
+
+}  // namespace
+
+int reader(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 50000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "[server" + std::to_string(i) + "]\nport = " + std::to_string(i % 1000) +
+               "\nnote = \"escaped\\tdescription of the server\\n\"\nlabels = [\"a\", \"b\", { c = 1 }]\n";
+    }
+
+    tomload::integer_t sum = 0;
+    double sax_ms = measure_ms([&] {
+        sum_handler_t handler;
+        tomload::parse_events(src, handler);
+        sum = handler.sum;
+    });
+    double reader_ms = measure_ms([&] {
+        tomload::reader_t r(src);
+        sum = 0;
+        for (const tomload::token_t* t = &r.next(); t->kind != tomload::TOKEN_END; t = &r.next()) {
+            if (t->kind == tomload::TOKEN_INTEGER) {
+                sum += t->i;
+            }
+        }
+    });
+    double skip_ms = measure_ms([&] {
+        tomload::reader_t r(src);
+        sum = 0;
+        for (const tomload::token_t* t = &r.next(); t->kind != tomload::TOKEN_END; t = &r.next()) {
+            if (t->kind != tomload::TOKEN_KEY) {
+                continue;
+            } else if (r.keys().back() == "port") {
+                sum += r.next().i;
+            } else {
+                r.skip();
+            }
+        }
+    });
+
+    std::cout << "document: " << size << " tables, " << src.size() << " bytes, sum " << sum << std::endl;
+    std::cout << "parse_events(): " << sax_ms << " ms" << std::endl;
+    std::cout << "reader_t, every token: " << reader_ms << " ms" << std::endl;
+    std::cout << "reader_t, skip() except port: " << skip_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_sax.cpp
+ * @brief benchmark of parse_events(), compared with building item_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/sax.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+namespace {
+
+/*
+ * @brief Sum of the integers, which needs no tree.
+ */
+struct sum_handler_t : tomload::handler_t {
+    tomload::integer_t sum = 0;
+    void on_integer(tomload::integer_t value) override { sum += value; }
+};
+
+}  // namespace
+
+int sax(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 5000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "[server" + std::to_string(i) + "]\nhost = \"10.0.0." + std::to_string(i % 256) +
+               "\"\nports = [80, 443]\nlimits = { cpu = 2, memory = 512 }\n";
+    }
+
+    tomload::integer_t sum = 0;
+    double dom_ms = measure_ms([&] {
+        tomload::item_t item(src);
+        sum = 0;
+        for (const auto& server : item.table_range()) {
+            for (const tomload::item_t& port : server.second["ports"].array_range()) {
+                sum += port.get_integer();
+            }
+            sum += server.second["limits"]["cpu"].get_integer() + server.second["limits"]["memory"].get_integer();
+        }
+    });
+    double sax_ms = measure_ms([&] {
+        sum_handler_t handler;
+        tomload::parse_events(src, handler);
+        sum = handler.sum;
+    });
+
+    std::cout << "document: " << size << " tables, " << src.size() << " bytes, sum " << sum << std::endl;
+    std::cout << "item_t and traversal: " << dom_ms << " ms" << std::endl;
+    std::cout << "parse_events(): " << sax_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
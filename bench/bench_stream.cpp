@@ -0,0 +1,46 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_stream.cpp
+ * @brief benchmark of stream_parser_t, compared with parsing the whole buffer.
+ * @note target version of C++ is C++14.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/stream_parser.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int stream(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 200000);
+    size_t chunk = arg_size(argc, argv, 2, 4096);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        src += "key" + std::to_string(i) + " = \"\"\"\nvalue " + std::to_string(i) + "\"\"\"\n";
+    }
+
+    double whole_ms = measure_ms([&] { tomload::item_t item(src); });
+    size_t peak = 0;
+    double stream_ms = measure_ms([&] {
+        tomload::stream_parser_t parser;
+        for (size_t pos = 0; pos < src.size(); pos += chunk) {
+            parser.feed(tomload::view_t(src.data() + pos, std::min(chunk, src.size() - pos)));
+            peak = std::max(peak, parser.pending());
+        }
+        parser.finish();
+        parser.release();
+    });
+
+    std::cout << "document: " << size << " keys, " << src.size() << " bytes" << std::endl;
+    std::cout << "whole buffer: " << whole_ms << " ms" << std::endl;
+    std::cout << "chunks of " << chunk << " bytes: " << stream_ms << " ms, peak pending " << peak << " bytes" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_try_parse.cpp
+ * @brief benchmark of try_parse(), compared with item_t and catching parse_error.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "tomload/parse_result.h"
+#include "tomload/tomload.h"
+
+namespace bench {
+
+int try_parse(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 20000);
+
+    // small uploads, and every other one is broken somewhere in the middle.
+    const char* const errors[] = {
+        "owner = \"dup\"\n",     // duplicated key
+        "port = 80_\n",          // ill-formed number
+        "note = \"unclosed\n",   // string not closed
+        "tags = [\"a\" \"b\"]\n", // missing comma
+    };
+    std::vector<std::string> corpus;
+    for (size_t i = 0; i < size; ++i) {
+        std::string n = std::to_string(i);
+        std::string src = "name = \"upload " + n + "\"\nsize = " + n + "\n[meta]\nowner = \"user" + n + "\"\n";
+        if (i % 2 == 1) {
+            src += errors[(i / 2) % 4];
+        }
+        src += "created = 1.5\nlabels = { kind = \"doc\", level = 3 }\n";
+        corpus.push_back(src);
+    }
+
+    size_t try_parse_invalid = 0;
+    double try_parse_ms = measure_ms([&] {
+        try_parse_invalid = 0;
+        for (const std::string& src : corpus) {
+            if (not tomload::try_parse(src)) {
+                ++try_parse_invalid;
+            }
+        }
+    });
+    size_t item_invalid = 0;
+    double item_ms = measure_ms([&] {
+        item_invalid = 0;
+        for (const std::string& src : corpus) {
+            try {
+                tomload::item_t item(src);
+            } catch (const tomload::parse_error&) {
+                ++item_invalid;
+            }
+        }
+    });
+
+    std::cout << "corpus: " << size << " documents, " << try_parse_invalid << " invalid" << std::endl;
+    std::cout << "try_parse(): " << try_parse_ms << " ms, "
+              << static_cast<double>(size) / try_parse_ms * 1000.0 << " documents/s" << std::endl;
+    std::cout << "item_t and catch: " << item_ms << " ms, "
+              << static_cast<double>(size) / item_ms * 1000.0 << " documents/s, " << item_invalid << " invalid" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
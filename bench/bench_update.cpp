@@ -0,0 +1,68 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_update.cpp
+ * @brief benchmark of item_t::with().
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+
+namespace {
+
+const size_t fanout = 16;
+
+/*
+ * @brief table tree whose every table has `fanout` children; the leaves are integers.
+ */
+tomload::item_t make_tree(size_t depth) {
+    tomload::table_t table;
+    for (size_t i = 0; i < fanout; ++i) {
+        tomload::key_t key = "k" + std::to_string(i);
+        if (depth <= 1) {
+            table.emplace(std::move(key), tomload::item_t{tomload::single_construct, static_cast<tomload::integer_t>(i)});
+        } else {
+            table.emplace(std::move(key), make_tree(depth - 1));
+        }
+    }
+    return tomload::item_t{tomload::single_construct, std::move(table)};
+}
+
+}  // namespace
+
+namespace bench {
+
+int update(int argc, char** argv) {
+    size_t max_depth = arg_size(argc, argv, 1, 5);
+    const size_t updates = 10000;
+
+    std::cout << "fanout: " << fanout << ", " << updates << " updates of a leaf" << std::endl;
+    for (size_t depth = 1; depth <= max_depth; ++depth) {
+        tomload::item_t tree = make_tree(depth);
+        tomload::path_t path(depth, tomload::path_element_t("k7"));
+        size_t leaves = 1;
+        for (size_t i = 0; i < depth; ++i) {
+            leaves *= fanout;
+        }
+
+        double with_ms = measure_ms([&] {
+            for (size_t i = 0; i < updates; ++i) {
+                tomload::item_t updated = tree.with(path, tomload::item_t{tomload::single_construct, static_cast<tomload::integer_t>(i)});
+            }
+        }, 3);
+        double copy_ms = measure_ms([&] {
+            tomload::item_t copied = make_tree(depth);
+        }, 3);
+
+        std::cout << "depth " << depth << " (" << leaves << " leaves): with() " << with_ms * 1000.0 / updates
+                  << " us/update, rebuild " << copy_ms * 1000.0 << " us" << std::endl;
+    }
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,43 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/bench_validate.cpp
+ * @brief benchmark of validate(), compared with building item_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include <iostream>
+#include <string>
+#include "bench/bench.h"
+#include "tomload/tomload.h"
+#include "tomload/validate.h"
+
+namespace bench {
+
+int validate(int argc, char** argv) {
+    size_t size = arg_size(argc, argv, 1, 20000);
+    std::string src;
+    for (size_t i = 0; i < size; ++i) {
+        std::string n = std::to_string(i);
+        if (i % 1000 == 0) {
+            src += "[group" + n + "]\n";
+        }
+        src += "service" + n + ".name = \"service \\\"" + n + "\\\"\"\n";
+        src += "service" + n + ".port = " + std::to_string(8000 + i) + "\n";
+        src += "service" + n + ".ratio = 0." + n + "\n";
+        src += "service" + n + ".limits = { cpu = 1.5, memory = \"512Mi\", tags = [\"a\", \"b\", \"c\"] }\n";
+    }
+
+    bool valid = false;
+    double validate_ms = measure_ms([&] { valid = tomload::validate(src).valid; });
+    double item_ms = measure_ms([&] { tomload::item_t item(src); });
+
+    std::cout << "document: " << size << " services, " << src.size() << " bytes, valid " << valid << std::endl;
+    std::cout << "validate(): " << validate_ms << " ms" << std::endl;
+    std::cout << "item_t: " << item_ms << " ms" << std::endl;
+    return 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace bench
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file bench/main.cpp
+ * @brief entry point of tomload benchmarks.
+ * @details usage: tomload_bench <name> [args...]
+ *          run without arguments to list the benchmarks.
+ * @note target version of C++ is C++14.
+ */
+
+#include <cstring>
+#include <iostream>
+#include "bench/bench.h"
+
+namespace {
+
+struct entry_t {
+    const char* name;
+    const char* usage;
+    int (*func)(int argc, char** argv);
+};
+
+const entry_t entries[] = {
+    {"dedup", "[hosts=100000]: parse inventory-style document with and without string deduplication", bench::dedup},
+    {"memory", "<file>: print memory usage of the document and its top-level entries", bench::memory},
+    {"lazy", "[tables=20000]: load tuning tables and read few numbers, with and without lazy numeric conversion", bench::lazy},
+    {"update", "[depth=5]: update a leaf by item_t::with() in trees of growing depth", bench::update},
+    {"copy", "[size=100000]: extract array of floats by get<T>() per element and by copy_to()", bench::copy},
+    {"equal", "[size=10000]: compare documents with and without cached hashes", bench::equal},
+    {"diff", "[size=10000]: list changes between a document and its reloaded or updated copy", bench::diff},
+    {"overlay", "[size=10000]: resolve and flatten a small override over defaults of growing size", bench::overlay},
+    {"sax", "[size=5000]: sum integers by parse_events() and by building item_t", bench::sax},
+    {"reader", "[size=50000]: read integers by reader_t with and without skip(), and by parse_events()", bench::reader},
+    {"stream", "[size=200000] [chunk=4096]: parse a document fed in chunks, and as a whole buffer", bench::stream},
+    {"file", "[size=200000]: load a file by load_file() and by reading it into a buffer, with a cold page cache", bench::file},
+    {"istream", "[megabytes=256] [buffer=65536]: parse a generated std::istream through a fixed buffer, and print the peak memory", bench::istream},
+    {"validate", "[size=20000]: check a document by validate() and by building item_t", bench::validate},
+    {"try_parse", "[size=20000]: parse documents, half invalid, by try_parse() and by item_t with catch", bench::try_parse},
+    {"locate", "[size=1000000]: locate a parse error at the end by line and column", bench::locate},
+    {"lint", "[size=20000]: report all errors of a document by lint(), compared with validate()", bench::lint},
+    {"depth", "[size=100000]: parse arrays nested deeply without recursion, compared with flat arrays", bench::depth},
+    {"headers", "[size=40000]: load documents of growing numbers of table headers by item_t and validate()", bench::headers},
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2) {
+        for (const entry_t& entry : entries) {
+            if (std::strcmp(argv[1], entry.name) == 0) {
+                return entry.func(argc - 1, argv + 1);
+            }
+        }
+    }
+
+    std::cerr << "usage: " << argv[0] << " <name> [args...]" << std::endl;
+    for (const entry_t& entry : entries) {
+        std::cerr << "  " << entry.name << " " << entry.usage << std::endl;
+    }
+    return 1;
+}
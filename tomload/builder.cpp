@@ -0,0 +1,129 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/builder.cpp
+ * @brief implement tomload::builder_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/builder.h"
+#include <stdexcept>
+#include <tuple>
+
+namespace tomload {
+
+/*
+ * @brief Create a builder of table.
+ * @param resource[in]: resource of the document. nullptr means the default resource.
+ */
+builder_t builder_t::make_table(memory_resource* resource) {
+    return builder_t(true, resource);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Create a builder of array.
+ * @param resource[in]: resource of the document. nullptr means the default resource.
+ */
+builder_t builder_t::make_array(memory_resource* resource) {
+    return builder_t(false, resource);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Create a builder of table which uses the same resource as this builder.
+ */
+builder_t builder_t::make_child_table(void) const {
+    return builder_t(true, resource_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Create a builder of array which uses the same resource as this builder.
+ */
+builder_t builder_t::make_child_array(void) const {
+    return builder_t(false, resource_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Reserve the capacity of array. it does nothing for table.
+ * @param size[in]: expected number of elements.
+ * @return *this.
+ */
+builder_t& builder_t::reserve(size_t size) {
+    if (not is_table_) {
+        array_.reserve(size);
+    }
+    return *this;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Number of elements inserted.
+ */
+size_t builder_t::size(void) const noexcept {
+    return is_table_ ? table_.size() : array_.size();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Finish building.
+ * @return built array or table. the builder must not be used after that.
+ */
+item_t builder_t::build(void) && {
+    resource_scope_t scope(resource_);
+    if (is_table_) {
+        return item_t{single_construct, std::move(table_)};
+    } else {
+        return item_t{single_construct, std::move(array_)};
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+builder_t::builder_t(bool is_table, memory_resource* resource) :
+    is_table_(is_table),
+    resource_((resource != nullptr) ? resource : get_default_resource()),
+    array_(allocator_t<item_t>(resource_)),
+    table_(key_compare_t(), allocator_t<table_t::value_type>(resource_)) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @throw type_error: if this builder is not table.
+ * @throw std::invalid_argument: if `key` is already inserted.
+ */
+void builder_t::emplace_item(view_t key, item_t&& item) {
+    if (not is_table_) {
+        throw type_error("not table");
+    }
+
+    size_t size = table_.size();
+    // the hint makes the insertion constant time when keys come in ascending order.
+    table_.emplace_hint(table_.end(), std::piecewise_construct,
+                        std::forward_as_tuple(key.data(), key.size()), std::forward_as_tuple(std::move(item)));
+    if (table_.size() == size) {
+        throw std::invalid_argument("duplicated key");
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @throw type_error: if this builder is not array.
+ */
+void builder_t::emplace_back_item(item_t&& item) {
+    if (is_table_) {
+        throw type_error("not array");
+    }
+    array_.push_back(std::move(item));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t builder_t::make_string(view_t str) const {
+    resource_scope_t scope(resource_);
+    return item_t{single_construct, text_t(str.data(), str.size())};
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,152 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/builder.h
+ * @brief Header file for builder_t class.
+ * @details builder_t creates item_t without parsing.
+ *          a builder owns one array or table under construction, and the containers, keys and
+ *          strings are allocated from the resource given to make_array() or make_table(),
+ *          e.g. monotonic_resource_t. values are moved into place, so nothing is copied.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::monotonic_resource_t arena;
+ *      tomload::builder_t root = tomload::builder_t::make_table(&arena);
+ *      tomload::builder_t ports = root.make_child_array();
+ *      ports.reserve(2).emplace_back(80).emplace_back(443);
+ *      root.emplace("name", "frontend").emplace("ports", std::move(ports));
+ *      tomload::item_t item = std::move(root).build();  // {"name":"frontend","ports":[80,443]}
+ */
+
+#ifndef TOMLOAD_BUILDER_H_
+#define TOMLOAD_BUILDER_H_
+
+#include <type_traits>
+#include <utility>
+#include "tomload/memory_resource.h"
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @class builder_t
+ * @brief Move-only builder of an array or a table.
+ */
+class builder_t {
+ public:
+    /*
+     * @brief Create a builder of table.
+     * @param resource[in]: resource of the document. nullptr means the default resource.
+     */
+    static builder_t make_table(memory_resource* resource = nullptr);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create a builder of array.
+     * @param resource[in]: resource of the document. nullptr means the default resource.
+     */
+    static builder_t make_array(memory_resource* resource = nullptr);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create a builder of table which uses the same resource as this builder.
+     */
+    builder_t make_child_table(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create a builder of array which uses the same resource as this builder.
+     */
+    builder_t make_child_array(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    builder_t(builder_t&&) noexcept = default;
+    builder_t& operator=(builder_t&&) noexcept = default;
+    builder_t(const builder_t&) = delete;
+    builder_t& operator=(const builder_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Reserve the capacity of array. it does nothing for table.
+     * @param size[in]: expected number of elements.
+     * @return *this.
+     */
+    builder_t& reserve(size_t size);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Insert a value into table.
+     * @param key[in]: key of the value.
+     * @param value[in]: boolean, integral, floating point, string, builder_t or item_t.
+     * @return *this.
+     * @throw type_error: if this builder is not table.
+     * @throw std::invalid_argument: if `key` is already inserted.
+     * @note keys inserted in ascending order are inserted in constant time.
+     */
+    template <typename VALUE>
+    builder_t& emplace(view_t key, VALUE&& value) {
+        emplace_item(key, to_item(std::forward<VALUE>(value)));
+        return *this;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Append a value to array.
+     * @param value[in]: boolean, integral, floating point, string, builder_t or item_t.
+     * @return *this.
+     * @throw type_error: if this builder is not array.
+     */
+    template <typename VALUE>
+    builder_t& emplace_back(VALUE&& value) {
+        emplace_back_item(to_item(std::forward<VALUE>(value)));
+        return *this;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of elements inserted.
+     */
+    size_t size(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Finish building.
+     * @return built array or table. the builder must not be used after that.
+     */
+    item_t build(void) &&;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    builder_t(bool is_table, memory_resource* resource);
+    /////////////////////////////////////////////////////////////////////////////
+
+    void emplace_item(view_t key, item_t&& item);
+    void emplace_back_item(item_t&& item);
+    item_t make_string(view_t str) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    item_t to_item(boolean_t value) const { return item_t{single_construct, value}; }
+    item_t to_item(view_t value) const { return make_string(value); }
+    item_t to_item(const char* value) const { return make_string(view_t(value)); }
+    item_t to_item(const std::string& value) const { return make_string(view_t(value.data(), value.size())); }
+    item_t to_item(builder_t&& value) const { return std::move(value).build(); }
+    item_t to_item(item_t value) const { return value; }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && not std::is_same<T, bool>::value, int>::type = 0>
+    item_t to_item(T value) const { return item_t{single_construct, static_cast<integer_t>(value)}; }
+
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    item_t to_item(T value) const { return item_t{single_construct, static_cast<float_t>(value)}; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    bool is_table_;
+    memory_resource* resource_;
+    array_t array_;
+    table_t table_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_BUILDER_H_
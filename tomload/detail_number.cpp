@@ -3,15 +3,51 @@
 
 /*
  * @file tomload/detail_number.cpp
- * @note target version of C++ is C++14. 
+ * @note target version of C++ is C++14.
  */
 
 #include "tomload/detail_number.h"
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <string>
 
 namespace tomload {
 
+namespace {
+
+/*
+ * @brief Copy the digits of `sub` without '_', so that strtoll() or strtod() can read them.
+ */
+std::string remove_underscores(view_t sub) {
+    std::string str;
+    std::copy_if(sub.begin(), sub.end(), std::back_inserter(str),
+                 [](char c) { return c != '_'; });
+    return str;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert the digits by strtoll(), which reports errors by errno instead of exceptions.
+ */
+integer_t to_integer(view_t sub, int base, parse_status_t& status) {
+    std::string str = remove_underscores(sub);
+    char* end = nullptr;
+    errno = 0;
+    long long ret = std::strtoll(str.c_str(), &end, base);
+    if ((end == str.c_str()) || (*end != '\0')) {
+        status.fail(PARSE_NUMBER, "invalid_argument", sub.data());
+        return 0;
+    } else if (errno == ERANGE) {
+        status.fail(PARSE_OUT_OF_RANGE, "out_of_range", sub.data());
+        return 0;
+    }
+    return static_cast<integer_t>(ret);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
 /*
  * @pre `view` must start with "0x", "0o", or "0b"
  */
@@ -29,6 +65,17 @@ view_t::size_type get_radix_length(view_t view) {
  * @pre `view` must start with "0x", "0o", or "0b"
  */
 integer_t parse_radix_value(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    integer_t ret = parse_radix_value(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with "0x", "0o", or "0b"
+ */
+integer_t parse_radix_value(view_t view, view_t::size_type length, parse_status_t& status) {
     int base = starts_with(view, "0x") ? 16 :
                           starts_with(view, "0o") ? 8 :
                           starts_with(view, "0b") ? 2 : 10;
@@ -37,20 +84,11 @@ integer_t parse_radix_value(view_t view, view_t::size_type length) {
     if (starts_with(sub, "_") ||
         ends_with(sub, "_") ||
         contains(sub, "__")) {
-        throw parse_error("invalid `_`");
+        status.fail(PARSE_NUMBER, "invalid `_`", view.data());
+        return 0;
     }
 
-    std::string str;
-    std::copy_if(sub.begin(), sub.end(), std::back_inserter(str),
-                 [](char c) { return c != '_'; });
-
-    try {
-        return std::stoll(str, nullptr, base);
-    } catch (std::out_of_range& err) {
-        throw parse_error("out_of_range");
-    } catch (std::invalid_argument& err) {
-        throw parse_error("invalid_argument");
-    }
+    return to_integer(sub, base, status);
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -64,35 +102,89 @@ view_t::size_type get_integer_length(view_t view) {
 /////////////////////////////////////////////////////////////////////////////
 
 /*
+ * @brief Check the syntax of integer without conversion.
  * @pre `view` must start with one of "+-0123456789"
+ * @throw parse_error: if the integer is ill-formed.
  */
-integer_t parse_integer(view_t view, view_t::size_type length) {
+void validate_integer(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    validate_integer(view, length, status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the syntax of integer without conversion.
+ * @pre `view` must start with one of "+-0123456789"
+ */
+void validate_integer(view_t view, view_t::size_type length, parse_status_t& status) {
     view_t sub(view.data(), length);
     if (starts_with(sub, {"_", "+_", "-_"}) ||
         ends_with(sub, "_") ||
         contains(sub, "__")) {
-        throw parse_error("invalid `_`");
+        status.fail(PARSE_NUMBER, "invalid `_`", view.data());
+        return;
     }
 
-    std::string str;
-    std::copy_if(sub.begin(), sub.end(), std::back_inserter(str),
-                 [](char c) { return c != '_'; });
-
-    view_t ref{str.c_str()};
-    if (starts_with(ref, {"+", "-"})) {
-        ref.remove_prefix(1);
+    if (starts_with(sub, {"+", "-"})) {
+        sub.remove_prefix(1);
     }
-    if (starts_with(ref, "0") && (ref.size() > 1)) {
-        throw parse_error("starts with 0");
+    if (sub.empty()) {
+        status.fail(PARSE_NUMBER, "missing integer digits", view.data());
+    } else if (starts_with(sub, "0") && (sub.size() > 1)) {
+        status.fail(PARSE_NUMBER, "starts with 0", view.data());
     }
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    try {
-        return std::stoll(str, nullptr, 10);
-    } catch (std::out_of_range& err) {
-        throw parse_error("out_of_range");
-    } catch (std::invalid_argument& err) {
-        throw parse_error("invalid_argument");
-    }
+/*
+ * @pre validate_integer(view, length) does not throw.
+ * @throw parse_error: if the integer is out of range.
+ */
+integer_t convert_integer(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    integer_t ret = convert_integer(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre validate_integer(view, length) does not fail.
+ */
+integer_t convert_integer(view_t view, view_t::size_type length, parse_status_t& status) {
+    return to_integer(view_t(view.data(), length), 10, status);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with one of "+-0123456789"
+ */
+integer_t parse_integer(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    integer_t ret = parse_integer(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with one of "+-0123456789"
+ */
+integer_t parse_integer(view_t view, view_t::size_type length, parse_status_t& status) {
+    validate_integer(view, length, status);
+    return status.failed() ? 0 : convert_integer(view, length, status);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check convert_integer() never fails for the validated integer.
+ * @pre validate_integer(view, length) does not throw.
+ */
+bool is_integer_in_range(view_t view, view_t::size_type length) {
+    // up to 18 digits always fit in int64_t.
+    view_t sub(view.data(), length);
+    return std::count_if(sub.begin(), sub.end(), [](char c) { return ('0' <= c) && (c <= '9'); }) <= 18;
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -100,6 +192,17 @@ integer_t parse_integer(view_t view, view_t::size_type length) {
  * @pre `view` must start with one of "+-0123456789"
  */
 view_t::size_type get_float_length(view_t view) {
+    parse_status_t status;
+    view_t::size_type ret = get_float_length(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with one of "+-0123456789"
+ */
+view_t::size_type get_float_length(view_t view, parse_status_t& status) {
     view_t::size_type pos = get_integer_length(view);
 
     if (pos < view.size() && view[pos] == '.') {
@@ -107,7 +210,8 @@ view_t::size_type get_float_length(view_t view) {
 
         view_t::size_type decimal_pos = view.find_first_not_of("0123456789_", pos);
         if (decimal_pos == pos) {
-            throw parse_error("must digit after '.'");
+            status.fail(PARSE_NUMBER, "must digit after '.'", view.data() + pos);
+            return 0;
         }
         pos = (decimal_pos != view_t::npos) ? decimal_pos : view.size();
     }
@@ -120,7 +224,8 @@ view_t::size_type get_float_length(view_t view) {
         }
         view_t::size_type expo_pos = view.find_first_not_of("0123456789_", pos);
         if (expo_pos == pos) {
-            throw parse_error("must digit after 'e' or 'E'");
+            status.fail(PARSE_NUMBER, "must digit after 'e' or 'E'", view.data() + pos);
+            return 0;
         }
         pos = (expo_pos != view_t::npos) ? expo_pos : view.size();
     }
@@ -130,38 +235,106 @@ view_t::size_type get_float_length(view_t view) {
 /////////////////////////////////////////////////////////////////////////////
 
 /*
+ * @brief Check the syntax of float without conversion.
  * @pre `view` must start with one of "+-0123456789"
+ * @throw parse_error: if the float is ill-formed.
  */
-float_t parse_float(view_t view, view_t::size_type length) {
+void validate_float(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    validate_float(view, length, status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the syntax of float without conversion.
+ * @pre `view` must start with one of "+-0123456789"
+ */
+void validate_float(view_t view, view_t::size_type length, parse_status_t& status) {
     view_t sub(view.data(), length);
     if (starts_with(sub, "_") ||
         ends_with(sub, "_") ||
         contains(sub, {"__", "+_", "_+", "-_", "_-", "._", "_.", "e_", "_e", "E_", "_E"})) {
-        throw parse_error("invalid `_`");
+        status.fail(PARSE_NUMBER, "invalid `_`", view.data());
+        return;
     }
 
-    std::string str;
-    std::copy_if(sub.begin(), sub.end(), std::back_inserter(str),
-                 [](char c) { return c != '_'; });
-
-    view_t ref{str.c_str()};
-    if (starts_with(ref, {"+", "-"})) {
-        ref.remove_prefix(1);
+    if (starts_with(sub, {"+", "-"})) {
+        sub.remove_prefix(1);
     }
-    if (starts_with(ref, "0") && not starts_with(ref, {"0.", "0e", "0E"})) {
-        throw parse_error("starts with 0");
+    if (starts_with(sub, "0") && not starts_with(sub, {"0.", "0e", "0E"})) {
+        status.fail(PARSE_NUMBER, "starts with 0", view.data());
+    } else if (starts_with(sub, {".", "e", "E"})) {
+        status.fail(PARSE_NUMBER, "missing integer digits", view.data());
     }
-    if (starts_with(ref, {".", "e", "E"})) {
-        throw parse_error("missing integer digits");
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre validate_float(view, length) does not throw.
+ * @throw parse_error: if the float is out of range.
+ */
+float_t convert_float(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    float_t ret = convert_float(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre validate_float(view, length) does not fail.
+ */
+float_t convert_float(view_t view, view_t::size_type length, parse_status_t& status) {
+    std::string str = remove_underscores(view_t(view.data(), length));
+    char* end = nullptr;
+    errno = 0;
+    double ret = std::strtod(str.c_str(), &end);
+    if ((end == str.c_str()) || (*end != '\0')) {
+        status.fail(PARSE_NUMBER, "invalid_argument", view.data());
+        return 0.0;
+    } else if (errno == ERANGE) {  // overflow or underflow, as std::stod()
+        status.fail(PARSE_OUT_OF_RANGE, "out_of_range", view.data());
+        return 0.0;
     }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with one of "+-0123456789"
+ */
+float_t parse_float(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    float_t ret = parse_float(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with one of "+-0123456789"
+ */
+float_t parse_float(view_t view, view_t::size_type length, parse_status_t& status) {
+    validate_float(view, length, status);
+    return status.failed() ? 0.0 : convert_float(view, length, status);
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    try {
-        return std::stod(str, nullptr);
-    } catch (std::out_of_range& err) {
-        throw parse_error("out_of_range");
-    } catch (std::invalid_argument& err) {
-        throw parse_error("invalid_argument");
+/*
+ * @brief Check convert_float() never fails for the validated float.
+ * @pre validate_float(view, length) does not throw.
+ */
+bool is_float_in_range(view_t view, view_t::size_type length) {
+    // up to 17 characters of mantissa and 2 digits of exponent stay within 1e-116 to 1e116.
+    view_t sub(view.data(), length);
+    view_t::size_type e = sub.find_first_of("eE");
+    view_t mantissa = sub.substr(0, e);
+    view_t exponent = (e != view_t::npos) ? sub.substr(e + 1) : view_t();
+    if (starts_with(exponent, {"+", "-"})) {
+        exponent.remove_prefix(1);
     }
+    return (mantissa.size() <= 17) && (exponent.size() <= 2);
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -3,6 +3,8 @@
 
 /*
  * @file tomload/detail_number.h
+ * @details each function which may fail has two overloads: the one with parse_status_t records
+ *          the error in it, and the other throws parse_error.
  * @note target version of C++ is C++14. 
  */
 
@@ -24,6 +26,7 @@ view_t::size_type get_radix_length(view_t view);
  * @pre `view` must start with "0x", "0o", or "0b"
  */
 integer_t parse_radix_value(view_t view, view_t::size_type length);
+integer_t parse_radix_value(view_t view, view_t::size_type length, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -32,22 +35,73 @@ integer_t parse_radix_value(view_t view, view_t::size_type length);
 view_t::size_type get_integer_length(view_t view);
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Check the syntax of integer without conversion.
+ * @pre `view` must start with one of "+-0123456789"
+ * @throw parse_error: if the integer is ill-formed.
+ */
+void validate_integer(view_t view, view_t::size_type length);
+void validate_integer(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre validate_integer(view, length) does not throw.
+ * @throw parse_error: if the integer is out of range.
+ */
+integer_t convert_integer(view_t view, view_t::size_type length);
+integer_t convert_integer(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @pre `view` must start with one of "+-0123456789"
  */
 integer_t parse_integer(view_t view, view_t::size_type length);
+integer_t parse_integer(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check convert_integer() never fails for the validated integer.
+ * @pre validate_integer(view, length) does not throw.
+ */
+bool is_integer_in_range(view_t view, view_t::size_type length);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with one of "+-0123456789"
  */
 view_t::size_type get_float_length(view_t view);
+view_t::size_type get_float_length(view_t view, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the syntax of float without conversion.
+ * @pre `view` must start with one of "+-0123456789"
+ * @throw parse_error: if the float is ill-formed.
+ */
+void validate_float(view_t view, view_t::size_type length);
+void validate_float(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre validate_float(view, length) does not throw.
+ * @throw parse_error: if the float is out of range.
+ */
+float_t convert_float(view_t view, view_t::size_type length);
+float_t convert_float(view_t view, view_t::size_type length, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with one of "+-0123456789"
  */
 float_t parse_float(view_t view, view_t::size_type length);
+float_t parse_float(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check convert_float() never fails for the validated float.
+ * @pre validate_float(view, length) does not throw.
+ */
+bool is_float_in_range(view_t view, view_t::size_type length);
 /////////////////////////////////////////////////////////////////////////////
 
 }  // namespace tomload
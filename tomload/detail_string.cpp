@@ -7,9 +7,75 @@
  */
 
 #include "tomload/detail_string.h"
+#include <algorithm>
 
 namespace tomload {
 
+namespace {
+
+/*
+ * @brief Check `view` consists of hex digits only, without the locale as std::isxdigit().
+ */
+bool is_hex_digits(view_t view) noexcept {
+    return view.find_first_not_of("0123456789ABCDEFabcdef") == view_t::npos;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Append the content of a basic or multi-line basic string to `ret`, resolving escapes.
+ * @pre `sub` is the content between the delimiters, whose length is already checked.
+ */
+template <typename STRING>
+void unescape(view_t sub, STRING& ret, parse_status_t& status) {
+    for (view_t::size_type i = 0; (i < sub.size()) && not status.failed(); i++) {
+        if (sub[i] == '\\') {
+            i++;
+
+            if (sub[i] == 'n') {
+                ret.push_back('\n');
+            } else if (sub[i] == 'r') {
+                ret.push_back('\r');
+            } else if (sub[i] == 't') {
+                ret.push_back('\t');
+            } else if (sub[i] == 'b') {
+                ret.push_back('\b');
+            } else if (sub[i] == 'f') {
+                ret.push_back('\f');
+            } else if (sub[i] == '\\') {
+                ret.push_back('\\');
+            } else if (sub[i] == '"') {
+                ret.push_back('"');
+            } else if (sub[i] == 'u') {
+                std::string utf8 = parse_unicode_escape(sub.substr(i + 1), 4, status);
+                ret.append(utf8.data(), utf8.size());
+                i += 4;
+            } else if (sub[i] == 'U') {
+                std::string utf8 = parse_unicode_escape(sub.substr(i + 1), 8, status);
+                ret.append(utf8.data(), utf8.size());
+                i += 8;
+            } else if ((sub[i] == '\r') || (sub[i] == '\n') || (sub[i] == '\t') || (sub[i] == ' ')) {
+                // line ending backslash of multi-line string
+                view_t::size_type pos = sub.find_first_not_of("\r\n\t ", i + 1);
+                i += pos - (i + 1);
+            }
+        } else {
+            ret.push_back(sub[i]);
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Output of unescape() which discards the characters, to check the escapes only.
+ */
+struct discard_t {
+    void push_back(char) noexcept {}
+    void append(const char*, size_t) noexcept {}
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
 /**
  * @brief Encodes a Unicode code point into its UTF-8 string representation.
  *
@@ -27,6 +93,17 @@ namespace tomload {
  * @throw parse_error: when detect invalid unicode escape or surrogate pair in 2 bytes.
  */
 std::string utf8_encode(uint32_t codepoint) {
+    parse_status_t status;
+    std::string ret = utf8_encode(codepoint, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as utf8_encode(codepoint), but the error is recorded in `status`.
+ */
+std::string utf8_encode(uint32_t codepoint, parse_status_t& status) {
     if (codepoint <= 0x7F) {  // 1-byte UTF-8
         return {static_cast<char>(codepoint)};
     } else if (codepoint <= 0x7FF) {  // 2-byte UTF-8
@@ -34,7 +111,8 @@ std::string utf8_encode(uint32_t codepoint) {
                 static_cast<char>(0x80 | (codepoint & 0x3F))};
     } else if (codepoint <= 0xFFFF) {  // 3-byte UTF-8
         if ((0xD800 <= codepoint) && (codepoint <= 0xDFFF)) {  // U+D800 ～ U+DFFF
-            throw parse_error("detect surrogate pair in 2bytes (U+D800 - U+DFFF)");
+            status.fail(PARSE_STRING, "detect surrogate pair in 2bytes (U+D800 - U+DFFF)");
+            return {};
         }
         return {static_cast<char>(0xE0 | (codepoint >> 12)),
                 static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)),
@@ -45,7 +123,8 @@ std::string utf8_encode(uint32_t codepoint) {
                 static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)),
                 static_cast<char>(0x80 | (codepoint & 0x3F))};
     } else {
-        throw parse_error("invalid unicode escape sequence");  // Invalid code point
+        status.fail(PARSE_STRING, "invalid unicode escape sequence");  // Invalid code point
+        return {};
     }
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -54,10 +133,22 @@ std::string utf8_encode(uint32_t codepoint) {
  * @pre `view` must start with "'''"
  */
 view_t::size_type get_multi_literal_string_length(view_t view) {
+    parse_status_t status;
+    view_t::size_type ret = get_multi_literal_string_length(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with "'''"
+ */
+view_t::size_type get_multi_literal_string_length(view_t view, parse_status_t& status) {
     view_t::size_type pos = view.find("'''", 3);
 
     if (pos == view_t::npos) {
-        throw parse_error("not closed by '''");
+        status.fail(PARSE_STRING, "not closed by '''", view.data());
+        return 0;
     }
 
     if (pos == view.find("'''''", 3)) {
@@ -73,13 +164,13 @@ view_t::size_type get_multi_literal_string_length(view_t view) {
 /*
  * @pre `view` must start with "'''"
  */
-string_t parse_multi_literal_string(view_t& view, view_t::size_type length) {
+text_t parse_multi_literal_string(view_t& view, view_t::size_type length) {
     if (starts_with(view, "'''\r\n")) {
-        return string_t(view.data() + 5, length - 8);
+        return text_t(view.data() + 5, length - 8);
     } else if (starts_with(view, "'''\n")) {
-        return string_t(view.data() + 4, length - 7);
+        return text_t(view.data() + 4, length - 7);
     } else {
-        return string_t(view.data() + 3, length - 6);
+        return text_t(view.data() + 3, length - 6);
     }
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -88,18 +179,26 @@ string_t parse_multi_literal_string(view_t& view, view_t::size_type length) {
  * @pre `view` must start with "'"
  */
 view_t::size_type get_literal_string_length(view_t view) {
-    view_t::size_type pos = view.find("'", 1);
+    parse_status_t status;
+    view_t::size_type ret = get_literal_string_length(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    if (pos == view_t::npos) {
-        throw parse_error("not closed by '");
-    }
+/*
+ * @pre `view` must start with "'"
+ */
+view_t::size_type get_literal_string_length(view_t view, parse_status_t& status) {
+    // the search stops at the end of the line, so that the error does not depend on the rest of the document.
+    view_t::size_type pos = view.find_first_of("'\r\n", 1);
 
-    view_t::size_type pos_r = view.find("\r", 1);
-    view_t::size_type pos_n = view.find("\n", 1);
-    if ((pos_r != view_t::npos) && (pos_r < pos)) {
-        throw parse_error("detect newline in literal string");
-    } else if ((pos_n != view_t::npos) && (pos_n < pos)) {
-        throw parse_error("detect newline in literal string");
+    if (pos == view_t::npos) {
+        status.fail(PARSE_STRING, "not closed by '", view.data());
+        return 0;
+    } else if (view[pos] != '\'') {
+        status.fail(PARSE_STRING, "detect newline in literal string", view.data() + pos);
+        return 0;
     }
 
     return pos + 1;
@@ -109,8 +208,8 @@ view_t::size_type get_literal_string_length(view_t view) {
 /*
  * @pre `view` must start with "'"
  */
-string_t parse_literal_string(view_t& view, view_t::size_type length) {
-    return string_t(view.data() + 1, length - 2);
+text_t parse_literal_string(view_t& view, view_t::size_type length) {
+    return text_t(view.data() + 1, length - 2);
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -118,18 +217,40 @@ string_t parse_literal_string(view_t& view, view_t::size_type length) {
  * @pre `view` must starts with 4 or 8 digits hex
  */
 std::string parse_unicode_escape(const view_t& view, int size) {
-    auto is_hex = [](char c) {  // avoid to use std::isxdigit() because that depends on the locale
-        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+    parse_status_t status;
+    std::string ret = parse_unicode_escape(view, size, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must starts with 4 or 8 digits hex
+ */
+std::string parse_unicode_escape(const view_t& view, int size, parse_status_t& status) {
+    // avoid to use std::isxdigit() because that depends on the locale
+    auto hex_value = [](char c) -> int {
+        return (c >= '0' && c <= '9') ? (c - '0') :
+               (c >= 'A' && c <= 'F') ? (c - 'A' + 10) :
+               (c >= 'a' && c <= 'f') ? (c - 'a' + 10) : -1;
     };
 
-    if (size > view.size()) {
-        throw parse_error("invalid unicode escape sequence");
+    if (static_cast<view_t::size_type>(size) > view.size()) {
+        status.fail(PARSE_STRING, "invalid unicode escape sequence", view.data());
+        return {};
     }
-    if (not std::all_of(view.data(), view.data() + size, is_hex)) {
-        throw parse_error("invalid unicode escape sequence");
+    uint32_t codepoint = 0;
+    for (int i = 0; i < size; ++i) {
+        int digit = hex_value(view[i]);
+        if (digit < 0) {
+            status.fail(PARSE_STRING, "invalid unicode escape sequence", view.data());
+            return {};
+        }
+        codepoint = (codepoint << 4) | static_cast<uint32_t>(digit);
     }
-    uint32_t codepoint = static_cast<uint32_t>(std::stoul(std::string(view.data(), size), nullptr, 16));
-    return utf8_encode(codepoint);
+    std::string ret = utf8_encode(codepoint, status);
+    status.locate(view.data());
+    return ret;
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -137,6 +258,17 @@ std::string parse_unicode_escape(const view_t& view, int size) {
  * @pre `view` must start with '"""'
  */
 view_t::size_type get_multi_string_length(view_t view) {
+    parse_status_t status;
+    view_t::size_type ret = get_multi_string_length(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with '"""'
+ */
+view_t::size_type get_multi_string_length(view_t view, parse_status_t& status) {
     bool detected_backslash = false;
     for (view_t::size_type i = 3; i < view.size(); i++) {
         if (not detected_backslash) {
@@ -154,51 +286,70 @@ view_t::size_type get_multi_string_length(view_t view) {
                 (view[i] == 'f') || (view[i] == '\\') || (view[i] == '"')) {
             } else if (view[i] == 'u') {
                 if (i + 4 > view.size()) {
-                    throw parse_error("invalid unicode escape sequence");
+                    status.fail(PARSE_STRING, "invalid unicode escape sequence", view.data() + i);
+                    return 0;
                 }
                 i += 4;
             } else if (view[i] == 'U') {
                 if (i + 8 > view.size()) {
-                    throw parse_error("invalid unicode escape sequence");
+                    status.fail(PARSE_STRING, "invalid unicode escape sequence", view.data() + i);
+                    return 0;
                 }
                 i += 8;
             } else if ((view[i] == '\r') || (view[i] == '\n')) {
                 view_t::size_type pos = view.find_first_not_of("\r\n\t ", i + 1);
                 if (pos == view_t::npos) {
-                    throw parse_error("not closed by \"\"\"");
+                    status.fail(PARSE_STRING, "not closed by \"\"\"", view.data());
+                    return 0;
                 }
                 i += pos - (i + 1);
             } else if ((view[i] == '\t') || (view[i] == ' ')) {
                 view_t::size_type pos = view.find_first_not_of("\t ", i + 1);
                 if (pos == view_t::npos) {
-                    throw parse_error("not closed by \"\"\"");
+                    status.fail(PARSE_STRING, "not closed by \"\"\"", view.data());
+                    return 0;
                 }
                 i += pos - i;
 
                 if ((view[i] == '\r') || (view[i] == '\n')) {
                     pos = view.find_first_not_of("\r\n\t ", i + 1);
                     if (pos == view_t::npos) {
-                        throw parse_error("not closed by \"\"\"");
+                        status.fail(PARSE_STRING, "not closed by \"\"\"", view.data());
+                        return 0;
                     }
                     i += pos - (i + 1);
                 } else {
-                    throw parse_error("invalid escape sequence");
+                    status.fail(PARSE_STRING, "invalid escape sequence", view.data() + i);
+                    return 0;
                 }
             } else {
-                throw parse_error("invalid escape sequence");
+                status.fail(PARSE_STRING, "invalid escape sequence", view.data() + i);
+                return 0;
             }
             detected_backslash = false;
         }
     }
-    throw parse_error("not closed by \"\"\"");
+    status.fail(PARSE_STRING, "not closed by \"\"\"", view.data());
+    return 0;
 }
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"""'
  */
-string_t parse_multi_string(view_t view, view_t::size_type length) {
-    std::string ret;
+text_t parse_multi_string(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    text_t ret = parse_multi_string(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with '"""'
+ */
+text_t parse_multi_string(view_t view, view_t::size_type length, parse_status_t& status) {
+    text_t ret;
 
     view_t sub(view.data() + 3, length - 6);
 
@@ -208,38 +359,7 @@ string_t parse_multi_string(view_t view, view_t::size_type length) {
         sub = sub.substr(1);
     }
 
-    for (view_t::size_type i = 0; i < sub.size(); i++) {
-        if (sub[i] == '\\') {
-            i++;
-
-            if (sub[i] == 'n') {
-                ret.push_back('\n');
-            } else if (sub[i] == 'r') {
-                ret.push_back('\r');
-            } else if (sub[i] == 't') {
-                ret.push_back('\t');
-            } else if (sub[i] == 'b') {
-                ret.push_back('\b');
-            } else if (sub[i] == 'f') {
-                ret.push_back('\f');
-            } else if (sub[i] == '\\') {
-                ret.push_back('\\');
-            } else if (sub[i] == '"') {
-                ret.push_back('"');
-            } else if (sub[i] == 'u') {
-                ret += parse_unicode_escape(sub.substr(i + 1), 4);
-                i += 4;
-            } else if (sub[i] == 'U') {
-                ret += parse_unicode_escape(sub.substr(i + 1), 8);
-                i += 8;
-            } else if ((sub[i] == '\r') || (sub[i] == '\n') || (sub[i] == '\t') || (sub[i] == ' ')) {
-                view_t::size_type pos = sub.find_first_not_of("\r\n\t ", i + 1);
-                i += pos - (i + 1);
-            }
-        } else {
-            ret.push_back(sub[i]);
-        }
-    }
+    unescape(sub, ret, status);
     return ret;
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -248,6 +368,17 @@ string_t parse_multi_string(view_t view, view_t::size_type length) {
  * @pre `view` must start with '"'
  */
 view_t::size_type get_string_length(view_t view) {
+    parse_status_t status;
+    view_t::size_type ret = get_string_length(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with '"'
+ */
+view_t::size_type get_string_length(view_t view, parse_status_t& status) {
     bool detected_backslash = false;
     for (view_t::size_type i = 1; i < view.size(); i++) {
         if (not detected_backslash) {
@@ -256,84 +387,114 @@ view_t::size_type get_string_length(view_t view) {
             } else if (view[i] == '\\') {
                 detected_backslash = true;
             } else if (view[i] == '\n' || view[i] == '\r') {
-                throw parse_error("detect newline in string");
+                status.fail(PARSE_STRING, "detect newline in string", view.data() + i);
+                return 0;
             }
         } else {
             if ((view[i] == 'n') || (view[i] == 'r') || (view[i] == 't') || (view[i] == 'b') ||
                 (view[i] == 'f') || (view[i] == '\\') || (view[i] == '"')) {
-            } else if (view[i] == 'u') {
-                if (i + 4 > view.size()) {
-                    throw parse_error("invalid unicode escape sequence");
+            } else if ((view[i] == 'u') || (view[i] == 'U')) {
+                // the digits are checked here, so that a newline is never skipped as a digit.
+                view_t::size_type size = (view[i] == 'u') ? 4 : 8;
+                if ((i + size >= view.size()) || not is_hex_digits(view.substr(i + 1, size))) {
+                    status.fail(PARSE_STRING, "invalid unicode escape sequence", view.data() + i + 1);
+                    return 0;
                 }
-                i += 4;
-            } else if (view[i] == 'U') {
-                if (i + 8 > view.size()) {
-                    throw parse_error("invalid unicode escape sequence");
-                }
-                i += 8;
+                i += size;
             } else {
-                throw parse_error("invalid escape sequence");
+                status.fail(PARSE_STRING, "invalid escape sequence", view.data() + i);
+                return 0;
             }
             detected_backslash = false;
         }
     }
-    throw parse_error("not closed by \"");
+    status.fail(PARSE_STRING, "not closed by \"", view.data());
+    return 0;
 }
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"'
  */
-string_t parse_string(view_t view, view_t::size_type length) {
-    std::string ret;
-
-    view_t sub(view.data() + 1, length - 2);
-    for (view_t::size_type i = 0; i < sub.size(); i++) {
-        if (sub[i] == '\\') {
-            i++;
+text_t parse_string(view_t view, view_t::size_type length) {
+    parse_status_t status;
+    text_t ret = parse_string(view, length, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
 
-            if (sub[i] == 'n') {
-                ret.push_back('\n');
-            } else if (sub[i] == 'r') {
-                ret.push_back('\r');
-            } else if (sub[i] == 't') {
-                ret.push_back('\t');
-            } else if (sub[i] == 'b') {
-                ret.push_back('\b');
-            } else if (sub[i] == 'f') {
-                ret.push_back('\f');
-            } else if (sub[i] == '\\') {
-                ret.push_back('\\');
-            } else if (sub[i] == '"') {
-                ret.push_back('"');
-            } else if (sub[i] == 'u') {
-                ret += parse_unicode_escape(sub.substr(i + 1), 4);
-                i += 4;
-            } else if (sub[i] == 'U') {
-                ret += parse_unicode_escape(sub.substr(i + 1), 8);
-                i += 8;
-            }
-        } else {
-            ret.push_back(sub[i]);
-        }
-    }
+/*
+ * @pre `view` must start with '"'
+ */
+text_t parse_string(view_t view, view_t::size_type length, parse_status_t& status) {
+    text_t ret;
+    unescape(view_t(view.data() + 1, length - 2), ret, status);
     return ret;
 }
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ */
+void append_unescaped(view_t sub, std::string& out) {
+    parse_status_t status;
+    append_unescaped(sub, out, status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ */
+void append_unescaped(view_t sub, std::string& out, parse_status_t& status) {
+    unescape(sub, out, status);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the escape sequences of a basic or multi-line basic string, without unescaping.
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ * @throw parse_error: if an escape sequence is ill-formed.
+ */
+void validate_escapes(view_t sub) {
+    parse_status_t status;
+    validate_escapes(sub, status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the escape sequences of a basic or multi-line basic string, without unescaping.
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ */
+void validate_escapes(view_t sub, parse_status_t& status) {
+    discard_t discard;
+    unescape(sub, discard, status);
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @pre `view` must start with A-Za-z0-9_-
  */
 view_t::size_type get_bare_length(view_t view) {
-    view_t::size_type pos = view.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-", 1);
-    return (pos != view_t::npos) ? pos : view.size();
+    // compare by ranges, which is much cheaper than searching the character in the set of 64.
+    auto is_bare = [](char c) {
+        return ((c >= 'A') && (c <= 'Z')) || ((c >= 'a') && (c <= 'z')) || ((c >= '0') && (c <= '9')) ||
+               (c == '_') || (c == '-');
+    };
+    view_t::size_type pos = 1;
+    while ((pos < view.size()) && is_bare(view[pos])) {
+        ++pos;
+    }
+    return std::min(pos, view.size());
 }
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with A-Za-z0-9_-
  */
-string_t parse_bare_value(view_t view, view_t::size_type length) {
+text_t parse_bare_value(view_t view, view_t::size_type length) {
     return {view.data(), length};
 }
 /////////////////////////////////////////////////////////////////////////////
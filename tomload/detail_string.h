@@ -3,6 +3,8 @@
 
 /*
  * @file tomload/detail_string.h
+ * @details each function which may fail has two overloads: the one with parse_status_t records
+ *          the error in it, and the other throws parse_error.
  * @note target version of C++ is C++14. 
  */
 
@@ -33,60 +35,84 @@ namespace tomload {
  * @throw parse_error: when detect invalid unicode escape or surrogate pair in 2 bytes.
  */
 std::string utf8_encode(uint32_t codepoint);
+std::string utf8_encode(uint32_t codepoint, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with "'''"
  */
 view_t::size_type get_multi_literal_string_length(view_t view);
+view_t::size_type get_multi_literal_string_length(view_t view, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with "'''"
  */
-string_t parse_multi_literal_string(view_t& view, view_t::size_type length);
+text_t parse_multi_literal_string(view_t& view, view_t::size_type length);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with "'"
  */
 view_t::size_type get_literal_string_length(view_t view);
+view_t::size_type get_literal_string_length(view_t view, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with "'"
  */
-string_t parse_literal_string(view_t& view, view_t::size_type length);
+text_t parse_literal_string(view_t& view, view_t::size_type length);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must starts with 4 or 8 digits hex
  */
 std::string parse_unicode_escape(const view_t& view, int size);
+std::string parse_unicode_escape(const view_t& view, int size, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"""'
  */
 view_t::size_type get_multi_string_length(view_t view);
+view_t::size_type get_multi_string_length(view_t view, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"""'
  */
-string_t parse_multi_string(view_t view, view_t::size_type length);
+text_t parse_multi_string(view_t view, view_t::size_type length);
+text_t parse_multi_string(view_t view, view_t::size_type length, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"'
  */
 view_t::size_type get_string_length(view_t view);
+view_t::size_type get_string_length(view_t view, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
  * @pre `view` must start with '"'
  */
-string_t parse_string(view_t view, view_t::size_type length);
+text_t parse_string(view_t view, view_t::size_type length);
+text_t parse_string(view_t view, view_t::size_type length, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ */
+void append_unescaped(view_t sub, std::string& out);
+void append_unescaped(view_t sub, std::string& out, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the escape sequences of a basic or multi-line basic string, without unescaping.
+ * @pre `sub` is the content of a basic or multi-line basic string, whose length is already checked.
+ * @throw parse_error: if an escape sequence is ill-formed.
+ */
+void validate_escapes(view_t sub);
+void validate_escapes(view_t sub, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -98,7 +124,7 @@ view_t::size_type get_bare_length(view_t view);
 /*
  * @pre `view` must start with A-Za-z0-9_-
  */
-string_t parse_bare_value(view_t view, view_t::size_type length);
+text_t parse_bare_value(view_t view, view_t::size_type length);
 /////////////////////////////////////////////////////////////////////////////
 
 }  // namespace tomload
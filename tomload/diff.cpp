@@ -0,0 +1,242 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/diff.cpp
+ * @brief implement diff of two documents.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/diff.h"
+#include <cmath>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @brief Append the changes from `lhs` to `rhs` at `path`.
+ * @param path[in,out]: path of `lhs` and `rhs`. it is restored before returning.
+ */
+void diff_item(const item_t& lhs, const item_t& rhs, path_t& path, std::vector<change_t>& changes) {
+    if (lhs == rhs) {
+        return;
+    }
+
+    if (lhs.is_table() && rhs.is_table()) {
+        table_range_t l = lhs.table_range();
+        table_range_t r = rhs.table_range();
+        table_iterator li = l.begin();
+        table_iterator ri = r.begin();
+        while ((li != l.end()) || (ri != r.end())) {
+            int cmp = (li == l.end()) ? 1 :
+                      (ri == r.end()) ? -1 : compare_key(to_view(li->first), to_view(ri->first));
+            path.push_back((cmp <= 0) ? li->first : ri->first);
+            if (cmp < 0) {
+                changes.push_back(change_t{CHANGE_REMOVE, path, &li->second, nullptr});
+                ++li;
+            } else if (cmp > 0) {
+                changes.push_back(change_t{CHANGE_ADD, path, nullptr, &ri->second});
+                ++ri;
+            } else {
+                diff_item(li->second, ri->second, path, changes);
+                ++li;
+                ++ri;
+            }
+            path.pop_back();
+        }
+    } else if (lhs.is_array() && rhs.is_array()) {
+        size_t l = lhs.size();
+        size_t r = rhs.size();
+        for (size_t i = 0; i < std::min(l, r); ++i) {
+            path.emplace_back(i);
+            diff_item(lhs[i], rhs[i], path, changes);
+            path.pop_back();
+        }
+        for (size_t i = l; i < r; ++i) {
+            path.emplace_back(i);
+            changes.push_back(change_t{CHANGE_ADD, path, nullptr, &rhs[i]});
+            path.pop_back();
+        }
+        for (size_t i = l; i > r; --i) {  // from the last, so that the indices stay valid
+            path.emplace_back(i - 1);
+            changes.push_back(change_t{CHANGE_REMOVE, path, &lhs[i - 1], nullptr});
+            path.pop_back();
+        }
+    } else {
+        changes.push_back(change_t{CHANGE_REPLACE, path, &lhs, &rhs});
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Write `str` as a JSON string, escaping '"', '\\' and the control characters.
+ */
+void write_json_string(std::ostream& os, view_t str) {
+    static const char hex[] = "0123456789abcdef";
+
+    os << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"':  os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\b': os << "\\b"; break;
+        case '\f': os << "\\f"; break;
+        case '\n': os << "\\n"; break;
+        case '\r': os << "\\r"; break;
+        case '\t': os << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u00" << hex[(c >> 4) & 0x0f] << hex[c & 0x0f];
+            } else {
+                os << c;
+            }
+            break;
+        }
+    }
+    os << '"';
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Write `d` as the shortest JSON number which reads back to `d`, keeping it a float.
+ *        nan and inf, which JSON does not have, are written as the strings "nan", "inf" and "-inf".
+ */
+void write_json_float(std::ostream& os, float_t d) {
+    if (std::isnan(d)) {
+        os << "\"nan\"";
+        return;
+    } else if (std::isinf(d)) {
+        os << ((d < 0.0) ? "\"-inf\"" : "\"inf\"");
+        return;
+    }
+
+    std::string str;
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::ostringstream ss;
+        ss.imbue(std::locale::classic());
+        ss << std::setprecision(precision) << d;
+        str = ss.str();
+
+        std::istringstream is(str);
+        is.imbue(std::locale::classic());
+        float_t back = 0.0;
+        if ((is >> back) && (back == d)) {
+            break;
+        }
+    }
+    if (str.find_first_of(".e") == std::string::npos) {
+        str += ".0";  // 1.0 is not written as integer 1
+    }
+    os << str;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Write `item` as JSON.
+ */
+void write_json(std::ostream& os, const item_t& item) {
+    if (item.is_boolean()) {
+        os << (item.get_boolean() ? "true" : "false");
+    } else if (item.is_integer()) {
+        os << item.get_integer();
+    } else if (item.is_float()) {
+        write_json_float(os, item.get_float());
+    } else if (item.is_string()) {
+        write_json_string(os, item.get_string());
+    } else if (item.is_array()) {
+        const char* sep = "";
+        os << '[';
+        for (const item_t& i : item.array_range()) {
+            os << sep;
+            write_json(os, i);
+            sep = ", ";
+        }
+        os << ']';
+    } else {
+        const char* sep = "";
+        os << '{';
+        for (const auto& i : item.table_range()) {
+            os << sep;
+            write_json_string(os, i.first);
+            os << ": ";
+            write_json(os, i.second);
+            sep = ", ";
+        }
+        os << '}';
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @brief List the changes from `lhs` to `rhs`.
+ * @param lhs[in]: old document.
+ * @param rhs[in]: new document.
+ * @return changes in the order of paths, except that the array elements removed are listed from the last,
+ *         so that applying the changes in order as JSON Patch turns `lhs` into `rhs`.
+ */
+std::vector<change_t> diff(const item_t& lhs, const item_t& rhs) {
+    std::vector<change_t> ret;
+    path_t path;
+    diff_item(lhs, rhs, path, ret);
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert a path to JSON Pointer (RFC 6901), e.g. {"a", 0, "b/c"} to "/a/0/b~1c".
+ */
+std::string to_json_pointer(const path_t& path) {
+    std::string ret;
+    for (const path_element_t& element : path) {
+        ret += '/';
+        if (element.is_index()) {
+            ret += std::to_string(element.index());
+            continue;
+        }
+        for (char c : element.key()) {
+            if (c == '~') {
+                ret += "~0";
+            } else if (c == '/') {
+                ret += "~1";
+            } else {
+                ret += c;
+            }
+        }
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert changes to JSON Patch (RFC 6902) records.
+ * @return array of records in JSON. see diff.h for the mapping of the values.
+ */
+std::string to_json_patch(const std::vector<change_t>& changes) {
+    static const char* const ops[] = {"add", "remove", "replace"};
+
+    std::ostringstream os;
+    os.imbue(std::locale::classic());
+    const char* sep = "";
+    os << '[';
+    for (const change_t& c : changes) {
+        os << sep << "{\"op\": \"" << ops[c.kind] << "\", \"path\": ";
+        write_json_string(os, to_json_pointer(c.path));
+        if (c.new_value != nullptr) {
+            os << ", \"value\": ";
+            write_json(os, *c.new_value);
+        }
+        os << '}';
+        sep = ", ";
+    }
+    os << ']';
+    return os.str();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
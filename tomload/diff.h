@@ -0,0 +1,85 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/diff.h
+ * @brief Header file for diff of two documents.
+ * @details diff() compares two item_t trees and lists the paths added, removed or replaced:
+ *            - identical subtrees are skipped by shared identity or by cached hashes,
+ *              see item_t::operator==(),
+ *            - tables are walked in their sorted key order, so each pair of tables is merged in linear time,
+ *            - arrays are compared element by element, and the extra elements are added or removed at the tail,
+ *            - a change of type, e.g. integer to float or array to table, is one replacement.
+ *          the changes refer to the values in the compared trees, so the trees must outlive the changes.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::item_t before("[server]\nport = 80\n");
+ *      tomload::item_t after("[server]\nport = 8080\nhost = \"a\"\n");
+ *      for (const tomload::change_t& c : tomload::diff(before, after)) {
+ *          std::cout << tomload::to_json_pointer(c.path);  // => "/server/host", "/server/port"
+ *      }
+ *      std::cout << tomload::to_json_patch(tomload::diff(before, after));
+ *      // => [{"op": "add", "path": "/server/host", "value": "a"}, {"op": "replace", "path": "/server/port", "value": 8080}]
+ */
+
+#ifndef TOMLOAD_DIFF_H_
+#define TOMLOAD_DIFF_H_
+
+#include <string>
+#include <vector>
+#include "tomload/tomload.h"
+
+namespace tomload {
+
+/*
+ * @enum change_kind_t
+ * @brief Kind of a change, which is named after the operation of JSON Patch.
+ */
+enum change_kind_t {
+    CHANGE_ADD,      // the path exists only in the new document.
+    CHANGE_REMOVE,   // the path exists only in the old document.
+    CHANGE_REPLACE,  // the value or the type of the path is changed.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct change_t
+ * @brief One change between two documents.
+ */
+struct change_t {
+    change_kind_t kind;
+    path_t path;                // empty path means the root.
+    const item_t* old_value;    // nullptr for CHANGE_ADD.
+    const item_t* new_value;    // nullptr for CHANGE_REMOVE.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief List the changes from `lhs` to `rhs`.
+ * @param lhs[in]: old document.
+ * @param rhs[in]: new document.
+ * @return changes in the order of paths, except that the array elements removed are listed from the last,
+ *         so that applying the changes in order as JSON Patch turns `lhs` into `rhs`.
+ */
+std::vector<change_t> diff(const item_t& lhs, const item_t& rhs);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert a path to JSON Pointer (RFC 6901), e.g. {"a", 0, "b/c"} to "/a/0/b~1c".
+ */
+std::string to_json_pointer(const path_t& path);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert changes to JSON Patch (RFC 6902) records.
+ * @return array of records in JSON. the values are mapped as follows:
+ *           - boolean, integer, string, array and table are JSON true/false, number, string, array and object,
+ *           - float is a JSON number which always has '.' or an exponent, e.g. 1.0 not 1,
+ *           - nan, inf and -inf, which JSON does not have, are the strings "nan", "inf" and "-inf".
+ */
+std::string to_json_patch(const std::vector<change_t>& changes);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_DIFF_H_
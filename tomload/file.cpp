@@ -0,0 +1,151 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/file.cpp
+ * @brief implement loading TOML files.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/file.h"
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TOMLOAD_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace tomload {
+
+#if defined(TOMLOAD_HAS_MMAP)
+
+namespace {
+
+/*
+ * @brief Close the file descriptor at the end of the scope.
+ */
+struct fd_closer_t {
+    int fd;
+    ~fd_closer_t(void) { ::close(fd); }
+};
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+/*
+ * @param path[in]: path of the file.
+ * @throw std::system_error: if the file cannot be opened or read.
+ */
+mapped_file_t::mapped_file_t(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("cannot open " + path);
+    }
+    fd_closer_t closer{fd};
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        throw_errno("cannot stat " + path);
+    }
+    if (S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        size_t size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            ::madvise(p, size, MADV_WILLNEED);
+            data_ = static_cast<const char*>(p);
+            size_ = size;
+            mapped_ = true;
+            return;
+        }
+        buffer_.reserve(size);
+    }
+
+    // not mappable: read by pread(), or by read() if the file is not seekable.
+    char chunk[65536];
+    bool seekable = true;
+    for (;;) {
+        ssize_t n = seekable ? ::pread(fd, chunk, sizeof(chunk), static_cast<off_t>(buffer_.size())) :
+                               ::read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer_.append(chunk, static_cast<size_t>(n));
+        } else if (n == 0) {
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (seekable && (errno == ESPIPE)) {
+            seekable = false;
+        } else {
+            throw_errno("cannot read " + path);
+        }
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+mapped_file_t::~mapped_file_t(void) {
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+#else  // TOMLOAD_HAS_MMAP
+
+/*
+ * @param path[in]: path of the file.
+ * @throw std::system_error: if the file cannot be opened or read.
+ */
+mapped_file_t::mapped_file_t(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "cannot open " + path);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        throw std::system_error(std::make_error_code(std::errc::io_error), "cannot read " + path);
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+mapped_file_t::~mapped_file_t(void) = default;
+/////////////////////////////////////////////////////////////////////////////
+
+#endif  // TOMLOAD_HAS_MMAP
+
+document_t::document_t(item_t root, std::shared_ptr<const mapped_file_t> file) :
+    file_(std::move(file)),
+    root_(std::move(root)) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Load a TOML file.
+ * @param path[in]: path of the file.
+ * @param options[in]: options of parsing.
+ * @throw std::system_error: if the file cannot be opened or read.
+ * @throw parse_error: if the file is ill-formed.
+ */
+document_t load_file(const std::string& path, const parse_options_t& options) {
+    std::shared_ptr<const mapped_file_t> file = std::make_shared<const mapped_file_t>(path);
+    item_t root(file->view(), options);
+    // lazy numbers refer to the source until they are converted.
+    return document_t(std::move(root), options.lazy_numbers ? std::move(file) : nullptr);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/file.h
+ * @brief Header file for loading TOML files.
+ * @details load_file() parses a file without copying it into a buffer first:
+ *            - a regular file is mapped read-only, and the kernel is advised that it is read
+ *              sequentially and soon (MADV_SEQUENTIAL and MADV_WILLNEED),
+ *            - a file which cannot be mapped, e.g. a pipe or an empty file, is read by pread(),
+ *              or read() if it is not seekable,
+ *            - the mapping is kept by document_t only when the document refers to it, that is
+ *              `parse_options_t::lazy_numbers`. otherwise it is unmapped just after parsing.
+ *              in that mode, items copied out of the document must not outlive it, see document_t::root().
+ *          on a platform without mmap(), the file is read with std::ifstream.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::document_t doc = tomload::load_file("config.toml");
+ *      int64_t port = doc.root()["server"]["port"].get_integer();
+ */
+
+#ifndef TOMLOAD_FILE_H_
+#define TOMLOAD_FILE_H_
+
+#include <memory>
+#include <string>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @class mapped_file_t
+ * @brief Read-only contents of a file, mapped or read into a buffer.
+ */
+class mapped_file_t {
+ public:
+    /*
+     * @param path[in]: path of the file.
+     * @throw std::system_error: if the file cannot be opened or read.
+     */
+    explicit mapped_file_t(const std::string& path);
+    /////////////////////////////////////////////////////////////////////////////
+
+    ~mapped_file_t(void);
+    mapped_file_t(const mapped_file_t&) = delete;
+    mapped_file_t& operator=(const mapped_file_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Contents of the file.
+     */
+    view_t view(void) const noexcept { return view_t(data_, size_); }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check the file is mapped, not read into a buffer.
+     */
+    bool is_mapped(void) const noexcept { return mapped_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    const char* data_ = "";
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string buffer_;  // contents read when the file is not mapped
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class document_t
+ * @brief Document loaded from a file, with the file contents if the document refers to them.
+ */
+class document_t {
+ public:
+    document_t(item_t root, std::shared_ptr<const mapped_file_t> file);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief The top-level table.
+     * @note with `parse_options_t::lazy_numbers`, a number not read yet refers to the file contents
+     *       kept by this document, and a copy of it or of a table or array containing it refers
+     *       to them as well. such a copy must not outlive the document.
+     */
+    const item_t& root(void) const noexcept { return root_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Contents of the file kept for the document, or nullptr if the document does not refer to them.
+     */
+    const std::shared_ptr<const mapped_file_t>& file(void) const noexcept { return file_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    std::shared_ptr<const mapped_file_t> file_;  // declared first, so it outlives `root_`
+    item_t root_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Load a TOML file.
+ * @param path[in]: path of the file.
+ * @param options[in]: options of parsing.
+ * @throw std::system_error: if the file cannot be opened or read.
+ * @throw parse_error: if the file is ill-formed.
+ * @note with `parse_options_t::lazy_numbers`, items copied from the document must not outlive it.
+ */
+document_t load_file(const std::string& path, const parse_options_t& options = parse_options_t{});
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_FILE_H_
@@ -0,0 +1,400 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/frozen.cpp
+ * @brief implement tomload::frozen_t and tomload::freeze().
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/frozen.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace tomload {
+
+namespace {
+
+const uint32_t frozen_magic = 0x4c4d4f54;  // "TOML" in little endian
+
+struct frozen_header_t {
+    uint32_t magic;
+    uint32_t node_count;
+    uint64_t strings_offset;  // offset of the string table from the top of the block.
+};
+
+static_assert(std::is_trivially_copyable<frozen_node_t>::value, "frozen_node_t must be trivially copyable");
+static_assert(sizeof(frozen_header_t) % alignof(frozen_node_t) == 0, "nodes must be aligned");
+
+const frozen_header_t& header(const char* block) noexcept {
+    return *reinterpret_cast<const frozen_header_t*>(block);
+}
+
+const frozen_node_t* nodes(const char* block) noexcept {
+    return reinterpret_cast<const frozen_node_t*>(block + sizeof(frozen_header_t));
+}
+
+const char* strings(const char* block) noexcept {
+    return block + header(block).strings_offset;
+}
+
+/*
+ * @brief Check that every offset in the block stays inside the block.
+ * @param block[in]: top of the block, whose header is already checked.
+ * @param size[in]: size of the block in bytes.
+ * @return true if every node refers to known type, nodes and strings in the block.
+ * @note children must be placed after their parent, so that the nodes never make a cycle.
+ */
+bool is_consistent(const char* block, size_t size) noexcept {
+    const frozen_header_t& h = header(block);
+    const uint64_t strings_size = size - h.strings_offset;
+    const frozen_node_t* all = nodes(block);
+    for (uint32_t index = 0; index < h.node_count; ++index) {
+        const frozen_node_t& node = all[index];
+        if ((node.type > frozen_node_t::TYPE_TABLE) ||
+            (static_cast<uint64_t>(node.key_offset) + node.key_size > strings_size)) {
+            return false;
+        }
+        if (node.type == frozen_node_t::TYPE_STRING) {
+            if ((node.value.offset > strings_size) || (node.size > strings_size - node.value.offset)) {
+                return false;
+            }
+        } else if ((node.type == frozen_node_t::TYPE_ARRAY) || (node.type == frozen_node_t::TYPE_TABLE)) {
+            if ((node.value.offset > h.node_count) || (node.size > h.node_count - node.value.offset) ||
+                ((node.size != 0) && (node.value.offset <= index))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * @brief Builder of the nodes and the string table.
+ */
+class freezer_t {
+ public:
+    /*
+     * @brief Set type and value of scalar, and type of array or table.
+     */
+    void fill(uint32_t index, const item_t& item) {
+        frozen_node_t& node = nodes[index];
+        if (item.is_boolean()) {
+            node.type = frozen_node_t::TYPE_BOOLEAN;
+            node.value.b = item.get_boolean();
+        } else if (item.is_integer()) {
+            node.type = frozen_node_t::TYPE_INTEGER;
+            node.value.i = item.get_integer();
+        } else if (item.is_float()) {
+            node.type = frozen_node_t::TYPE_FLOAT;
+            node.value.d = item.get_float();
+        } else if (item.is_string()) {
+            string_t str = item.get_string();
+            node.type = frozen_node_t::TYPE_STRING;
+            node.size = checked_size(str.size());
+            node.value.offset = push_string(str);
+        } else if (item.is_array()) {
+            node.type = frozen_node_t::TYPE_ARRAY;
+        } else {
+            node.type = frozen_node_t::TYPE_TABLE;
+        }
+    }
+
+    /*
+     * @brief Lay out the children of `item` contiguously, then their descendants depth-first.
+     */
+    void layout(uint32_t index, const item_t& item) {
+        if (item.is_array()) {
+            uint32_t first = allocate(index, item.size());
+            uint32_t i = first;
+            for (const item_t& child : item.array_range()) {
+                fill(i++, child);
+            }
+            i = first;
+            for (const item_t& child : item.array_range()) {
+                layout(i++, child);
+            }
+        } else if (item.is_table()) {
+            uint32_t first = allocate(index, item.size());
+            uint32_t i = first;
+            for (const auto& child : item.table_range()) {
+                nodes[i].key_size = checked_size(child.first.size());
+                nodes[i].key_offset = checked_size(push_string(to_view(child.first)));
+                fill(i++, child.second);
+            }
+            i = first;
+            for (const auto& child : item.table_range()) {
+                layout(i++, child.second);
+            }
+        }
+    }
+
+    std::vector<frozen_node_t> nodes;
+    std::string strings;
+
+ private:
+    uint32_t allocate(uint32_t index, size_t count) {
+        uint32_t first = checked_size(nodes.size());
+        nodes.resize(checked_size(nodes.size() + count), frozen_node_t{});
+        nodes[index].size = static_cast<uint32_t>(count);
+        nodes[index].value.offset = first;
+        return first;
+    }
+
+    uint64_t push_string(view_t str) {
+        uint64_t offset = strings.size();
+        strings.append(str.data(), str.size());
+        return offset;
+    }
+
+    static uint32_t checked_size(size_t size) {
+        if (size > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("too large to freeze");
+        }
+        return static_cast<uint32_t>(size);
+    }
+};
+
+}  // namespace
+
+frozen_item_t::frozen_item_t(const char* block, uint32_t index) noexcept :
+    block_(block),
+    index_(index) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_boolean(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_BOOLEAN;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_integer(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_INTEGER;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_float(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_FLOAT;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_string(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_STRING;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_array(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_ARRAY;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::is_table(void) const noexcept {
+    return node().type == frozen_node_t::TYPE_TABLE;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+boolean_t frozen_item_t::get_boolean(void) const {
+    if (not is_boolean()) {
+        throw type_error("type mismatch");
+    }
+    return node().value.b;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+integer_t frozen_item_t::get_integer(void) const {
+    if (not is_integer()) {
+        throw type_error("type mismatch");
+    }
+    return node().value.i;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+float_t frozen_item_t::get_float(void) const {
+    if (not is_float()) {
+        throw type_error("type mismatch");
+    }
+    return node().value.d;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+view_t frozen_item_t::get_string(void) const {
+    if (not is_string()) {
+        throw type_error("type mismatch");
+    }
+    return view_t(strings(block_) + node().value.offset, node().size);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief get key of this item in the parent table. empty if the parent is not a table.
+ */
+view_t frozen_item_t::key(void) const noexcept {
+    return view_t(strings(block_) + node().key_offset, node().key_size);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief get size of array or table.
+ * @throw type_error: if the type is neither array nor table.
+ */
+size_t frozen_item_t::size(void) const {
+    if (is_array() || is_table()) {
+        return node().size;
+    } else {
+        throw type_error("neither array nor table");
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool frozen_item_t::empty(void) const {
+    return size() == 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief operator[] of array.
+ * @throw type_error: if the type is not array.
+ * @throw std::out_of_range: if `index` is out of range of array.
+ */
+frozen_item_t frozen_item_t::operator[](size_t index) const {
+    if (not is_array()) {
+        throw type_error("not array");
+    }
+    if (index >= node().size) {
+        throw std::out_of_range("index is out of range");
+    }
+    return frozen_item_t(block_, static_cast<uint32_t>(node().value.offset + index));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief operator[] of table. the key is searched by binary search.
+ * @throw type_error: if the type is not table.
+ * @throw std::out_of_range: if `key` is not found in the table.
+ */
+frozen_item_t frozen_item_t::operator[](view_t key) const {
+    uint32_t index = find(key);
+    if (index == std::numeric_limits<uint32_t>::max()) {
+        throw std::out_of_range("key is not found");
+    }
+    return frozen_item_t(block_, index);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check if the table contains the specified key.
+ * @throw type_error: if the type is not table.
+ */
+bool frozen_item_t::contains(view_t key) const {
+    return find(key) != std::numeric_limits<uint32_t>::max();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get a range of the elements of array or table. use key() to get keys of table.
+ * @throw type_error: if the type is neither array nor table.
+ */
+frozen_range_t frozen_item_t::children(void) const {
+    uint32_t first = static_cast<uint32_t>(node().value.offset);
+    uint32_t count = static_cast<uint32_t>(size());
+    return frozen_range_t(frozen_iterator(block_, first), frozen_iterator(block_, first + count));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+const frozen_node_t& frozen_item_t::node(void) const noexcept {
+    return nodes(block_)[index_];
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @return index of the child which has `key`, or max of uint32_t when not found.
+ * @throw type_error: if the type is not table.
+ */
+uint32_t frozen_item_t::find(view_t key) const {
+    if (not is_table()) {
+        throw type_error("not table");
+    }
+
+    // children of table are sorted by key, because they are copied from std::map in order.
+    const frozen_node_t* all = nodes(block_);
+    const char* str = strings(block_);
+    uint32_t low = static_cast<uint32_t>(node().value.offset);
+    uint32_t high = low + node().size;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int comp = compare_key(view_t(str + all[mid].key_offset, all[mid].key_size), key);
+        if (comp == 0) {
+            return mid;
+        } else if (comp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return std::numeric_limits<uint32_t>::max();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Restore frozen_t from the bytes gotten by data() and size().
+ * @throw std::invalid_argument: if the bytes are not a frozen block, or any offset in it is out of the block.
+ */
+frozen_t::frozen_t(const char* data, size_t size) :
+    block_((size + sizeof(uint64_t) - 1) / sizeof(uint64_t)) {
+    if (size < sizeof(frozen_header_t)) {
+        throw std::invalid_argument("not frozen block");
+    }
+    std::memcpy(block_.data(), data, size);
+
+    const frozen_header_t& h = header(this->data());
+    if ((h.magic != frozen_magic) ||
+        (h.node_count == 0) ||
+        (sizeof(frozen_header_t) + h.node_count * sizeof(frozen_node_t) > h.strings_offset) ||
+        (h.strings_offset > size) ||
+        not is_consistent(this->data(), size)) {
+        throw std::invalid_argument("not frozen block");
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the root item.
+ */
+frozen_item_t frozen_t::root(void) const noexcept {
+    return frozen_item_t(data(), 0);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Relocate `item` into one contiguous frozen block.
+ * @param item[in]: source item. usually the root of a parsed document.
+ * @return frozen copy of `item`.
+ * @throw std::length_error: if the keys and strings exceed 4 GiB, or there are too many nodes.
+ */
+frozen_t freeze(const item_t& item) {
+    freezer_t freezer;
+    freezer.nodes.push_back(frozen_node_t{});
+    freezer.fill(0, item);
+    freezer.layout(0, item);
+
+    frozen_header_t h{};
+    h.magic = frozen_magic;
+    h.node_count = static_cast<uint32_t>(freezer.nodes.size());
+    h.strings_offset = sizeof(frozen_header_t) + freezer.nodes.size() * sizeof(frozen_node_t);
+
+    size_t size = h.strings_offset + freezer.strings.size();
+    frozen_t ret;
+    ret.block_.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+
+    char* p = reinterpret_cast<char*>(ret.block_.data());
+    std::memcpy(p, &h, sizeof(h));
+    std::memcpy(p + sizeof(h), freezer.nodes.data(), freezer.nodes.size() * sizeof(frozen_node_t));
+    std::memcpy(p + h.strings_offset, freezer.strings.data(), freezer.strings.size());
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,224 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/frozen.h
+ * @brief Header file for frozen_t class.
+ * @details frozen_t is a read-only copy of item_t, relocated into one contiguous block.
+ *          the block consists of a header, the nodes and a string table:
+ *            - nodes are laid out in depth-first order, and the children of each array or
+ *              table are adjacent to each other, so that descending lookups touch few cache lines,
+ *            - nodes refer to each other and to the string table by offsets, not pointers,
+ *            - all keys and string values are stored in the string table.
+ *          Therefore the block is trivially copyable; it can be copied by memcpy, written to a
+ *          file or shared memory, and restored by frozen_t(const char*, size_t).
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::frozen_t frozen = tomload::freeze(tomload::item_t("[a]\nb = [1, 2]\n"));
+ *      for (auto i : frozen.root()["a"]["b"].children()) {
+ *          std::cout << i.get_integer();  // => 1, 2
+ *      }
+ */
+
+#ifndef TOMLOAD_FROZEN_H_
+#define TOMLOAD_FROZEN_H_
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @struct frozen_node_t
+ * @brief One node in the frozen block. This is an implementation detail of frozen_t.
+ */
+struct frozen_node_t {
+    enum type_t : uint8_t {
+        TYPE_BOOLEAN = 0,
+        TYPE_INTEGER,
+        TYPE_FLOAT,
+        TYPE_STRING,
+        TYPE_ARRAY,
+        TYPE_TABLE,
+    };
+
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t size;        // number of children, or length of string.
+    uint32_t key_offset;  // key in the string table, when the parent is table.
+    uint32_t key_size;
+    union {
+        boolean_t b;
+        integer_t i;
+        float_t d;
+        uint64_t offset;  // string: offset in the string table. array, table: index of the first child.
+    } value;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+class frozen_item_t;
+class frozen_iterator;
+using frozen_range_t = range_t<frozen_iterator>;
+
+/*
+ * @class frozen_item_t
+ * @brief Read-only handle of one node in frozen_t. This is cheap to copy.
+ * @details The accessors are the same as item_t's, except strings are returned as view_t
+ *          which refers to the frozen block.
+ *          The handle is valid while the frozen_t which creates it is alive.
+ */
+class frozen_item_t {
+ public:
+    frozen_item_t(const char* block, uint32_t index) noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    bool is_boolean(void) const noexcept;
+    bool is_integer(void) const noexcept;
+    bool is_float(void) const noexcept;
+    bool is_string(void) const noexcept;
+    bool is_array(void) const noexcept;
+    bool is_table(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @throw tomload::type_error: when type is mismatched.
+     */
+    boolean_t get_boolean(void) const;
+    integer_t get_integer(void) const;
+    float_t get_float(void) const;
+    view_t get_string(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief get key of this item in the parent table. empty if the parent is not a table.
+     */
+    view_t key(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief get size of array or table.
+     * @throw type_error: if the type is neither array nor table.
+     */
+    size_t size(void) const;
+    bool empty(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief operator[] of array.
+     * @throw type_error: if the type is not array.
+     * @throw std::out_of_range: if `index` is out of range of array.
+     */
+    frozen_item_t operator[](size_t index) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief operator[] of table. the key is searched by binary search.
+     * @throw type_error: if the type is not table.
+     * @throw std::out_of_range: if `key` is not found in the table.
+     */
+    frozen_item_t operator[](view_t key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check if the table contains the specified key.
+     * @throw type_error: if the type is not table.
+     */
+    bool contains(view_t key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get a range of the elements of array or table. use key() to get keys of table.
+     * @throw type_error: if the type is neither array nor table.
+     */
+    frozen_range_t children(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    const frozen_node_t& node(void) const noexcept;
+    uint32_t find(view_t key) const;
+
+    const char* block_;
+    uint32_t index_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class frozen_iterator
+ * @brief Iterator over the children of frozen_item_t.
+ */
+class frozen_iterator {
+ public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = frozen_item_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = frozen_item_t;
+
+    frozen_iterator(const char* block, uint32_t index) noexcept :
+        block_(block),
+        index_(index) {
+    }
+
+    frozen_item_t operator*(void) const noexcept { return frozen_item_t(block_, index_); }
+    frozen_iterator& operator++(void) noexcept { ++index_; return *this; }
+    frozen_iterator operator++(int) noexcept { frozen_iterator ret = *this; ++index_; return ret; }
+    bool operator==(const frozen_iterator& rhs) const noexcept { return index_ == rhs.index_; }
+    bool operator!=(const frozen_iterator& rhs) const noexcept { return index_ != rhs.index_; }
+
+ private:
+    const char* block_;
+    uint32_t index_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class frozen_t
+ * @brief Owner of the frozen block.
+ */
+class frozen_t {
+ public:
+    /*
+     * @brief Restore frozen_t from the bytes gotten by data() and size().
+     * @throw std::invalid_argument: if the bytes are not a frozen block, or any offset in it is out of the block.
+     * @note every node is checked once here, so that the accessors never read out of the block.
+     *       a block whose table keys are not sorted is accepted, but its keys may not be found.
+     */
+    frozen_t(const char* data, size_t size);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the root item.
+     */
+    frozen_item_t root(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Raw bytes of the frozen block.
+     */
+    const char* data(void) const noexcept { return reinterpret_cast<const char*>(block_.data()); }
+    size_t size(void) const noexcept { return block_.size() * sizeof(uint64_t); }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    friend frozen_t freeze(const item_t& item);
+    frozen_t(void) = default;
+
+    std::vector<uint64_t> block_;  // uint64_t to keep the nodes aligned.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Relocate `item` into one contiguous frozen block.
+ * @param item[in]: source item. usually the root of a parsed document.
+ * @return frozen copy of `item`.
+ * @throw std::length_error: if the keys and strings exceed 4 GiB, or there are too many nodes.
+ */
+frozen_t freeze(const item_t& item);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_FROZEN_H_
@@ -0,0 +1,277 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/lazy_document.cpp
+ * @brief implement tomload::lazy_document_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/lazy_document.h"
+#include <algorithm>
+#include <utility>
+#include "tomload/parser.h"
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @struct statement_t
+ * @brief Statement at the top level found by scan_statements().
+ */
+struct statement_t {
+    text_t key;   // first key
+    size_t pos;   // position of the statement
+    bool header;  // table header or key-value pair
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Find the table headers at the top level and the key-value pairs before the first header,
+ *        without parsing values.
+ * @return first key and position of each statement. a key-value pair whose keys are ill-formed
+ *         is not returned, since its error is reported by parsing.
+ * @throw parse_error: if the keys of a header are ill-formed.
+ */
+std::vector<statement_t> scan_statements(view_t view) {
+    std::vector<statement_t> ret;
+
+    size_t depth = 0;        // nesting of arrays and inline tables
+    bool statement = true;  // at the beginning of a statement
+    bool head = true;       // before the first header
+    size_t pos = 0;
+    while (pos < view.size()) {
+        char c = view[pos];
+        if (statement && (depth == 0)) {
+            if ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')) {
+                ++pos;
+                continue;
+            }
+            statement = false;
+            if (c == '[') {
+                view_t keys = view.substr(pos + 1);
+                if (starts_with(keys, "[")) {
+                    keys.remove_prefix(1);
+                }
+                const char* top = keys.data();  // errors of the keys are located at their top, as item_t
+                parse_status_t status;
+                std::vector<text_t> parsed = parse_keys(keys, status);
+                status.locate(top);
+                status.raise(view.data());
+                ret.push_back(statement_t{std::move(parsed.front()), pos, true});
+                pos = static_cast<size_t>(keys.data() - view.data());
+                head = false;
+                continue;
+            } else if (head && (c != '#')) {
+                view_t keys = view.substr(pos);
+                parse_status_t status;
+                std::vector<text_t> parsed = parse_keys(keys, status);
+                if (not status.failed()) {
+                    ret.push_back(statement_t{std::move(parsed.front()), pos, false});
+                }
+                // the keys are scanned again as the rest of the statement.
+            }
+        }
+
+        if ((c == '"') || (c == '\'')) {
+            pos = skip_string(view, pos);
+        } else if (c == '#') {
+            pos = view.find('\n', pos);
+            pos = (pos != view_t::npos) ? pos : view.size();
+        } else {
+            if ((c == '[') || (c == '{')) {
+                ++depth;
+            } else if (((c == ']') || (c == '}')) && (depth > 0)) {
+                --depth;
+            } else if ((c == '\n') && (depth == 0)) {
+                statement = true;
+            }
+            ++pos;
+        }
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert an offset in `pieces` concatenated to the offset in the document.
+ * @param pieces[in]: parsed pieces, which are subviews of the document.
+ * @param top[in]: top of the document.
+ * @param offset[in]: offset of parse_error, which is measured in the pieces concatenated.
+ * @note an offset at the end of a piece is in that piece, since parse_events() reports an error
+ *       after each piece.
+ */
+size_t to_document_offset(const std::vector<view_t>& pieces, const char* top, size_t offset) {
+    if (offset == view_t::npos) {
+        return offset;
+    }
+    for (view_t piece : pieces) {
+        if (offset <= piece.size()) {
+            return static_cast<size_t>(piece.data() - top) + offset;
+        }
+        offset -= piece.size();
+    }
+    return view_t::npos;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @brief Scan the document and parse the key-value pairs before the first header.
+ * @param view[in]: raw TOML string, which must outlive this object.
+ * @throws parse_error: if the headers or the key-value pairs before the first header are ill-formed.
+ */
+lazy_document_t::lazy_document_t(view_t view) :
+    lazy_document_t(view, parse_options_t{}) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Scan the document and parse the key-value pairs before the first header.
+ * @param view[in]: raw TOML string, which must outlive this object.
+ * @param options[in]: options used for every parsing. `parse_options_t::stats` is ignored.
+ * @throws parse_error: if the headers or the key-value pairs before the first header are ill-formed.
+ */
+lazy_document_t::lazy_document_t(view_t view, const parse_options_t& options) :
+    options_(options),
+    head_(view) {
+    options_.stats = nullptr;
+
+    std::vector<statement_t> statements = scan_statements(view);
+    std::vector<statement_t>::const_iterator first_header =
+        std::find_if(statements.cbegin(), statements.cend(), [](const statement_t& s) { return s.header; });
+    if (first_header != statements.cend()) {
+        head_ = view.substr(0, first_header->pos);
+    }
+    for (std::vector<statement_t>::const_iterator it = first_header; it != statements.cend(); ++it) {
+        if (it->header) {
+            size_t end = view.size();
+            for (std::vector<statement_t>::const_iterator next = it + 1; next != statements.cend(); ++next) {
+                if (next->header) {
+                    end = next->pos;
+                    break;
+                }
+            }
+            groups_[key_t(it->key.data(), it->key.size())].sections.push_back(view.substr(it->pos, end - it->pos));
+        }
+    }
+
+    head_item_.reset(new item_t(std::vector<view_t>{head_}, options_));
+
+    // only the key-value pairs of the same first key before the first header can conflict with a group.
+    for (std::vector<statement_t>::const_iterator it = statements.cbegin(); it != first_header; ++it) {
+        groups_t::iterator group = groups_.find(to_view(it->key));
+        if (group != groups_.end()) {
+            size_t end = (it + 1 != statements.cend()) ? (it + 1)->pos : view.size();
+            group->second.head.push_back(view.substr(it->pos, end - it->pos));
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief operator[] of the top-level table. the group of `key` is parsed if it is not yet.
+ * @param key[in]: appointed key of the top-level table.
+ * @throw parse_error: if the sections of the group are ill-formed.
+ * @throw std::out_of_range: if `key` is not found.
+ * @note thread-safe.
+ */
+const item_t& lazy_document_t::operator[](const key_t& key) const {
+    groups_t::const_iterator it = groups_.find(view_t(key));
+    if (it != groups_.end()) {
+        return materialize(*it);
+    }
+    return (*head_item_)[key];
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check if the top-level table contains the specified key, without parsing.
+ * @param key[in]: The key to check for existence in the table.
+ */
+bool lazy_document_t::contains(const key_t& key) const {
+    return (groups_.find(view_t(key)) != groups_.end()) || head_item_->contains(key);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the group of `key` is already parsed.
+ * @return true if `key` is parsed, or `key` is not a group of headers.
+ */
+bool lazy_document_t::is_materialized(const key_t& key) const {
+    groups_t::const_iterator it = groups_.find(view_t(key));
+    return (it == groups_.end()) || it->second.ready.load(std::memory_order_acquire);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Number of the keys in the top-level table, without parsing.
+ */
+size_t lazy_document_t::size(void) const {
+    size_t ret = head_item_->size();
+    for (const auto& group : groups_) {
+        if (not head_item_->contains(group.first)) {
+            ++ret;
+        }
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the whole document. all groups are parsed if they are not yet.
+ * @throw parse_error: if any section is ill-formed.
+ * @note thread-safe.
+ */
+const item_t& lazy_document_t::root(void) const {
+    std::call_once(root_once_, [this] {
+        resource_scope_t scope(options_.resource);
+        table_t table;
+        for (const auto& i : head_item_->table_range()) {
+            table.emplace(i.first, i.second);
+        }
+        for (const auto& group : groups_) {
+            const item_t& item = materialize(group);
+            table.erase(group.first);  // the group includes the definition before the first header
+            table.emplace(group.first, item);
+        }
+        root_.reset(new item_t(single_construct, std::move(table)));
+    });
+    return *root_;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get a range of the top-level table. all groups are parsed if they are not yet.
+ * @throw parse_error: if any section is ill-formed.
+ */
+const table_range_t lazy_document_t::table_range(void) const {
+    return root().table_range();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse the key-value pairs of the group before the first header and the sections of `group` at once.
+ * @return the item of the group.
+ * @throw parse_error: if the sections are ill-formed. its offset is in the whole document.
+ */
+const item_t& lazy_document_t::materialize(const groups_t::value_type& group) const {
+    std::call_once(group.second.once, [this, &group] {
+        std::vector<view_t> pieces = group.second.head;
+        pieces.insert(pieces.end(), group.second.sections.begin(), group.second.sections.end());
+        std::unique_ptr<item_t> document;
+        try {
+            document.reset(new item_t(pieces, options_));
+        } catch (const parse_error& e) {
+            throw parse_error(e.what(), to_document_offset(pieces, head_.data(), e.offset()));
+        }
+        group.second.item.reset(new item_t((*document)[group.first]));
+        group.second.ready.store(true, std::memory_order_release);
+    });
+    return *group.second.item;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/lazy_document.h
+ * @brief Header file for lazy_document_t class.
+ * @details lazy_document_t parses a TOML document on demand.
+ *          The constructor only scans the document for the table headers at the top level, and
+ *          groups the headers by their first key, so "[service.frontend]" and "[service.backend]"
+ *          both belong to "service". The key-value pairs before the first header are parsed eagerly.
+ *          A group is parsed the first time it is accessed:
+ *            - the key-value pairs before the first header whose first key is the key of the group
+ *              and the sections of the group are parsed together, so the result is the same as
+ *              the eager parsing. the other key-value pairs cannot conflict with the group,
+ *            - std::call_once guards each group, so concurrent readers parse it at most once,
+ *            - errors in a section are reported when its group is accessed, not by the constructor.
+ *          The source string must outlive the lazy_document_t.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::lazy_document_t doc(huge_source);
+ *      const tomload::item_t& frontend = doc["service"]["frontend"];  // only "service" is parsed
+ */
+
+#ifndef TOMLOAD_LAZY_DOCUMENT_H_
+#define TOMLOAD_LAZY_DOCUMENT_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @class lazy_document_t
+ * @brief TOML document whose top-level tables are parsed when they are accessed first.
+ */
+class lazy_document_t {
+ public:
+    /*
+     * @brief Scan the document and parse the key-value pairs before the first header.
+     * @param view[in]: raw TOML string, which must outlive this object.
+     * @throws parse_error: if the headers or the key-value pairs before the first header are ill-formed.
+     */
+    explicit lazy_document_t(view_t view);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Scan the document and parse the key-value pairs before the first header.
+     * @param view[in]: raw TOML string, which must outlive this object.
+     * @param options[in]: options used for every parsing. `parse_options_t::stats` is ignored.
+     * @throws parse_error: if the headers or the key-value pairs before the first header are ill-formed.
+     */
+    lazy_document_t(view_t view, const parse_options_t& options);
+    /////////////////////////////////////////////////////////////////////////////
+
+    lazy_document_t(const lazy_document_t&) = delete;
+    lazy_document_t& operator=(const lazy_document_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief operator[] of the top-level table. the group of `key` is parsed if it is not yet.
+     * @param key[in]: appointed key of the top-level table.
+     * @throw parse_error: if the sections of the group are ill-formed.
+     * @throw std::out_of_range: if `key` is not found.
+     * @note thread-safe.
+     */
+    const item_t& operator[](const key_t& key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check if the top-level table contains the specified key, without parsing.
+     * @param key[in]: The key to check for existence in the table.
+     */
+    bool contains(const key_t& key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check the group of `key` is already parsed.
+     * @return true if `key` is parsed, or `key` is not a group of headers.
+     */
+    bool is_materialized(const key_t& key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of the keys in the top-level table, without parsing.
+     */
+    size_t size(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the whole document. all groups are parsed if they are not yet.
+     * @throw parse_error: if any section is ill-formed.
+     * @note thread-safe.
+     */
+    const item_t& root(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get a range of the top-level table. all groups are parsed if they are not yet.
+     * @throw parse_error: if any section is ill-formed.
+     */
+    const table_range_t table_range(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    struct group_t {
+        std::vector<view_t> head;      // key-value pairs of the same first key before the first header.
+        std::vector<view_t> sections;  // from the header to the next header.
+        mutable std::once_flag once;
+        mutable std::unique_ptr<item_t> item;
+        mutable std::atomic<bool> ready{false};
+    };
+    using groups_t = std::map<key_t, group_t, key_compare_t>;
+    /////////////////////////////////////////////////////////////////////////////
+
+    const item_t& materialize(const groups_t::value_type& group) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    parse_options_t options_;
+    view_t head_;                   // key-value pairs before the first header.
+    std::unique_ptr<item_t> head_item_;
+    groups_t groups_;
+    mutable std::once_flag root_once_;
+    mutable std::unique_ptr<item_t> root_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_LAZY_DOCUMENT_H_
@@ -0,0 +1,145 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/memory_resource.cpp
+ * @brief implement memory resource support.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/memory_resource.h"
+#include <cstdint>
+
+namespace tomload {
+
+namespace {
+
+#if !defined(TOMLOAD_USE_PMR)
+
+/*
+ * @class new_delete_resource_t
+ * @brief memory_resource which uses global operator new and delete.
+ * @note over-aligned allocation is not supported, because aligned new requires C++17.
+ */
+class new_delete_resource_t : public memory_resource {
+ private:
+    void* do_allocate(size_t bytes, size_t) override {
+        return ::operator new(bytes);
+    }
+    void do_deallocate(void* p, size_t, size_t) override {
+        ::operator delete(p);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+#endif
+
+thread_local memory_resource* current_resource = nullptr;
+
+}  // namespace
+
+/*
+ * @brief Get the resource which uses global operator new and delete.
+ */
+memory_resource* new_delete_resource(void) noexcept {
+#if defined(TOMLOAD_USE_PMR)
+    return std::pmr::new_delete_resource();
+#else
+    static new_delete_resource_t resource;
+    return &resource;
+#endif
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the default resource of the current thread, which is used by default-constructed allocator_t.
+ * @return the resource set by the innermost resource_scope_t, or new_delete_resource().
+ */
+memory_resource* get_default_resource(void) noexcept {
+    return (current_resource != nullptr) ? current_resource : new_delete_resource();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @param initial_size[in]: size of the first chunk.
+ * @param upstream[in]: resource which the chunks are allocated from.
+ */
+monotonic_resource_t::monotonic_resource_t(size_t initial_size, memory_resource* upstream) :
+    upstream_(upstream),
+    next_size_((initial_size > sizeof(chunk_t)) ? initial_size : sizeof(chunk_t) * 2) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+monotonic_resource_t::~monotonic_resource_t(void) {
+    release();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Return all chunks to the upstream resource.
+ */
+void monotonic_resource_t::release(void) noexcept {
+    while (chunks_ != nullptr) {
+        chunk_t* next = chunks_->next;
+        upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+        chunks_ = next;
+    }
+    current_ = nullptr;
+    space_ = 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void* monotonic_resource_t::do_allocate(size_t bytes, size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+    if ((current_ == nullptr) || (space_ < padding + bytes)) {
+        // the chunk header keeps max_align_t alignment of the rest.
+        size_t header = (sizeof(chunk_t) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+        size_t size = next_size_;
+        while (size < header + bytes + alignment) {
+            size *= 2;
+        }
+        chunk_t* chunk = static_cast<chunk_t*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        chunk->next = chunks_;
+        chunk->size = size;
+        chunks_ = chunk;
+        current_ = reinterpret_cast<char*>(chunk) + header;
+        space_ = size - header;
+        next_size_ = size * 2;
+        padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+    }
+
+    void* ret = current_ + padding;
+    current_ += padding + bytes;
+    space_ -= padding + bytes;
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void monotonic_resource_t::do_deallocate(void*, size_t, size_t) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool monotonic_resource_t::do_is_equal(const memory_resource& other) const noexcept {
+    return this == &other;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @param resource[in]: new default resource. nullptr keeps the current one.
+ */
+resource_scope_t::resource_scope_t(memory_resource* resource) noexcept :
+    previous_(current_resource) {
+    if (resource != nullptr) {
+        current_resource = resource;
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+resource_scope_t::~resource_scope_t(void) {
+    current_resource = previous_;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,210 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/memory_resource.h
+ * @brief Header file for memory resource support.
+ * @details All containers, strings and nodes in item_t are allocated through allocator_t,
+ *          which forwards to a memory_resource.
+ *            - memory_resource is the same interface as std::pmr::memory_resource.
+ *              When the library is configured with the CMake option TOMLOAD_USE_PMR (C++17 is required),
+ *              it is std::pmr::memory_resource itself, so std::pmr resources can be used directly.
+ *              The option is exported as a public compile definition, so the library and its users
+ *              always agree on the type.
+ *            - allocator_t captures the current default resource of the thread when it is
+ *              default-constructed, and it is propagated on copy, so a tree keeps allocating
+ *              from the resource it was built with.
+ *            - resource_scope_t replaces the default resource of the current thread while it is alive.
+ *              parse_options_t::resource is applied by it while parsing.
+ *            - monotonic_resource_t is an arena, which frees everything at once when it is destroyed.
+ * @note target version of C++ is C++14.
+ */
+
+#ifndef TOMLOAD_MEMORY_RESOURCE_H_
+#define TOMLOAD_MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(TOMLOAD_USE_PMR)
+#include <memory_resource>
+#endif
+
+namespace tomload {
+
+#if defined(TOMLOAD_USE_PMR)
+
+using memory_resource = std::pmr::memory_resource;
+
+#else
+
+/*
+ * @class memory_resource
+ * @brief Same interface as std::pmr::memory_resource in C++17.
+ */
+class memory_resource {
+ public:
+    virtual ~memory_resource(void) = default;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return do_allocate(bytes, alignment);
+    }
+    void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        do_deallocate(p, bytes, alignment);
+    }
+    bool is_equal(const memory_resource& other) const noexcept {
+        return do_is_equal(other);
+    }
+
+ private:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+#endif
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the resource which uses global operator new and delete.
+ */
+memory_resource* new_delete_resource(void) noexcept;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the default resource of the current thread, which is used by default-constructed allocator_t.
+ * @return the resource set by the innermost resource_scope_t, or new_delete_resource().
+ */
+memory_resource* get_default_resource(void) noexcept;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class monotonic_resource_t
+ * @brief Arena resource, like std::pmr::monotonic_buffer_resource.
+ * @details memory is carved from chunks of growing size, and deallocate() does nothing.
+ *          all chunks are returned to the upstream resource by release() or the destructor,
+ *          so every item allocated from it must be destroyed before it.
+ *          it is not thread-safe.
+ */
+class monotonic_resource_t : public memory_resource {
+ public:
+    /*
+     * @param initial_size[in]: size of the first chunk.
+     * @param upstream[in]: resource which the chunks are allocated from.
+     */
+    explicit monotonic_resource_t(size_t initial_size = 4096, memory_resource* upstream = new_delete_resource());
+    ~monotonic_resource_t(void) override;
+
+    monotonic_resource_t(const monotonic_resource_t&) = delete;
+    monotonic_resource_t& operator=(const monotonic_resource_t&) = delete;
+
+    /*
+     * @brief Return all chunks to the upstream resource.
+     */
+    void release(void) noexcept;
+
+ private:
+    struct chunk_t {
+        chunk_t* next;
+        size_t size;  // including this header
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const memory_resource& other) const noexcept override;
+
+    memory_resource* upstream_;
+    size_t next_size_;
+    chunk_t* chunks_ = nullptr;
+    char* current_ = nullptr;
+    size_t space_ = 0;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class resource_scope_t
+ * @brief RAII class to replace the default resource of the current thread.
+ */
+class resource_scope_t {
+ public:
+    /*
+     * @param resource[in]: new default resource. nullptr keeps the current one.
+     */
+    explicit resource_scope_t(memory_resource* resource) noexcept;
+    ~resource_scope_t(void);
+
+    resource_scope_t(const resource_scope_t&) = delete;
+    resource_scope_t& operator=(const resource_scope_t&) = delete;
+
+ private:
+    memory_resource* previous_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class allocator_t
+ * @brief Polymorphic allocator which is propagated to copies of containers.
+ * @tparam T: value type.
+ */
+template <typename T>
+class allocator_t {
+ public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    allocator_t(void) noexcept :
+        resource_(get_default_resource()) {
+    }
+
+    allocator_t(memory_resource* resource) noexcept :  // NOLINT: implicit like std::pmr::polymorphic_allocator
+        resource_(resource) {
+    }
+
+    template <typename U>
+    allocator_t(const allocator_t<U>& other) noexcept :  // NOLINT: implicit to rebind
+        resource_(other.resource()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    allocator_t select_on_container_copy_construction(void) const noexcept {
+        return *this;
+    }
+
+    memory_resource* resource(void) const noexcept {
+        return resource_;
+    }
+
+ private:
+    memory_resource* resource_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename U>
+bool operator==(const allocator_t<T>& lhs, const allocator_t<U>& rhs) noexcept {
+    return (lhs.resource() == rhs.resource()) || lhs.resource()->is_equal(*rhs.resource());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename U>
+bool operator!=(const allocator_t<T>& lhs, const allocator_t<U>& rhs) noexcept {
+    return not (lhs == rhs);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_MEMORY_RESOURCE_H_
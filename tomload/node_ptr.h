@@ -0,0 +1,189 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/node_ptr.h
+ * @brief Header file for node_ptr class.
+ * @details This file defines node_ptr, the owning pointer used for the containers in item_t.
+ *          node_ptr is an intrusive reference counted pointer with copy-on-write semantics:
+ *            - moving a node_ptr never touches the counter,
+ *            - copying a node_ptr is the explicit way to share a node (one increment),
+ *            - releasing a uniquely owned node does not need an atomic read-modify-write,
+ *            - mutate() clones the node first when it is shared, so copies never alias
+ *              mutable subtrees,
+ *            - a node is allocated from the default memory resource of the thread, and the
+ *              clone made by mutate() is allocated from the same resource as the original,
+ *            - a node has a slot to cache the hash of the pointee, which mutate() clears.
+ *          While parsing, every node is uniquely owned, so no atomic operation is executed.
+ * @note target version of C++ is C++14.
+ */
+
+#ifndef TOMLOAD_NODE_PTR_H_
+#define TOMLOAD_NODE_PTR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "tomload/memory_resource.h"
+
+namespace tomload {
+
+/*
+ * @class node_ptr
+ * @brief Intrusive reference counted pointer with copy-on-write.
+ * @tparam T: type of the pointee. T must be copy constructible to use mutate().
+ */
+template <typename T>
+class node_ptr {
+ public:
+    node_ptr(void) noexcept = default;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create a new uniquely owned node.
+     * @param args[in]: arguments forwarded to the constructor of T.
+     * @return node_ptr which owns the created node.
+     */
+    template <typename... ARGS>
+    static node_ptr make(ARGS&&... args) {
+        return create(get_default_resource(), std::forward<ARGS>(args)...);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Copy constructor. Shares the node with `other`.
+     */
+    node_ptr(const node_ptr& other) noexcept :
+        p_(other.p_) {
+        if (p_ != nullptr) {
+            p_->count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Move constructor. The counter is not touched.
+     */
+    node_ptr(node_ptr&& other) noexcept :
+        p_(other.p_) {
+        other.p_ = nullptr;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    node_ptr& operator=(node_ptr other) noexcept {
+        std::swap(p_, other.p_);
+        return *this;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    ~node_ptr(void) {
+        release();
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    explicit operator bool(void) const noexcept { return p_ != nullptr; }
+    const T& operator*(void) const noexcept { return p_->value; }
+    const T* operator->(void) const noexcept { return &p_->value; }
+    const T* get(void) const noexcept { return (p_ != nullptr) ? &p_->value : nullptr; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check the node is owned only by this node_ptr.
+     */
+    bool unique(void) const noexcept {
+        return (p_ != nullptr) && (p_->count.load(std::memory_order_acquire) == 1);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the cached hash of the pointee.
+     * @return the hash stored by cache_hash(), or 0 if it is not stored or the pointee is mutated since then.
+     * @pre static_cast<bool>(*this) == true.
+     */
+    std::uint64_t cached_hash(void) const noexcept {
+        return p_->hash.load(std::memory_order_relaxed);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Store the hash of the pointee. the node is shared, so all owners see it.
+     * @param hash[in]: hash value other than 0.
+     * @pre static_cast<bool>(*this) == true.
+     */
+    void cache_hash(std::uint64_t hash) const noexcept {
+        p_->hash.store(hash, std::memory_order_relaxed);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Bytes allocated for one node, including the counter.
+     */
+    static constexpr size_t node_size(void) noexcept {
+        return sizeof(block_t);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the mutable pointee. If the node is shared, it is cloned beforehand.
+     * @return mutable reference to the pointee, which is owned only by this node_ptr.
+     * @pre static_cast<bool>(*this) == true.
+     */
+    T& mutate(void) {
+        if (not unique()) {
+            node_ptr clone = create(p_->resource, p_->value);
+            std::swap(p_, clone.p_);
+        }
+        p_->hash.store(0, std::memory_order_relaxed);
+        return p_->value;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    struct block_t {
+        template <typename... ARGS>
+        explicit block_t(memory_resource* r, ARGS&&... args) :
+            count(1),
+            hash(0),
+            resource(r),
+            value(std::forward<ARGS>(args)...) {
+        }
+
+        std::atomic<std::uint32_t> count;
+        std::atomic<std::uint64_t> hash;  // 0: not cached
+        memory_resource* resource;
+        T value;
+    };
+
+    template <typename... ARGS>
+    static node_ptr create(memory_resource* resource, ARGS&&... args) {
+        void* p = resource->allocate(sizeof(block_t), alignof(block_t));
+        node_ptr ret;
+        try {
+            ret.p_ = new (p) block_t(resource, std::forward<ARGS>(args)...);
+        } catch (...) {
+            resource->deallocate(p, sizeof(block_t), alignof(block_t));
+            throw;
+        }
+        return ret;
+    }
+
+    void release(void) noexcept {
+        // when the count is 1, no other owner can exist, so the decrement can be skipped.
+        if ((p_ != nullptr) &&
+            ((p_->count.load(std::memory_order_acquire) == 1) ||
+             (p_->count.fetch_sub(1, std::memory_order_acq_rel) == 1))) {
+            memory_resource* resource = p_->resource;
+            p_->~block_t();
+            resource->deallocate(p_, sizeof(block_t), alignof(block_t));
+        }
+        p_ = nullptr;
+    }
+
+    block_t* p_ = nullptr;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_NODE_PTR_H_
@@ -0,0 +1,159 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/overlay.cpp
+ * @brief implement tomload::overlay_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/overlay.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace tomload {
+
+/*
+ * @brief Stack documents.
+ * @param layers[in]: documents from the lowest to the highest. copying item_t shares its nodes.
+ * @throw std::invalid_argument: if `layers` is empty.
+ */
+overlay_t::overlay_t(std::vector<item_t> layers) :
+    owner_(std::make_shared<const std::vector<item_t>>(std::move(layers))) {
+    if (owner_->empty()) {
+        throw std::invalid_argument("no layer");
+    }
+    // the root follows the same rule as the other paths.
+    for (size_t i = owner_->size(); i > 0; --i) {
+        const item_t& item = (*owner_)[i - 1];
+        if (not items_.empty() && not item.is_table()) {
+            break;
+        }
+        items_.push_back(&item);
+        if (not item.is_table()) {
+            break;
+        }
+    }
+    std::reverse(items_.begin(), items_.end());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Resolve `key` through the layers.
+ * @param key[in]: appointed key of the table.
+ * @return view of `key` in the layers which have it.
+ * @throw type_error: if this is not table.
+ * @throw std::out_of_range: if no layer has `key`.
+ */
+overlay_t overlay_t::operator[](const key_t& key) const {
+    if (not is_table()) {
+        throw type_error("not table");
+    }
+
+    std::vector<const item_t*> items;
+    for (auto it = items_.rbegin(); it != items_.rend(); ++it) {
+        if (not (*it)->contains(key)) {
+            continue;
+        }
+        const item_t& child = (**it)[key];
+        if (not items.empty() && not child.is_table()) {
+            break;  // hidden by the table above
+        }
+        items.push_back(&child);
+        if (not child.is_table()) {
+            break;  // hides the lower layers
+        }
+    }
+    if (items.empty()) {
+        throw std::out_of_range("key not found");
+    }
+    std::reverse(items.begin(), items.end());
+    return overlay_t(owner_, std::move(items));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check if any layer has `key`.
+ * @throw type_error: if this is not table.
+ */
+bool overlay_t::contains(const key_t& key) const {
+    if (not is_table()) {
+        throw type_error("not table");
+    }
+    return std::any_of(items_.begin(), items_.end(), [&key](const item_t* item) { return item->contains(key); });
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the resolved value is a table.
+ */
+bool overlay_t::is_table(void) const noexcept {
+    return items_.back()->is_table();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Keys of the merged table in ascending order.
+ * @throw type_error: if this is not table.
+ */
+std::vector<key_t> overlay_t::keys(void) const {
+    if (not is_table()) {
+        throw type_error("not table");
+    }
+
+    std::vector<key_t> ret;
+    std::vector<key_t> layer;
+    std::vector<key_t> merged;
+    for (const item_t* item : items_) {
+        layer.clear();
+        for (const auto& i : item->table_range()) {
+            layer.emplace_back(i.first.data(), i.first.size());
+        }
+        // both are sorted, so they are merged in linear time.
+        merged.clear();
+        std::set_union(ret.begin(), ret.end(), layer.begin(), layer.end(), std::back_inserter(merged));
+        ret.swap(merged);
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Item of the highest layer. for a table, it has the keys of that layer only.
+ */
+const item_t& overlay_t::item(void) const noexcept {
+    return *items_.back();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Number of layers which have this path.
+ */
+size_t overlay_t::depth(void) const noexcept {
+    return items_.size();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Merge the layers into one item.
+ * @return merged item. the lowest layer is shared, and only the tables which the upper layers
+ *         override are copied, so the cost depends on the upper layers, not on the lowest one.
+ */
+item_t overlay_t::flatten(void) const {
+    item_t ret = *items_.front();
+    for (size_t i = 1; i < items_.size(); ++i) {
+        ret = ret.merged(*items_[i]);
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+overlay_t::overlay_t(std::shared_ptr<const std::vector<item_t>> owner, std::vector<const item_t*> items) :
+    owner_(std::move(owner)),
+    items_(std::move(items)) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/overlay.h
+ * @brief Header file for overlay_t class.
+ * @details overlay_t stacks documents, e.g. defaults, region, cluster and host, and resolves
+ *          lookups through the layers without merging them:
+ *            - the last layer wins,
+ *            - tables of the layers are merged, so a key is found in any layer which has it,
+ *            - a value which is not a table hides the values of the lower layers,
+ *              and a table hides the values of the lower layers which are not tables.
+ *          operator[] resolves only the path looked up, and flatten() merges the layers into
+ *          one item_t in one pass, copying only the tables which the upper layers override.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::overlay_t config({defaults, region, host});
+ *      int64_t port = config["server"]["port"].item().get_integer();  // host's port if host has one
+ *      tomload::item_t merged = config.flatten();
+ */
+
+#ifndef TOMLOAD_OVERLAY_H_
+#define TOMLOAD_OVERLAY_H_
+
+#include <memory>
+#include <vector>
+#include "tomload/tomload.h"
+
+namespace tomload {
+
+/*
+ * @class overlay_t
+ * @brief View of stacked documents, or of the same path in them.
+ * @note copying overlay_t is cheap. the layers are shared and kept alive by every view.
+ */
+class overlay_t {
+ public:
+    /*
+     * @brief Stack documents.
+     * @param layers[in]: documents from the lowest to the highest. copying item_t shares its nodes.
+     * @throw std::invalid_argument: if `layers` is empty.
+     */
+    explicit overlay_t(std::vector<item_t> layers);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Resolve `key` through the layers.
+     * @param key[in]: appointed key of the table.
+     * @return view of `key` in the layers which have it.
+     * @throw type_error: if this is not table.
+     * @throw std::out_of_range: if no layer has `key`.
+     */
+    overlay_t operator[](const key_t& key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check if any layer has `key`.
+     * @throw type_error: if this is not table.
+     */
+    bool contains(const key_t& key) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check the resolved value is a table.
+     */
+    bool is_table(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Keys of the merged table in ascending order.
+     * @throw type_error: if this is not table.
+     */
+    std::vector<key_t> keys(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Item of the highest layer. for a table, it has the keys of that layer only.
+     */
+    const item_t& item(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of layers which have this path.
+     */
+    size_t depth(void) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Merge the layers into one item.
+     * @return merged item. the lowest layer is shared, and only the tables which the upper layers
+     *         override are copied, so the cost depends on the upper layers, not on the lowest one.
+     */
+    item_t flatten(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    overlay_t(std::shared_ptr<const std::vector<item_t>> owner, std::vector<const item_t*> items);
+    /////////////////////////////////////////////////////////////////////////////
+
+    std::shared_ptr<const std::vector<item_t>> owner_;  // keeps the layers alive.
+    std::vector<const item_t*> items_;  // values of this path from the lowest to the highest, not empty.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_OVERLAY_H_
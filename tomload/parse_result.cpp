@@ -0,0 +1,99 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/parse_result.cpp
+ * @brief implement tomload::try_parse().
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/parse_result.h"
+#include <utility>
+#include "tomload/memory_resource.h"
+#include "tomload/parser.h"
+
+namespace tomload {
+
+/*
+ * @param value[in]: parsed document.
+ */
+parse_result_t::parse_result_t(item_t value) :
+    value_(new item_t(std::move(value))) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @param code[in]: category of the error.
+ * @param offset[in]: byte offset where the error is detected.
+ * @param message[in]: string literal, which is the message of the error.
+ */
+parse_result_t::parse_result_t(parse_errc_t code, size_t offset, const char* message) noexcept :
+    code_(code),
+    offset_(offset),
+    message_(message) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief The parsed document.
+ * @throw parse_error: if parsing failed.
+ */
+const item_t& parse_result_t::value(void) const {
+    if (not value_) {
+        throw parse_error(message_, offset_);
+    }
+    return *value_;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t& parse_result_t::value(void) {
+    return const_cast<item_t&>(static_cast<const parse_result_t&>(*this).value());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Line and column of the error, which are computed by this call.
+ * @param source[in]: the document given to try_parse().
+ * @return the location, or {0, 0} if parsing succeeded.
+ */
+source_location_t parse_result_t::locate(view_t source) const noexcept {
+    return value_ ? source_location_t{} : tomload::locate(source, offset_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as format_error(source, offset(), message()), or empty if parsing succeeded.
+ */
+std::string parse_result_t::format(view_t source) const {
+    return value_ ? std::string() : format_error(source, offset_, message_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document without throwing parse_error.
+ * @param view[in]: raw TOML string.
+ * @param options[in]: options of parsing.
+ * @return the document, or the first error. the document is the same as item_t(view, options).
+ */
+parse_result_t try_parse(view_t view, const parse_options_t& options) {
+    resource_scope_t scope(options.resource);
+    item_t root{single_construct, table_t{}};
+
+    parse_context_t context(options);
+    document_handler_t handler(&root, context);
+    parse_status_t& status = handler.status();
+    check_control_character(view, status);
+    if (not status.failed()) {
+        view_t rest = view;
+        parse_statements(rest, handler);
+    }
+
+    if (status.failed()) {
+        return parse_result_t(status.code(), static_cast<size_t>(status.where() - view.data()), status.message());
+    }
+    context.report();
+    return parse_result_t(std::move(root));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
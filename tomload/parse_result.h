@@ -0,0 +1,101 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/parse_result.h
+ * @brief Header file for parsing without exceptions.
+ * @details try_parse() builds the same document as item_t(view, options), but an ill-formed
+ *          document is reported by the result instead of parse_error:
+ *            - the lexer, the number and string parsers and the checks of keys and tables record
+ *              the first error in parse_status_t and return, so no exception is thrown or unwound,
+ *            - the error has its category, the byte offset where it is detected, and the message,
+ *              which is the same as parse_error::what() of item_t. the line and the column are
+ *              computed only by locate() or format(), from the offset and the source.
+ *          std::bad_alloc is still thrown.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::view_t src = "a = 1\na = 2\n";
+ *      tomload::parse_result_t result = tomload::try_parse(src);
+ *      if (not result) {
+ *          std::cerr << result.format(src);  // => "line 2, column 5: already reginstered"
+ *      }
+ */
+
+#ifndef TOMLOAD_PARSE_RESULT_H_
+#define TOMLOAD_PARSE_RESULT_H_
+
+#include <memory>
+#include <string>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @class parse_result_t
+ * @brief Result of try_parse(): the document, or the first error.
+ */
+class parse_result_t {
+ public:
+    /*
+     * @param value[in]: parsed document.
+     */
+    explicit parse_result_t(item_t value);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @param code[in]: category of the error.
+     * @param offset[in]: byte offset where the error is detected.
+     * @param message[in]: string literal, which is the message of the error.
+     */
+    parse_result_t(parse_errc_t code, size_t offset, const char* message) noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    explicit operator bool(void) const noexcept { return code_ == PARSE_OK; }
+    parse_errc_t error(void) const noexcept { return code_; }
+    size_t offset(void) const noexcept { return offset_; }
+    const char* message(void) const noexcept { return message_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Line and column of the error, which are computed by this call.
+     * @param source[in]: the document given to try_parse().
+     * @return the location, or {0, 0} if parsing succeeded.
+     */
+    source_location_t locate(view_t source) const noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Same as format_error(source, offset(), message()), or empty if parsing succeeded.
+     */
+    std::string format(view_t source) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief The parsed document.
+     * @throw parse_error: if parsing failed.
+     */
+    const item_t& value(void) const;
+    item_t& value(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    std::unique_ptr<item_t> value_;  // nullptr if parsing failed
+    parse_errc_t code_ = PARSE_OK;
+    size_t offset_ = 0;
+    const char* message_ = "";
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document without throwing parse_error.
+ * @param view[in]: raw TOML string.
+ * @param options[in]: options of parsing.
+ * @return the document, or the first error. the document is the same as item_t(view, options).
+ */
+parse_result_t try_parse(view_t view, const parse_options_t& options = parse_options_t{});
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_PARSE_RESULT_H_
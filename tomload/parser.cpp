@@ -7,15 +7,71 @@
  */
 
 #include "tomload/parser.h"
-#include <limits>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include "tomload/detail_number.h"
 #include "tomload/detail_string.h"
+#include "tomload/sax.h"
 
 namespace tomload {
 
+parse_context_t::parse_context_t(const parse_options_t& options) :
+    options_(options) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Create a string item. The string is pooled in `parse_options_t::dedup_strings` mode.
+ * @param str[in,out]: parsed string.
+ */
+item_t parse_context_t::make_string(text_t&& str) {
+    ++strings_;
+    if (options_.dedup_strings) {
+        return item_t{single_construct, pool_.intern(std::move(str))};
+    } else {
+        return item_t{single_construct, std::move(str)};
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Create an integer or float item from the token at the top of `view`.
+ *        The conversion is deferred in `parse_options_t::lazy_numbers` mode.
+ * @param view[in]: toml string which starts with the token.
+ * @param length[in]: length of the token.
+ * @param is_float[in]: the token is float or integer.
+ * @param status[in,out]: receives the error if the token is ill-formed or out of range.
+ */
+item_t parse_context_t::make_number(view_t view, view_t::size_type length, bool is_float, parse_status_t& status) {
+    if (is_float) {
+        validate_float(view, length, status);
+        if (options_.lazy_numbers && not status.failed() && is_float_in_range(view, length)) {
+            return item_t{lazy_construct, true, view_t(view.data(), length)};
+        }
+        return item_t{single_construct, status.failed() ? 0.0 : convert_float(view, length, status)};
+    } else {
+        validate_integer(view, length, status);
+        if (options_.lazy_numbers && not status.failed() && is_integer_in_range(view, length)) {
+            return item_t{lazy_construct, false, view_t(view.data(), length)};
+        }
+        return item_t{single_construct, status.failed() ? 0 : convert_integer(view, length, status)};
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Write statistics to `parse_options_t::stats` if it is requested.
+ */
+void parse_context_t::report(void) const {
+    if (options_.stats != nullptr) {
+        options_.stats->strings = strings_;
+        options_.stats->unique_strings = options_.dedup_strings ? pool_.stored() : strings_;
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /**
  * @brief Checks a string for disallowed control characters and single carriage returns.
  *
@@ -31,21 +87,44 @@ namespace tomload {
  *         as part of the standard CR+LF (\r\n) sequence.
  */
 void check_control_character(view_t view) {
-    for (char c : view) {
+    parse_status_t status;
+    check_control_character(view, status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as check_control_character(view), but the error is recorded in `status`
+ *        at the character.
+ */
+void check_control_character(view_t view, parse_status_t& status) {
+    view_t::size_type pos = find_control_character(view);
+    if (pos == view_t::npos) {
+    } else if (view[pos] == '\r') {
+        status.fail(PARSE_CONTROL_CHARACTER, "detect single CR", view.data() + pos);
+    } else {
+        status.fail(PARSE_CONTROL_CHARACTER, "detect disallowed character", view.data() + pos);
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Find the first character which check_control_character() rejects.
+ * @return position of the character, or view_t::npos if there is none.
+ */
+view_t::size_type find_control_character(view_t view) {
+    for (view_t::size_type i = 0; i < view.size(); ++i) {
+        char c = view[i];
         if (('\x00' <= c && c <= '\x08') ||
             ('\x0b' <= c && c <= '\x0c') ||
             ('\x0e' <= c && c <= '\x1f') ||
             (c == '\x7f')) {
-                throw parse_error("detect disallowed character");
-        }
-    }
-
-    for (view_t::size_type i = 0; i < view.size(); ++i) {
-        if ((view[i] == '\r') &&
-            ((i + 1 == view.size()) || (view[i + 1] != '\n'))) {
-            throw parse_error("detect single CR");
+            return i;
+        } else if ((c == '\r') && ((i + 1 == view.size()) || (view[i + 1] != '\n'))) {
+            return i;
         }
     }
+    return view_t::npos;
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -101,182 +180,265 @@ void skip_space(view_t& view, view_t spaces, bool skip_comment) {
 }
 /////////////////////////////////////////////////////////////////////////////
 
-item_t parse_array(view_t& view) {
-    std::shared_ptr<std::vector<item_t>> v = std::make_shared<std::vector<item_t>>();
-
-    view.remove_prefix(1);
-
-    enum {
-        wait_item,
-        wait_comma,
-        closed,
-    } status = wait_item;
-
-    while (status != closed) {
-        skip_space(view, " \t\r\n", true);
-
-        if (view.empty()) {
-            throw parse_error("missing \"]\" in array");
-        } else if (starts_with(view, "]")) {
-            view.remove_prefix(1);
-            status = closed;
-        } else if (status == wait_item) {
-            v->push_back(parse_item(view));
-            status = wait_comma;
-        } else if (status == wait_comma) {
-            skip_space(view, " \t\r\n", true);
-            if (view.empty()) {
-                throw parse_error("missing \",\" or \"]\" in array");
-            } else if (starts_with(view, ",")) {
-                view.remove_prefix(1);
-                status = wait_item;
-            } else {
-                throw parse_error("missing \",\" or \"]\" in array");
+/*
+ * @brief Skip a basic, literal or multi-line string which starts at `pos`, without checking
+ *        its escape sequences.
+ * @return position just after the string. an unterminated string ends at the end of the line,
+ *         or at the end of `view` if it is multi-line.
+ */
+size_t skip_string(view_t view, size_t pos) {
+    const char quote = view[pos];
+    const bool basic = (quote == '"');
+    const view_t delimiter = basic ? "\"\"\"" : "'''";
+
+    if (starts_with(view.substr(pos), delimiter)) {
+        for (pos += 3; pos < view.size(); ++pos) {
+            if (basic && (view[pos] == '\\')) {
+                ++pos;
+            } else if (starts_with(view.substr(pos), delimiter)) {
+                pos += 3;
+                // up to two quotes are allowed just before the closing delimiter
+                for (int i = 0; (i < 2) && (pos < view.size()) && (view[pos] == quote); ++i) {
+                    ++pos;
+                }
+                return pos;
             }
-        } else {
-            throw parse_error("unknown error");
         }
+        return view.size();
     }
 
-    return item_t{single_construct, v};
+    for (++pos; pos < view.size(); ++pos) {
+        if (view[pos] == quote) {
+            return pos + 1;
+        } else if (view[pos] == '\n') {
+            return pos;
+        } else if (basic && (view[pos] == '\\') && (pos + 1 < view.size()) && (view[pos + 1] != '\n')) {
+            ++pos;
+        }
+    }
+    return view.size();
 }
 /////////////////////////////////////////////////////////////////////////////
 
-item_t parse_inline_table(view_t& view) {
-    item_t ret{single_construct, std::make_shared<std::map<key_t, item_t>>()};
-
-    view.remove_prefix(1);
-
-    std::vector<key_t> keys;
-    std::vector<std::pair<std::vector<key_t>, item_t>> key_vals;
+/*
+ * @brief Check the line starts a statement, a table header or a key followed by '='.
+ * @param line[in]: toml string after the indent.
+ * @param header[in]: accept only a table header.
+ */
+bool starts_statement(view_t line, bool header) {
+    bool bracket = starts_with(line, "[");
+    if (bracket) {
+        line.remove_prefix(1);
+    } else if (header) {
+        return false;
+    }
 
-    enum {
-        wait_key,
-        wait_equal,
-        wait_value,
-        wait_comma,
-        closed,
-    } status = wait_key;
+    parse_status_t status;
+    parse_keys(line, status);
+    if (status.failed()) {
+        return false;
+    }
+    skip_space(line, " \t", false);
+    return starts_with(line, bracket ? "]" : "=");
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    while (status != closed) {
-        skip_space(view, " \t", false);
+/*
+ * @param context[in,out]: options and working state of parsing, which must outlive this object.
+ */
+dom_handler_t::dom_handler_t(parse_context_t& context) :
+    context_(context) {
+    set_max_depth(context.max_depth());
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        if (view.empty()) {
-            throw parse_error("imcomplete inline table");
-        } else if (starts_with(view, "}")) {
-            if (((status == wait_key) && key_vals.empty()) ||
-                (status == wait_comma)) {
-                view.remove_prefix(1);
-                status = closed;
-            } else {
-                throw parse_error("imcomplete inline table");
-            }
-        } else if (status == wait_key) {
-            keys = parse_keys(view);
-            status = wait_equal;
-        } else if (status == wait_equal) {
-            if (starts_with(view, "=")) {
-                view.remove_prefix(1);
-                status = wait_value;
-            } else {
-                throw parse_error("missing \"=\" in inline table");
-            }
-        } else if (status == wait_value) {
-            key_vals.emplace_back(std::move(keys), parse_item(view));
-            status = wait_comma;
-        } else if (status == wait_comma) {
-            if (starts_with(view, ",")) {
-                view.remove_prefix(1);
-                status = wait_key;
-            } else {
-                throw parse_error("missing \",\" or \"}\" in array");
-            }
-        } else {
-            throw parse_error("unknown error");
-        }
+void dom_handler_t::on_key_value(std::vector<text_t>& keys) {
+    if (frames_.empty()) {
+        keys_ = std::move(keys);
+    } else {
+        frames_.back().keys = std::move(keys);
     }
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    ret.set_inline_table_keys_value(std::move(key_vals));
+void dom_handler_t::on_array_begin(void) {
+    frames_.emplace_back();
+    frames_.back().is_array = true;
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    return ret;
+void dom_handler_t::on_array_end(void) {
+    item_t item{single_construct, std::move(frames_.back().array)};
+    frames_.pop_back();
+    complete(std::move(item));
 }
 /////////////////////////////////////////////////////////////////////////////
 
-item_t parse_item(view_t& view) {
-    const std::pair<view_t, item_t> fixed_values[8] = {
-        {"true", item_t{single_construct, true}},
-        {"false", item_t{single_construct, false}},
-        {"inf", item_t{single_construct, std::numeric_limits<double>::infinity()}},
-        {"+inf", item_t{single_construct, std::numeric_limits<double>::infinity()}},
-        {"-inf", item_t{single_construct, -std::numeric_limits<double>::infinity()}},
-        {"nan", item_t{single_construct, std::numeric_limits<double>::quiet_NaN()}},
-        {"+nan", item_t{single_construct, std::numeric_limits<double>::quiet_NaN()}},
-        {"-nan", item_t{single_construct, std::numeric_limits<double>::quiet_NaN()}},
-    };
-
-    for (const auto& pair : fixed_values) {
-        if (starts_with(view, pair.first)) {
-            view.remove_prefix(pair.first.size());
-            return pair.second;
-        }
+void dom_handler_t::on_inline_table_begin(void) {
+    frames_.emplace_back();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void dom_handler_t::on_inline_table_end(void) {
+    item_t item{single_construct, table_t{}};
+    item.set_inline_table_keys_value(std::move(frames_.back().key_vals), status());
+    frames_.pop_back();
+    if (not status().failed()) {
+        complete(std::move(item));
     }
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    if (starts_with(view, {"0x", "0o", "0b"})) {
-        view_t::size_type length = get_radix_length(view);
-        integer_t i = parse_radix_value(view, length);
+void dom_handler_t::on_boolean(boolean_t value) {
+    complete(item_t{single_construct, value});
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        view.remove_prefix(length);
-        return item_t{single_construct, i};
-    } else if (starts_with(view, {"+", "-", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9"})) {
-        view_t::size_type integer_length = get_integer_length(view);
-        view_t::size_type float_length = get_float_length(view);
-        if (float_length > integer_length) {
-            float_t d = parse_float(view, float_length);
+void dom_handler_t::on_integer(integer_t value) {
+    complete(item_t{single_construct, value});
+}
+/////////////////////////////////////////////////////////////////////////////
 
-            view.remove_prefix(float_length);
-            return item_t{single_construct, d};
-        } else {
-            integer_t i = parse_integer(view, integer_length);
+void dom_handler_t::on_float(float_t value) {
+    complete(item_t{single_construct, value});
+}
+/////////////////////////////////////////////////////////////////////////////
 
-            view.remove_prefix(integer_length);
-            return item_t{single_construct, i};
-        }
-    } else if (starts_with(view, "'''")) {
-        view_t::size_type length = get_multi_literal_string_length(view);
-        string_t str = parse_multi_literal_string(view, length);
+void dom_handler_t::on_string(view_t value) {
+    complete(context_.make_string(text_t(value.data(), value.size())));
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        view.remove_prefix(length);
-        return item_t{single_construct, std::move(str)};
-    } else if (starts_with(view, "'")) {
-        view_t::size_type length = get_literal_string_length(view);
-        string_t str = parse_literal_string(view, length);
+void dom_handler_t::on_number(view_t token, bool is_float) {
+    item_t item = context_.make_number(token, token.size(), is_float, status());
+    if (not status().failed()) {
+        complete(std::move(item));
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        view.remove_prefix(length);
-        return item_t{single_construct, std::move(str)};
-    } else if (starts_with(view, "\"\"\"")) {
-        view_t::size_type length = get_multi_string_length(view);
-        string_t str = parse_multi_string(view, length);
+/*
+ * @brief Get the value built by parse_value_events().
+ * @pre a value is completed at the top level, and on_item() is not overridden.
+ */
+item_t dom_handler_t::release(void) {
+    return std::move(*result_);
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        view.remove_prefix(length);
-        return item_t{single_construct, std::move(str)};
-    } else if (starts_with(view, "\"")) {
-        view_t::size_type length = get_string_length(view);
-        string_t str = parse_string(view, length);
+/*
+ * @brief Receive a value completed at the top level. the default keeps it for release().
+ * @param keys[in,out]: keys given by on_key_value(), or empty for parse_value_events().
+ * @param item[in]: completed value.
+ */
+void dom_handler_t::on_item(std::vector<text_t>& keys, item_t item) {
+    static_cast<void>(keys);
+    result_.reset(new item_t(std::move(item)));
+}
+/////////////////////////////////////////////////////////////////////////////
 
-        view.remove_prefix(length);
-        return item_t{single_construct, std::move(str)};
-    } else if (starts_with(view, "[")) {
-        return parse_array(view);
-    } else if (starts_with(view, "{")) {
-        return parse_inline_table(view);
+/*
+ * @brief Add a completed value to the array or the inline table under construction,
+ *        or pass it to on_item() at the top level.
+ */
+void dom_handler_t::complete(item_t item) {
+    if (frames_.empty()) {
+        on_item(keys_, std::move(item));
+    } else if (frames_.back().is_array) {
+        frames_.back().array.push_back(std::move(item));
     } else {
-        throw parse_error("not hit item");
+        frame_t& frame = frames_.back();
+        frame.key_vals.emplace_back(std::move(frame.keys), std::move(item));
     }
 }
 /////////////////////////////////////////////////////////////////////////////
 
-std::vector<key_t> parse_keys(view_t& view) {
-    std::vector<std::string> keys;
+/*
+ * @param root[in,out]: empty table which receives the document.
+ * @param context[in,out]: options and working state of parsing, which must outlive this object.
+ */
+document_handler_t::document_handler_t(item_t* root, parse_context_t& context) :
+    dom_handler_t(context),
+    root_(root),
+    p_brackets_end_(root) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void document_handler_t::on_table_header(std::vector<text_t>& keys) {
+    bool super_table = tables_.insert_header(keys, status());
+    if (not status().failed()) {
+        p_brackets_end_ = root_->insert_brackets_table(keys, super_table, status());
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void document_handler_t::on_key_value(std::vector<text_t>& keys) {
+    if (not nested()) {
+        tables_.check_dotted_keys(keys, status());
+    }
+    dom_handler_t::on_key_value(keys);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void document_handler_t::on_item(std::vector<text_t>& keys, item_t item) {
+    root_->insert_keys_val(p_brackets_end_, std::move(keys), std::move(item), status());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t parse_array(view_t& view) {
+    parse_context_t context;
+    return parse_array(view, context);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with "[".
+ */
+item_t parse_array(view_t& view, parse_context_t& context) {
+    return parse_item(view, context);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t parse_inline_table(view_t& view) {
+    parse_context_t context;
+    return parse_inline_table(view, context);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre `view` must start with "{".
+ */
+item_t parse_inline_table(view_t& view, parse_context_t& context) {
+    return parse_item(view, context);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t parse_item(view_t& view) {
+    parse_context_t context;
+    return parse_item(view, context);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t parse_item(view_t& view, parse_context_t& context) {
+    dom_handler_t handler(context);
+    parse_value_events(view, handler);
+    return handler.release();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<text_t> parse_keys(view_t& view) {
+    parse_status_t status;
+    std::vector<text_t> ret = parse_keys(view, status);
+    status.raise();
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as parse_keys(view), but the error is recorded in `status`.
+ */
+std::vector<text_t> parse_keys(view_t& view, parse_status_t& status) {
+    std::vector<text_t> keys;
 
     bool wait_dot = false;
 
@@ -285,30 +447,38 @@ std::vector<key_t> parse_keys(view_t& view) {
 
         if (not wait_dot) {
             if (view.empty()) {
-                throw parse_error("unexpected end of input");
+                status.fail(PARSE_SYNTAX, "unexpected end of input", view.data());
+                return keys;
             } else if (view_t("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-").find(view[0]) != view_t::npos) {
                 view_t::size_type length = get_bare_length(view);
-                key_t s = parse_bare_value(view, length);
+                text_t s = parse_bare_value(view, length);
 
                 view.remove_prefix(length);
                 keys.push_back(std::move(s));
                 wait_dot = true;
             } else if (starts_with(view, "'")) {
-                view_t::size_type length = get_literal_string_length(view);
-                key_t s = parse_literal_string(view, length);
+                view_t::size_type length = get_literal_string_length(view, status);
+                if (status.failed()) {
+                    return keys;
+                }
+                text_t s = parse_literal_string(view, length);
 
                 view.remove_prefix(length);
                 keys.push_back(std::move(s));
                 wait_dot = true;
             } else if (starts_with(view, "\"")) {
-                view_t::size_type length = get_string_length(view);
-                key_t s = parse_string(view, length);
+                view_t::size_type length = get_string_length(view, status);
+                text_t s = status.failed() ? text_t() : parse_string(view, length, status);
+                if (status.failed()) {
+                    return keys;
+                }
 
                 view.remove_prefix(length);
                 keys.push_back(std::move(s));
                 wait_dot = true;
             } else {
-                throw parse_error("expected string");
+                status.fail(PARSE_SYNTAX, "expected string", view.data());
+                return keys;
             }
         } else {
             if (view.empty()) {
@@ -322,27 +492,68 @@ std::vector<key_t> parse_keys(view_t& view) {
         }
     }
     if (keys.empty()) {
-        throw parse_error("no keys found");
+        status.fail(PARSE_SYNTAX, "no keys found", view.data());
     }
     return keys;
 }
 /////////////////////////////////////////////////////////////////////////////
 
-void check_duplex_keys(const std::vector<key_t>& keys, const std::vector<std::vector<key_t>>& brackets_set) {
-// # See: https://github.com/toml-lang/toml/issues/846
-// #      https://github.com/toml-lang/toml/pull/859
-    if (not brackets_set.empty()) {
-        std::vector<std::vector<key_t>>::const_iterator begin = brackets_set.cbegin();
-        std::vector<std::vector<key_t>>::const_iterator end = brackets_set.cend() - 1;
-        const std::vector<key_t>& lastst = brackets_set.back();
+/*
+ * @brief Register a table header, which becomes the latest one.
+ * @param keys[in]: keys of the header.
+ * @param status[in,out]: receives the error if the header is identical to an earlier header.
+ * @return true if the header is a super-table of an earlier header, e.g. "[a]" after "[a.b]".
+ * @pre keys.empty() == false.
+ */
+bool table_registry_t::insert_header(const std::vector<text_t>& keys, parse_status_t& status) {
+    uint32_t path = ROOT;
+    for (const text_t& key : keys) {
+        if (path != ROOT) {
+            flags_[path] |= SUPER;
+        }
+        std::unordered_map<path_child_t, uint32_t, path_child_hash_t>::const_iterator found =
+            paths_.find(path_child_t{path, to_view(key)});
+        if (found != paths_.end()) {
+            path = found->second;
+        } else {
+            keys_.push_back(key);
+            uint32_t child = static_cast<uint32_t>(flags_.size());
+            paths_.emplace(path_child_t{path, to_view(keys_.back())}, child);
+            flags_.push_back(0);
+            path = child;
+        }
+    }
+
+    latest_ = path;
+    if (flags_[path] & HEADER) {
+        status.fail(PARSE_REDEFINED_TABLE, "duplicate bracket table");
+        return false;
+    }
+    flags_[path] |= HEADER;
+    return (flags_[path] & SUPER) != 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the dotted keys of a key-value pair under the latest header.
+ * @param status[in,out]: receives the error if a table of `keys` is defined by an earlier header.
+ */
+void table_registry_t::check_dotted_keys(const std::vector<text_t>& keys, parse_status_t& status) const {
+    if (latest_ == ROOT) {
+        return;
+    }
 
-        for (decltype(begin) it = begin; it != end; ++it) {
-            if ((lastst.size() < it->size()) &&
-                std::equal(lastst.cbegin(), lastst.cend(), it->cbegin()) &&
-                (it->size() < (lastst.size() + keys.size())) &&
-                std::equal(it->cbegin() + lastst.size(), it->cend(), keys.cbegin())) {
-                throw parse_error("found duplex key");
-            }
+    uint32_t path = latest_;
+    for (size_t i = 0; i + 1 < keys.size(); ++i) {
+        std::unordered_map<path_child_t, uint32_t, path_child_hash_t>::const_iterator found =
+            paths_.find(path_child_t{path, to_view(keys[i])});
+        if (found == paths_.end()) {  // no header starts with the keys
+            return;
+        }
+        path = found->second;
+        if (flags_[path] & HEADER) {
+            status.fail(PARSE_DUPLICATE_KEY, "found duplex key");
+            return;
         }
     }
 }
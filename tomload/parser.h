@@ -9,13 +9,234 @@
 #ifndef TOMLOAD_PARSER_H_
 #define TOMLOAD_PARSER_H_
 
+#include <cstdint>
+#include <deque>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "tomload/sax.h"
+#include "tomload/string_pool.h"
 #include "tomload/tomload.h"
 #include "tomload/view_t.h"
 
 namespace tomload {
 
+/*
+ * @class parse_context_t
+ * @brief Options and working state shared by the parse functions while parsing one document.
+ */
+class parse_context_t {
+ public:
+    parse_context_t(void) = default;
+    explicit parse_context_t(const parse_options_t& options);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create a string item. The string is pooled in `parse_options_t::dedup_strings` mode.
+     * @param str[in,out]: parsed string.
+     */
+    item_t make_string(text_t&& str);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Create an integer or float item from the token at the top of `view`.
+     *        The conversion is deferred in `parse_options_t::lazy_numbers` mode.
+     * @param view[in]: toml string which starts with the token.
+     * @param length[in]: length of the token.
+     * @param is_float[in]: the token is float or integer.
+     * @param status[in,out]: receives the error if the token is ill-formed or out of range.
+     */
+    item_t make_number(view_t view, view_t::size_type length, bool is_float, parse_status_t& status);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Write statistics to `parse_options_t::stats` if it is requested.
+     */
+    void report(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    size_t max_depth(void) const noexcept { return options_.max_depth; }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    parse_options_t options_;
+    string_pool_t pool_;
+    size_t strings_ = 0;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct path_child_t
+ * @brief Key of a path in a registry of paths: the number of the parent path and the last key.
+ * @note the key refers to a string which the registry owns, or to the caller's key for a lookup,
+ *       so a lookup copies nothing.
+ */
+struct path_child_t {
+    uint32_t parent;
+    view_t key;
+
+    bool operator==(const path_child_t& other) const noexcept {
+        return (parent == other.parent) && (key == other.key);
+    }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+struct path_child_hash_t {
+    size_t operator()(const path_child_t& child) const noexcept {
+        return hash_bytes(child.key) ^ (static_cast<size_t>(child.parent) * 0x9e3779b97f4a7c15ULL);
+    }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class table_registry_t
+ * @brief Paths of the table headers seen so far, and of their super-tables.
+ * @details a path is numbered by the order of registration, and found by its parent and its last
+ *          key, so each check costs O(length of the keys) however many headers are seen.
+ */
+class table_registry_t {
+ public:
+    table_registry_t(void) :
+        flags_(1, 0) {
+    }
+    // paths_ refers to keys_, so a copy would refer to the keys of the original.
+    table_registry_t(const table_registry_t&) = delete;
+    table_registry_t& operator=(const table_registry_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Register a table header, which becomes the latest one.
+     * @param keys[in]: keys of the header.
+     * @param status[in,out]: receives the error if the header is identical to an earlier header.
+     * @return true if the header is a super-table of an earlier header, e.g. "[a]" after "[a.b]".
+     * @pre keys.empty() == false.
+     */
+    bool insert_header(const std::vector<text_t>& keys, parse_status_t& status);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check the dotted keys of a key-value pair under the latest header.
+     * @param status[in,out]: receives the error if a table of `keys` is defined by an earlier header.
+     * @note See: https://github.com/toml-lang/toml/issues/846
+     *            https://github.com/toml-lang/toml/pull/859
+     */
+    void check_dotted_keys(const std::vector<text_t>& keys, parse_status_t& status) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    enum flag_t : unsigned char {
+        HEADER = 1,  // defined by a header
+        SUPER = 2,   // super-table of a header
+    };
+    static constexpr uint32_t ROOT = 0;
+    /////////////////////////////////////////////////////////////////////////////
+
+    std::unordered_map<path_child_t, uint32_t, path_child_hash_t> paths_;  // path to its number
+    std::deque<text_t> keys_;           // keys which paths_ refers to. a deque does not move them.
+    std::vector<unsigned char> flags_;  // flags of each path. the root has none.
+    uint32_t latest_ = ROOT;            // path of the latest header, or ROOT before the first one
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class dom_handler_t
+ * @brief Handler of parse_events() which builds item_t from the values.
+ * @details arrays and inline tables under construction are kept in a stack, so nesting needs no
+ *          recursion here. a value completed at the top level is passed to on_item().
+ */
+class dom_handler_t : public handler_t {
+ public:
+    /*
+     * @param context[in,out]: options and working state of parsing, which must outlive this object.
+     */
+    explicit dom_handler_t(parse_context_t& context);
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_key_value(std::vector<text_t>& keys) override;
+    void on_array_begin(void) override;
+    void on_array_end(void) override;
+    void on_inline_table_begin(void) override;
+    void on_inline_table_end(void) override;
+    void on_boolean(boolean_t value) override;
+    void on_integer(integer_t value) override;
+    void on_float(float_t value) override;
+    void on_string(view_t value) override;
+    void on_number(view_t token, bool is_float) override;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the value built by parse_value_events().
+     * @pre a value is completed at the top level, and on_item() is not overridden.
+     */
+    item_t release(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+ protected:
+    /*
+     * @brief Receive a value completed at the top level. the default keeps it for release().
+     * @param keys[in,out]: keys given by on_key_value(), or empty for parse_value_events().
+     * @param item[in]: completed value.
+     */
+    virtual void on_item(std::vector<text_t>& keys, item_t item);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Check an array or an inline table is under construction.
+     */
+    bool nested(void) const noexcept { return not frames_.empty(); }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    void complete(item_t item);
+    /////////////////////////////////////////////////////////////////////////////
+
+    struct frame_t {
+        bool is_array = false;
+        array_t array;
+        std::vector<text_t> keys;  // keys of the value under construction in inline table.
+        std::vector<std::pair<std::vector<text_t>, item_t>> key_vals;
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    parse_context_t& context_;
+    std::vector<frame_t> frames_;
+    std::vector<text_t> keys_;  // keys of the value under construction at the top level.
+    std::unique_ptr<item_t> result_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class document_handler_t
+ * @brief Handler of parse_events() which inserts the key-value pairs into a document.
+ * @details it keeps the table headers seen so far, so a document can be given in several calls
+ *          of parse_events() as long as each call has complete statements.
+ */
+class document_handler_t : public dom_handler_t {
+ public:
+    /*
+     * @param root[in,out]: empty table which receives the document.
+     * @param context[in,out]: options and working state of parsing, which must outlive this object.
+     */
+    document_handler_t(item_t* root, parse_context_t& context);
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_table_header(std::vector<text_t>& keys) override;
+    void on_key_value(std::vector<text_t>& keys) override;
+    /////////////////////////////////////////////////////////////////////////////
+
+ protected:
+    void on_item(std::vector<text_t>& keys, item_t item) override;
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    item_t* root_;
+    table_registry_t tables_;
+    item_t* p_brackets_end_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
 /**
  * @brief Checks a string for disallowed control characters and single carriage returns.
  *
@@ -33,6 +254,40 @@ namespace tomload {
 void check_control_character(view_t view);
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Same as check_control_character(view), but the error is recorded in `status`
+ *        at the character.
+ */
+void check_control_character(view_t view, parse_status_t& status);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Find the first character which check_control_character() rejects.
+ * @return position of the character, or view_t::npos if there is none.
+ */
+view_t::size_type find_control_character(view_t view);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse the statements of a TOML document and call `handler` for each element.
+ * @param view[in,out]: raw TOML string, whose control characters are already checked.
+ *                      the parsed statements are removed.
+ * @param handler[in,out]: receiver of the events.
+ * @return false if an error is recorded in handler.status(), which is located where it is detected.
+ * @note the status is not reset, so the caller can check one document in several calls.
+ */
+bool parse_statements(view_t& view, handler_t& handler);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse one statement, a table header or a key-value pair, and its end of line.
+ * @param view[in,out]: toml string which starts with the statement. the statement is removed.
+ * @param handler[in,out]: receiver of the events.
+ * @return false if an error is recorded in handler.status(), which is located where it is detected.
+ */
+bool parse_statement(view_t& view, handler_t& handler);
+/////////////////////////////////////////////////////////////////////////////
+
 /**
  * @brief Checks for a newline at the beginning of the input view.
  *
@@ -60,22 +315,51 @@ bool wait_newline(view_t& view);
 void skip_space(view_t& view, view_t spaces, bool skip_comment);
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Skip a basic, literal or multi-line string which starts at `pos`, without checking
+ *        its escape sequences.
+ * @return position just after the string. an unterminated string ends at the end of the line,
+ *         or at the end of `view` if it is multi-line.
+ */
+size_t skip_string(view_t view, size_t pos);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check the line starts a statement, a table header or a key followed by '='.
+ * @param line[in]: toml string after the indent.
+ * @param header[in]: accept only a table header.
+ */
+bool starts_statement(view_t line, bool header);
+/////////////////////////////////////////////////////////////////////////////
+
 item_t parse_array(view_t& view);
 /////////////////////////////////////////////////////////////////////////////
 
+item_t parse_array(view_t& view, parse_context_t& context);
+/////////////////////////////////////////////////////////////////////////////
+
 void insert_key_value(std::map<key_t, item_t>* p, std::vector<key_t> keys, item_t value);
 /////////////////////////////////////////////////////////////////////////////
 
 item_t parse_inline_table(view_t& view);
 /////////////////////////////////////////////////////////////////////////////
 
+item_t parse_inline_table(view_t& view, parse_context_t& context);
+/////////////////////////////////////////////////////////////////////////////
+
 item_t parse_item(view_t& view);
 /////////////////////////////////////////////////////////////////////////////
 
-std::vector<key_t> parse_keys(view_t& view);
+item_t parse_item(view_t& view, parse_context_t& context);
 /////////////////////////////////////////////////////////////////////////////
 
-void check_duplex_keys(const std::vector<key_t>& keys, const std::vector<std::vector<key_t>>& brackets_set);
+std::vector<text_t> parse_keys(view_t& view);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as parse_keys(view), but the error is recorded in `status`.
+ */
+std::vector<text_t> parse_keys(view_t& view, parse_status_t& status);
 /////////////////////////////////////////////////////////////////////////////
 
 }  // namespace tomload
@@ -0,0 +1,385 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/reader.cpp
+ * @brief implement tomload::reader_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/reader.h"
+#include <limits>
+#include "tomload/detail_number.h"
+#include "tomload/detail_string.h"
+#include "tomload/parser.h"
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @brief Remove the newline just after the opening delimiter of a multi-line string.
+ */
+view_t trim_first_newline(view_t sub) {
+    if (starts_with(sub, "\r\n")) {
+        sub.remove_prefix(2);
+    } else if (starts_with(sub, "\n")) {
+        sub.remove_prefix(1);
+    }
+    return sub;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @param view[in]: raw TOML string, which must outlive this object.
+ * @throw parse_error: if `view` contains a disallowed control character.
+ */
+reader_t::reader_t(view_t view) :
+    source_(view),
+    view_(view) {
+    check_control_character(view, status_);
+    raise(view);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Read the next token.
+ * @return the token, which is valid until the next call of next() or skip().
+ * @throw parse_error: if the syntax of the document is ill-formed.
+ */
+const token_t& reader_t::next(void) {
+    for (;;) {
+        state_t& state = frames_.empty() ? top_state_ : frames_.back();
+        switch (state) {
+        case TOP_STATEMENT:
+            skip_space(view_, " \t\r\n", true);
+            if (view_.empty()) {
+                set_token(TOKEN_END, view_);
+            } else if (starts_with(view_, "[")) {  // "[brackets]" line
+                size_t offset = static_cast<size_t>(view_.data() - source_.data());
+                view_.remove_prefix(1);
+                read_keys();
+                skip_space(view_, " \t", false);
+                if (not starts_with(view_, "]")) {
+                    fail("expected ']'");
+                }
+                view_.remove_prefix(1);
+                token_.kind = TOKEN_TABLE_HEADER;
+                token_.offset = offset;
+                state = TOP_NEWLINE;
+            } else {  // "key = value" line
+                read_keys();
+                skip_space(view_, " \t", false);
+                if (not starts_with(view_, "=")) {
+                    fail("expected '='");
+                }
+                view_.remove_prefix(1);
+                state = TOP_VALUE;
+            }
+            return token_;
+        case TOP_VALUE:
+            skip_space(view_, " \t", false);
+            state = TOP_NEWLINE;
+            read_value();
+            return token_;
+        case TOP_NEWLINE:
+            if (not wait_newline(view_)) {
+                fail("expected newline");
+            }
+            state = TOP_STATEMENT;
+            break;
+        case ARRAY_VALUE_OR_CLOSE:
+        case ARRAY_COMMA_OR_CLOSE:
+            skip_space(view_, " \t\r\n", true);
+            if (view_.empty()) {
+                fail("missing \"]\" in array");
+            } else if (starts_with(view_, "]")) {
+                set_token(TOKEN_ARRAY_END, view_.substr(0, 1));
+                view_.remove_prefix(1);
+                frames_.pop_back();
+                return token_;
+            } else if (state == ARRAY_VALUE_OR_CLOSE) {
+                state = ARRAY_COMMA_OR_CLOSE;
+                read_value();
+                return token_;
+            } else if (starts_with(view_, ",")) {
+                view_.remove_prefix(1);
+                state = ARRAY_VALUE_OR_CLOSE;
+            } else {
+                fail("missing \",\" or \"]\" in array");
+            }
+            break;
+        default:  // inline table
+            skip_space(view_, " \t", false);
+            if (view_.empty()) {
+                fail("imcomplete inline table");
+            } else if (starts_with(view_, "}")) {
+                if ((state != TABLE_KEY_OR_CLOSE) && (state != TABLE_COMMA_OR_CLOSE)) {
+                    fail("imcomplete inline table");
+                }
+                set_token(TOKEN_INLINE_TABLE_END, view_.substr(0, 1));
+                view_.remove_prefix(1);
+                frames_.pop_back();
+                return token_;
+            } else if ((state == TABLE_KEY_OR_CLOSE) || (state == TABLE_KEY)) {
+                read_keys();
+                skip_space(view_, " \t", false);
+                if (view_.empty() || starts_with(view_, "}")) {
+                    fail("imcomplete inline table");
+                } else if (not starts_with(view_, "=")) {
+                    fail("missing \"=\" in inline table");
+                }
+                view_.remove_prefix(1);
+                state = TABLE_VALUE;
+                return token_;
+            } else if (state == TABLE_VALUE) {
+                state = TABLE_COMMA_OR_CLOSE;
+                read_value();
+                return token_;
+            } else if (starts_with(view_, ",")) {
+                view_.remove_prefix(1);
+                state = TABLE_KEY;
+            } else {
+                fail("missing \",\" or \"}\" in array");
+            }
+            break;
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Skip a value without unescaping strings and converting numbers.
+ * @throw parse_error: if the skipped value is ill-formed, the same as reading it by next().
+ * @note numbers and escapes are still validated. a number is converted only when it may be out of range.
+ */
+void reader_t::skip(void) {
+    size_t target = depth();
+    if ((token_.kind == TOKEN_ARRAY_BEGIN) || (token_.kind == TOKEN_INLINE_TABLE_BEGIN)) {
+        --target;
+    } else if (token_.kind != TOKEN_KEY) {
+        return;
+    }
+
+    skipping_ = true;
+    try {
+        if (token_.kind == TOKEN_KEY) {
+            next();
+        }
+        while (depth() > target) {
+            next();
+        }
+    } catch (...) {
+        skipping_ = false;
+        throw;
+    }
+    skipping_ = false;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Read dotted keys and make TOKEN_KEY.
+ */
+void reader_t::read_keys(void) {
+    keys_.clear();
+    escaped_keys_.clear();
+    key_buffer_.clear();
+
+    const view_t top = view_;  // errors of the keys are located at their top
+    skip_space(view_, " \t", false);
+    const char* begin = view_.data();
+    for (;;) {
+        if (view_.empty()) {
+            fail("unexpected end of input");
+        } else if (view_t("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-").find(view_[0]) != view_t::npos) {
+            view_t::size_type length = get_bare_length(view_);
+            keys_.push_back(view_.substr(0, length));
+            view_.remove_prefix(length);
+        } else if (starts_with(view_, "'")) {
+            view_t::size_type length = get_literal_string_length(view_, status_);
+            raise(top);
+            keys_.push_back(view_.substr(1, length - 2));
+            view_.remove_prefix(length);
+        } else if (starts_with(view_, "\"")) {
+            view_t::size_type length = get_string_length(view_, status_);
+            raise(top);
+            view_t sub = view_.substr(1, length - 2);
+            if (sub.find('\\') == view_t::npos) {
+                keys_.push_back(sub);
+            } else {
+                // the buffer may be reallocated, so the view is made after all keys are read.
+                size_t offset = key_buffer_.size();
+                append_unescaped(sub, key_buffer_, status_);
+                raise(top);
+                escaped_keys_.emplace_back(keys_.size(), offset);
+                keys_.push_back(view_t(begin, key_buffer_.size() - offset));
+            }
+            view_.remove_prefix(length);
+        } else {
+            fail("expected string");
+        }
+
+        const char* end = view_.data();
+        skip_space(view_, " \t", false);
+        if (not starts_with(view_, ".")) {
+            set_token(TOKEN_KEY, view_t(begin, static_cast<size_t>(end - begin)));
+            break;
+        }
+        view_.remove_prefix(1);
+        skip_space(view_, " \t", false);
+    }
+
+    for (const auto& escaped : escaped_keys_) {
+        keys_[escaped.first] = view_t(key_buffer_.data() + escaped.second, keys_[escaped.first].size());
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Read a value and make its token. an array or an inline table makes its begin.
+ * @throw parse_error: if the value is ill-formed.
+ */
+void reader_t::read_value(void) {
+    const std::pair<view_t, float_t> special_floats[6] = {
+        {"inf", std::numeric_limits<double>::infinity()},
+        {"+inf", std::numeric_limits<double>::infinity()},
+        {"-inf", -std::numeric_limits<double>::infinity()},
+        {"nan", std::numeric_limits<double>::quiet_NaN()},
+        {"+nan", std::numeric_limits<double>::quiet_NaN()},
+        {"-nan", std::numeric_limits<double>::quiet_NaN()},
+    };
+
+    const view_t top = view_;  // errors of the value are located at its top
+    const size_t offset = static_cast<size_t>(view_.data() - source_.data());
+    if (starts_with(view_, "true") || starts_with(view_, "false")) {
+        bool value = starts_with(view_, "true");
+        set_token(TOKEN_BOOLEAN, view_.substr(0, value ? 4 : 5));
+        token_.b = value;
+        view_.remove_prefix(token_.text.size());
+        return;
+    }
+    for (const auto& pair : special_floats) {
+        if (starts_with(view_, pair.first)) {
+            set_token(TOKEN_FLOAT, view_.substr(0, pair.first.size()));
+            token_.d = pair.second;
+            view_.remove_prefix(pair.first.size());
+            return;
+        }
+    }
+
+    if (starts_with(view_, {"0x", "0o", "0b"})) {
+        view_t::size_type length = get_radix_length(view_);
+        set_token(TOKEN_INTEGER, view_.substr(0, length));
+        token_.i = parse_radix_value(view_, length, status_);
+        raise(top);
+        view_.remove_prefix(length);
+    } else if (starts_with(view_, {"+", "-", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9"})) {
+        view_t::size_type integer_length = get_integer_length(view_);
+        view_t::size_type float_length = get_float_length(view_, status_);
+        raise(top);
+        if (float_length > integer_length) {
+            set_token(TOKEN_FLOAT, view_.substr(0, float_length));
+            if (skipping_) {
+                // the syntax is checked, and the conversion is done only when it may be out of range.
+                validate_float(view_, float_length, status_);
+                if (not status_.failed() && not is_float_in_range(view_, float_length)) {
+                    convert_float(view_, float_length, status_);
+                }
+                token_.d = 0.0;
+            } else {
+                token_.d = parse_float(view_, float_length, status_);
+            }
+            raise(top);
+            view_.remove_prefix(float_length);
+        } else {
+            set_token(TOKEN_INTEGER, view_.substr(0, integer_length));
+            if (skipping_) {
+                validate_integer(view_, integer_length, status_);
+                if (not status_.failed() && not is_integer_in_range(view_, integer_length)) {
+                    convert_integer(view_, integer_length, status_);
+                }
+                token_.i = 0;
+            } else {
+                token_.i = parse_integer(view_, integer_length, status_);
+            }
+            raise(top);
+            view_.remove_prefix(integer_length);
+        }
+    } else if (starts_with(view_, "'''")) {
+        view_t::size_type length = get_multi_literal_string_length(view_, status_);
+        raise(top);
+        set_token(TOKEN_STRING, trim_first_newline(view_t(view_.data() + 3, length - 6)));
+        view_.remove_prefix(length);
+    } else if (starts_with(view_, "'")) {
+        view_t::size_type length = get_literal_string_length(view_, status_);
+        raise(top);
+        set_token(TOKEN_STRING, view_t(view_.data() + 1, length - 2));
+        view_.remove_prefix(length);
+    } else if (starts_with(view_, "\"")) {
+        bool multi = starts_with(view_, "\"\"\"");
+        view_t::size_type length = multi ? get_multi_string_length(view_, status_) : get_string_length(view_, status_);
+        raise(top);
+        view_t sub = multi ? trim_first_newline(view_t(view_.data() + 3, length - 6)) : view_t(view_.data() + 1, length - 2);
+        if (skipping_) {
+            validate_escapes(sub, status_);
+        } else if (sub.find('\\') != view_t::npos) {
+            string_buffer_.clear();
+            append_unescaped(sub, string_buffer_, status_);
+            sub = view_t(string_buffer_.data(), string_buffer_.size());
+        }
+        raise(top);
+        set_token(TOKEN_STRING, sub);
+        view_.remove_prefix(length);
+    } else if (starts_with(view_, "[")) {
+        set_token(TOKEN_ARRAY_BEGIN, view_.substr(0, 1));
+        view_.remove_prefix(1);
+        frames_.push_back(ARRAY_VALUE_OR_CLOSE);
+    } else if (starts_with(view_, "{")) {
+        set_token(TOKEN_INLINE_TABLE_BEGIN, view_.substr(0, 1));
+        view_.remove_prefix(1);
+        frames_.push_back(TABLE_KEY_OR_CLOSE);
+    } else {
+        fail("not hit item");
+    }
+    token_.offset = offset;  // the string token starts at the quote
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Record an error of the syntax at the rest of the source, and throw it.
+ * @throw parse_error: always.
+ */
+void reader_t::fail(const char* message) {
+    status_.fail(PARSE_SYNTAX, message, view_.data());
+    raise(view_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Throw the error recorded in status_, if any. an error without its position is located at `where`.
+ *        the status is cleared, so the next error is recorded after this one is caught.
+ * @throw parse_error: if an error is recorded.
+ */
+void reader_t::raise(view_t where) {
+    if (status_.failed()) {
+        parse_status_t status = status_;
+        status_.reset();
+        status.locate(where.data());
+        status.raise(source_.data());
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Set the kind and the text of the token, and the offset of the text.
+ */
+void reader_t::set_token(token_kind_t kind, view_t text) {
+    token_.kind = kind;
+    token_.text = text;
+    token_.offset = static_cast<size_t>(text.data() - source_.data());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,169 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/reader.h
+ * @brief Header file for reader_t class.
+ * @details reader_t is a pull parser. each next() reads one token of the document:
+ *            - "[a.b]" is TOKEN_TABLE_HEADER, and "a.b =" is TOKEN_KEY. keys() gives the unescaped keys,
+ *            - an array is TOKEN_ARRAY_BEGIN, the tokens of the elements, and TOKEN_ARRAY_END,
+ *            - an inline table is TOKEN_INLINE_TABLE_BEGIN, TOKEN_KEY and the tokens of the value
+ *              for each pair, and TOKEN_INLINE_TABLE_END,
+ *            - a scalar is TOKEN_BOOLEAN, TOKEN_INTEGER, TOKEN_FLOAT or TOKEN_STRING,
+ *            - TOKEN_END is returned at the end of the document, and after that.
+ *          tokens refer to the source or to buffers of the reader, which are reused, so reading a
+ *          token allocates nothing once the buffers are large enough. skip() passes over a whole
+ *          value without unescaping strings or converting numbers, but it reports the same errors as next().
+ *          like parse_events(), reader_t checks the syntax only. the source must outlive the reader.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::reader_t reader("[server]\nport = 80\nhosts = [\"a\", \"b\"]\n");
+ *      while (reader.next().kind != tomload::TOKEN_END) {
+ *          const tomload::token_t& token = reader.token();
+ *          if ((token.kind == tomload::TOKEN_KEY) && (reader.keys().back() == "hosts")) {
+ *              reader.skip();  // not interested
+ *          }
+ *      }
+ */
+
+#ifndef TOMLOAD_READER_H_
+#define TOMLOAD_READER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @enum token_kind_t
+ * @brief Kind of token_t.
+ */
+enum token_kind_t {
+    TOKEN_END = 0,
+    TOKEN_TABLE_HEADER,
+    TOKEN_KEY,
+    TOKEN_ARRAY_BEGIN,
+    TOKEN_ARRAY_END,
+    TOKEN_INLINE_TABLE_BEGIN,
+    TOKEN_INLINE_TABLE_END,
+    TOKEN_BOOLEAN,
+    TOKEN_INTEGER,
+    TOKEN_FLOAT,
+    TOKEN_STRING,
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct token_t
+ * @brief One token read by reader_t.
+ */
+struct token_t {
+    token_kind_t kind = TOKEN_END;
+    size_t offset = 0;  // offset of the token from the beginning of the source.
+    // TOKEN_STRING: unescaped string, which refers to the source if it has no escape sequence.
+    // TOKEN_TABLE_HEADER and TOKEN_KEY: keys in the source, like "a.\"b\"".
+    // the others: the token in the source, like "0x1F" or "[".
+    view_t text;
+    boolean_t b = false;  // TOKEN_BOOLEAN
+    integer_t i = 0;      // TOKEN_INTEGER
+    float_t d = 0.0;      // TOKEN_FLOAT
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class reader_t
+ * @brief Pull parser of a TOML document.
+ */
+class reader_t {
+ public:
+    /*
+     * @param view[in]: raw TOML string, which must outlive this object.
+     * @throw parse_error: if `view` contains a disallowed control character.
+     */
+    explicit reader_t(view_t view);
+    /////////////////////////////////////////////////////////////////////////////
+
+    reader_t(const reader_t&) = delete;
+    reader_t& operator=(const reader_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Read the next token.
+     * @return the token, which is valid until the next call of next() or skip().
+     * @throw parse_error: if the syntax of the document is ill-formed. parse_error::offset() is
+     *                     the byte offset in the source where it is detected, the same as item_t.
+     */
+    const token_t& next(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Skip a value without unescaping strings and converting numbers.
+     *        after TOKEN_KEY, its value is skipped. after TOKEN_ARRAY_BEGIN or
+     *        TOKEN_INLINE_TABLE_BEGIN, the rest of the container is skipped including its end.
+     *        it does nothing after the other tokens.
+     * @throw parse_error: if the syntax of the skipped value is ill-formed.
+     * @note the token is undefined after skip(). call next() to continue.
+     */
+    void skip(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief The last token read by next().
+     */
+    const token_t& token(void) const noexcept { return token_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Unescaped keys of the last TOKEN_TABLE_HEADER or TOKEN_KEY.
+     *        they are valid until the next TOKEN_TABLE_HEADER or TOKEN_KEY.
+     */
+    const std::vector<view_t>& keys(void) const noexcept { return keys_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of arrays and inline tables which contain the current position.
+     */
+    size_t depth(void) const noexcept { return frames_.size(); }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    enum state_t {
+        TOP_STATEMENT,         // header, key or end of document
+        TOP_VALUE,             // value after the key
+        TOP_NEWLINE,           // end of the line
+        ARRAY_VALUE_OR_CLOSE,  // element or "]"
+        ARRAY_COMMA_OR_CLOSE,  // "," or "]"
+        TABLE_KEY_OR_CLOSE,    // key or "}" just after "{"
+        TABLE_KEY,             // key after ","
+        TABLE_VALUE,           // value after the key
+        TABLE_COMMA_OR_CLOSE,  // "," or "}"
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    void read_keys(void);
+    void read_value(void);
+    void set_token(token_kind_t kind, view_t text);
+    void fail(const char* message);
+    void raise(view_t where);
+    /////////////////////////////////////////////////////////////////////////////
+
+    view_t source_;
+    view_t view_;     // rest of the source
+    token_t token_;
+    state_t top_state_ = TOP_STATEMENT;
+    std::vector<state_t> frames_;  // state of each array and inline table
+    bool skipping_ = false;
+    std::vector<view_t> keys_;
+    std::vector<std::pair<size_t, size_t>> escaped_keys_;  // index in keys_, offset in key_buffer_
+    std::string key_buffer_;
+    std::string string_buffer_;
+    parse_status_t status_;  // error which is being thrown
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_READER_H_
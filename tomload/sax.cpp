@@ -0,0 +1,467 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/sax.cpp
+ * @brief implement event-driven parsing.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/sax.h"
+#include <limits>
+#include <string>
+#include "tomload/detail_number.h"
+#include "tomload/detail_string.h"
+#include "tomload/parser.h"
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @brief Remove the newline just after the opening delimiter of a multi-line string.
+ */
+view_t trim_first_newline(view_t sub) {
+    if (starts_with(sub, "\r\n")) {
+        sub.remove_prefix(2);
+    } else if (starts_with(sub, "\n")) {
+        sub.remove_prefix(1);
+    }
+    return sub;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Record an error at `view`, to be returned by the parse functions.
+ * @return false, for `return fail(...)`.
+ */
+bool fail(handler_t& handler, parse_errc_t code, const char* message, view_t view) {
+    handler.status().fail(code, message, view.data());
+    return false;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check a lexer function or a method of `handler` recorded an error.
+ *        an error without its position is located at `view`.
+ */
+bool failed(handler_t& handler, view_t view) {
+    parse_status_t& status = handler.status();
+    status.locate(view.data());
+    return status.failed();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a value other than an array and an inline table.
+ * @return false if an error is recorded in handler.status().
+ */
+bool parse_scalar(view_t& view, handler_t& handler) {
+    const std::pair<view_t, float_t> special_floats[6] = {
+        {"inf", std::numeric_limits<double>::infinity()},
+        {"+inf", std::numeric_limits<double>::infinity()},
+        {"-inf", -std::numeric_limits<double>::infinity()},
+        {"nan", std::numeric_limits<double>::quiet_NaN()},
+        {"+nan", std::numeric_limits<double>::quiet_NaN()},
+        {"-nan", std::numeric_limits<double>::quiet_NaN()},
+    };
+    parse_status_t& status = handler.status();
+    view_t top = view;  // errors of the value are located at its top
+
+    if (starts_with(view, "true")) {
+        view.remove_prefix(4);
+        handler.on_boolean(true);
+        return not failed(handler, top);
+    } else if (starts_with(view, "false")) {
+        view.remove_prefix(5);
+        handler.on_boolean(false);
+        return not failed(handler, top);
+    }
+    for (const auto& pair : special_floats) {
+        if (starts_with(view, pair.first)) {
+            view.remove_prefix(pair.first.size());
+            handler.on_float(pair.second);
+            return not failed(handler, top);
+        }
+    }
+
+    if (starts_with(view, {"0x", "0o", "0b"})) {
+        view_t::size_type length = get_radix_length(view);
+        integer_t i = parse_radix_value(view, length, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+
+        view.remove_prefix(length);
+        handler.on_integer(i);
+    } else if (starts_with(view, {"+", "-", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9"})) {
+        view_t::size_type integer_length = get_integer_length(view);
+        view_t::size_type float_length = get_float_length(view, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+        bool is_float = (float_length > integer_length);
+        view_t::size_type length = is_float ? float_length : integer_length;
+
+        handler.on_number(view_t(view.data(), length), is_float);
+        view.remove_prefix(length);
+    } else if (starts_with(view, "'''")) {
+        view_t::size_type length = get_multi_literal_string_length(view, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+        view_t sub = trim_first_newline(view_t(view.data() + 3, length - 6));
+
+        view.remove_prefix(length);
+        handler.on_string(sub);
+    } else if (starts_with(view, "'")) {
+        view_t::size_type length = get_literal_string_length(view, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+        view_t sub(view.data() + 1, length - 2);
+
+        view.remove_prefix(length);
+        handler.on_string(sub);
+    } else if (starts_with(view, "\"\"\"")) {
+        view_t::size_type length = get_multi_string_length(view, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+        view_t sub = trim_first_newline(view_t(view.data() + 3, length - 6));
+
+        view.remove_prefix(length);
+        if (sub.find('\\') == view_t::npos) {
+            handler.on_string(sub);
+        } else {
+            handler.on_escaped_string(sub);
+        }
+    } else if (starts_with(view, "\"")) {
+        view_t::size_type length = get_string_length(view, status);
+        if (failed(handler, top)) {
+            return false;
+        }
+        view_t sub(view.data() + 1, length - 2);
+
+        view.remove_prefix(length);
+        if (sub.find('\\') == view_t::npos) {
+            handler.on_string(sub);
+        } else {
+            handler.on_escaped_string(sub);
+        }
+    } else {
+        return fail(handler, PARSE_SYNTAX, "not hit item", view);
+    }
+    return not failed(handler, top);  // an error of the handler is reported at the value
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @class value_parser_t
+ * @brief Parser of a value, which keeps the arrays and the inline tables under construction in
+ *        handler_t::containers_ instead of the call stack.
+ */
+class value_parser_t {
+ public:
+    /*
+     * @brief Same as parse_value_events(), but the error is recorded in handler.status().
+     * @return false if an error is recorded.
+     */
+    static bool parse(view_t& view, handler_t& handler) {
+        std::vector<unsigned char>& frames = handler.containers_;
+        frames.clear();
+        for (;;) {
+            if (starts_with(view, {"[", "{"})) {
+                if (frames.size() >= handler.max_depth()) {
+                    return fail(handler, PARSE_TOO_DEEP, "nesting too deep", view);
+                }
+                bool is_array = starts_with(view, "[");
+                view.remove_prefix(1);
+                if (is_array) {
+                    handler.on_array_begin();
+                } else {
+                    handler.on_inline_table_begin();
+                }
+                if (failed(handler, view)) {
+                    return false;
+                }
+                frames.push_back(is_array ? ARRAY_VALUE_OR_CLOSE : TABLE_KEY_OR_CLOSE);
+            } else if (not parse_scalar(view, handler)) {
+                return false;
+            }
+
+            // close the containers until the next value is expected
+            for (bool wait_value = false; not wait_value; ) {
+                if (frames.empty()) {
+                    return true;
+                } else if (not step(view, handler, frames, wait_value)) {
+                    return false;
+                }
+            }
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    enum state_t : unsigned char {
+        ARRAY_VALUE_OR_CLOSE,  // element or "]"
+        ARRAY_COMMA_OR_CLOSE,  // "," or "]"
+        TABLE_KEY_OR_CLOSE,    // key or "}" just after "{"
+        TABLE_KEY,             // key after ","
+        TABLE_COMMA_OR_CLOSE,  // "," or "}"
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Read the innermost container up to its next value or its end.
+     * @param wait_value[out]: true if a value follows.
+     * @return false if an error is recorded in handler.status().
+     */
+    static bool step(view_t& view, handler_t& handler, std::vector<unsigned char>& frames, bool& wait_value) {
+        unsigned char& state = frames.back();
+        if ((state == ARRAY_VALUE_OR_CLOSE) || (state == ARRAY_COMMA_OR_CLOSE)) {
+            skip_space(view, " \t\r\n", true);
+            if (view.empty()) {
+                return fail(handler, PARSE_SYNTAX, "missing \"]\" in array", view);
+            } else if (starts_with(view, "]")) {
+                view.remove_prefix(1);
+                frames.pop_back();
+                handler.on_array_end();
+                return not failed(handler, view);
+            } else if (state == ARRAY_VALUE_OR_CLOSE) {
+                state = ARRAY_COMMA_OR_CLOSE;
+                wait_value = true;
+            } else if (starts_with(view, ",")) {
+                view.remove_prefix(1);
+                state = ARRAY_VALUE_OR_CLOSE;
+            } else {
+                return fail(handler, PARSE_SYNTAX, "missing \",\" or \"]\" in array", view);
+            }
+            return true;
+        }
+
+        skip_space(view, " \t", false);
+        if (view.empty()) {
+            return fail(handler, PARSE_SYNTAX, "imcomplete inline table", view);
+        } else if (starts_with(view, "}")) {
+            if (state == TABLE_KEY) {
+                return fail(handler, PARSE_SYNTAX, "imcomplete inline table", view);
+            }
+            view.remove_prefix(1);
+            frames.pop_back();
+            handler.on_inline_table_end();
+            return not failed(handler, view);
+        } else if (state == TABLE_COMMA_OR_CLOSE) {
+            if (starts_with(view, ",")) {
+                view.remove_prefix(1);
+                state = TABLE_KEY;
+                return true;
+            }
+            return fail(handler, PARSE_SYNTAX, "missing \",\" or \"}\" in array", view);
+        }
+
+        // "key = " in the inline table
+        view_t top = view;
+        std::vector<text_t> keys = parse_keys(view, handler.status());
+        if (failed(handler, top)) {
+            return false;
+        }
+        skip_space(view, " \t", false);
+        if (view.empty() || starts_with(view, "}")) {
+            return fail(handler, PARSE_SYNTAX, "imcomplete inline table", view);
+        } else if (not starts_with(view, "=")) {
+            return fail(handler, PARSE_SYNTAX, "missing \"=\" in inline table", view);
+        }
+        view.remove_prefix(1);
+        skip_space(view, " \t", false);
+        if (view.empty() || starts_with(view, "}")) {
+            return fail(handler, PARSE_SYNTAX, "imcomplete inline table", view);
+        }
+
+        state = TABLE_COMMA_OR_CLOSE;
+        handler.on_key_value(keys);
+        if (failed(handler, view)) {
+            return false;
+        }
+        wait_value = true;
+        return true;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+};
+/////////////////////////////////////////////////////////////////////////////
+
+void handler_t::on_table_header(std::vector<text_t>&) {}
+void handler_t::on_key_value(std::vector<text_t>&) {}
+void handler_t::on_array_begin(void) {}
+void handler_t::on_array_end(void) {}
+void handler_t::on_inline_table_begin(void) {}
+void handler_t::on_inline_table_end(void) {}
+void handler_t::on_boolean(boolean_t) {}
+void handler_t::on_integer(integer_t) {}
+void handler_t::on_float(float_t) {}
+void handler_t::on_string(view_t) {}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Basic or multi-line basic string which has escape sequences, before unescaping.
+ * @param raw[in]: content between the delimiters in the source. its escape sequences are not yet validated.
+ */
+void handler_t::on_escaped_string(view_t raw) {
+    std::string str;
+    append_unescaped(raw, str, status_);
+    if (not status_.failed()) {
+        on_string(view_t(str.data(), str.size()));
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Decimal integer or float, before its conversion.
+ * @param token[in]: token in the source, like "1_000" or "6.02e23".
+ * @param is_float[in]: the token is float or integer.
+ */
+void handler_t::on_number(view_t token, bool is_float) {
+    if (is_float) {
+        float_t value = parse_float(token, token.size(), status_);
+        if (not status_.failed()) {
+            on_float(value);
+        }
+    } else {
+        integer_t value = parse_integer(token, token.size(), status_);
+        if (not status_.failed()) {
+            on_integer(value);
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document and call `handler` for each element.
+ * @param view[in]: raw TOML string.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the syntax of the document is ill-formed. parse_error::offset() is
+ *                     the byte offset in `view` where it is detected.
+ */
+void parse_events(view_t view, handler_t& handler) {
+    parse_events(std::vector<view_t>{view}, handler);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document given in pieces, which are split at the end of lines.
+ * @param pieces[in]: raw TOML strings.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the syntax of the document is ill-formed. parse_error::offset() is
+ *                     the byte offset in the pieces concatenated.
+ */
+void parse_events(const std::vector<view_t>& pieces, handler_t& handler) {
+    parse_status_t& status = handler.status();
+    status.reset();
+    size_t preceding = 0;  // the offset of an error is in the pieces concatenated
+    for (view_t piece : pieces) {
+        check_control_character(piece, status);
+        if (not status.failed()) {
+            view_t view = piece;
+            parse_statements(view, handler);
+        }
+        status.raise(piece.data(), preceding);
+        preceding += piece.size();
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse one value at the top of `view` and call `handler` for it.
+ * @param view[in,out]: toml string which starts with a value. the value is removed.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the value is ill-formed.
+ */
+void parse_value_events(view_t& view, handler_t& handler) {
+    handler.status().reset();
+    const char* begin = view.data();
+    value_parser_t::parse(view, handler);
+    handler.status().raise(begin);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse the statements of a TOML document and call `handler` for each element.
+ * @param view[in,out]: raw TOML string, whose control characters are already checked.
+ *                      the parsed statements are removed.
+ * @param handler[in,out]: receiver of the events.
+ * @return false if an error is recorded in handler.status(), which is located where it is detected.
+ */
+bool parse_statements(view_t& view, handler_t& handler) {
+    skip_space(view, " \t\r\n", true);
+    while (not view.empty()) {
+        if (not parse_statement(view, handler)) {
+            return false;
+        }
+        skip_space(view, " \t\r\n", true);
+    }
+    return true;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse one statement, a table header or a key-value pair, and its end of line.
+ * @param view[in,out]: toml string which starts with the statement. the statement is removed.
+ * @param handler[in,out]: receiver of the events.
+ * @return false if an error is recorded in handler.status(), which is located where it is detected.
+ */
+bool parse_statement(view_t& view, handler_t& handler) {
+    if (starts_with(view, "[")) {  // parse "[brackets]" line
+        view.remove_prefix(1);
+        view_t top = view;
+        std::vector<text_t> brackets = parse_keys(view, handler.status());
+        if (failed(handler, top)) {
+            return false;
+        }
+
+        skip_space(view, " \t", false);
+        if (starts_with(view, "]")) {
+            handler.on_table_header(brackets);
+            if (failed(handler, view)) {
+                return false;
+            }
+            view.remove_prefix(1);
+        } else {
+            return fail(handler, PARSE_SYNTAX, "expected ']'", view);
+        }
+    } else {  // parse "key = value" line
+        view_t top = view;
+        std::vector<text_t> keys = parse_keys(view, handler.status());
+        if (failed(handler, top)) {
+            return false;
+        }
+
+        skip_space(view, " \t", false);
+        if (starts_with(view, "=")) {
+            view.remove_prefix(1);
+        } else {
+            return fail(handler, PARSE_SYNTAX, "expected '='", view);
+        }
+
+        skip_space(view, " \t", false);
+        handler.on_key_value(keys);
+        if (failed(handler, view)) {  // located at the value, as errors found after the value
+            return false;
+        }
+
+        if (not value_parser_t::parse(view, handler)) {
+            return false;
+        }
+    }
+
+    // wait new line (allow end of text)
+    if (wait_newline(view)) {
+    } else {
+        return fail(handler, PARSE_SYNTAX, "expected newline", view);
+    }
+    return true;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
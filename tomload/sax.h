@@ -0,0 +1,165 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/sax.h
+ * @brief Header file for event-driven parsing.
+ * @details parse_events() reads a TOML document and calls the methods of handler_t for each
+ *          element, without building item_t:
+ *            - "[a.b]" calls on_table_header({"a", "b"}),
+ *            - "a.b = value" calls on_key_value({"a", "b"}), and then the events of the value,
+ *            - an array calls on_array_begin(), the events of the elements, and on_array_end(),
+ *            - an inline table calls on_inline_table_begin(), on_key_value() and the events of
+ *              the value for each pair, and on_inline_table_end(),
+ *            - a scalar calls on_boolean(), on_integer(), on_float() or on_string().
+ *          nested arrays and inline tables are parsed with a stack of one byte per level in the
+ *          handler, not by recursion, so any depth up to handler_t::max_depth() is parsed in
+ *          constant stack usage.
+ *          parse_events() checks the syntax only. duplicated keys and redefined tables are errors
+ *          of the document, but they are detected by the handler which needs it, e.g. item_t.
+ *          item_t itself is built by a handler on top of parse_events().
+ * @note target version of C++ is C++14.
+ * @example
+ *      struct counter_t : tomload::handler_t {
+ *          size_t strings = 0;
+ *          void on_string(tomload::view_t) override { ++strings; }
+ *      };
+ *      counter_t counter;
+ *      tomload::parse_events("a = \"x\"\nb = [\"y\", 1]\n", counter);  // counter.strings == 2
+ */
+
+#ifndef TOMLOAD_SAX_H_
+#define TOMLOAD_SAX_H_
+
+#include <vector>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+class value_parser_t;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class handler_t
+ * @brief Receiver of the events of parse_events(). every method does nothing by default.
+ * @note a method may stop parsing by status().fail(), which parse_events() throws as parse_error,
+ *       or by an exception, which is passed to the caller of parse_events().
+ */
+class handler_t {
+ public:
+    virtual ~handler_t(void) = default;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Table header, like "[a.b]".
+     * @param keys[in,out]: unescaped keys. the handler may move them.
+     */
+    virtual void on_table_header(std::vector<text_t>& keys);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Keys of a key-value pair, in the document or in an inline table.
+     *        the events of the value follow.
+     * @param keys[in,out]: unescaped keys. the handler may move them.
+     */
+    virtual void on_key_value(std::vector<text_t>& keys);
+    /////////////////////////////////////////////////////////////////////////////
+
+    virtual void on_array_begin(void);
+    virtual void on_array_end(void);
+    virtual void on_inline_table_begin(void);
+    virtual void on_inline_table_end(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+    virtual void on_boolean(boolean_t value);
+    virtual void on_integer(integer_t value);
+    virtual void on_float(float_t value);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief String value.
+     * @param value[in]: unescaped string. it refers to the source when the string has no escape
+     *                   sequence, or to a temporary buffer otherwise, and is valid only in this call.
+     */
+    virtual void on_string(view_t value);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Basic or multi-line basic string which has escape sequences, before unescaping.
+     * @param raw[in]: content between the delimiters in the source, like "a\\tb". its escape
+     *                 sequences are not yet validated.
+     * @note the default unescapes `raw` into a temporary buffer and calls on_string(), or records
+     *       the error of an ill-formed escape sequence in status().
+     *       override it to skip unescaping.
+     */
+    virtual void on_escaped_string(view_t raw);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Decimal integer or float, before its conversion.
+     * @param token[in]: token in the source, like "1_000" or "6.02e23".
+     * @param is_float[in]: the token is float or integer.
+     * @note the default validates and converts `token`, and calls on_integer() or on_float(), or
+     *       records the error of an ill-formed or out of range token in status().
+     *       override it to keep or to skip the conversion. hexadecimal, octal and binary integers,
+     *       inf and nan are always passed to on_integer() or on_float().
+     */
+    virtual void on_number(view_t token, bool is_float);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Error of parsing, which the parser and the methods record instead of throwing.
+     */
+    parse_status_t& status(void) noexcept { return status_; }
+    const parse_status_t& status(void) const noexcept { return status_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Maximum nesting of arrays and inline tables. a deeper value is an error of PARSE_TOO_DEEP.
+     */
+    size_t max_depth(void) const noexcept { return max_depth_; }
+    void set_max_depth(size_t depth) noexcept { max_depth_ = depth; }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    friend class value_parser_t;
+
+    parse_status_t status_;
+    size_t max_depth_ = DEFAULT_MAX_DEPTH;
+    std::vector<unsigned char> containers_;  // stack of the parser, which is reused by the values
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document and call `handler` for each element.
+ * @param view[in]: raw TOML string.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the syntax of the document is ill-formed. parse_error::offset() is
+ *                     the byte offset in `view` where it is detected.
+ */
+void parse_events(view_t view, handler_t& handler);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a TOML document given in pieces, which are split at the end of lines.
+ * @param pieces[in]: raw TOML strings.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the syntax of the document is ill-formed. parse_error::offset() is
+ *                     the byte offset in the pieces concatenated.
+ */
+void parse_events(const std::vector<view_t>& pieces, handler_t& handler);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse one value at the top of `view` and call `handler` for it.
+ * @param view[in,out]: toml string which starts with a value. the value is removed.
+ * @param handler[in,out]: receiver of the events.
+ * @throw parse_error: if the value is ill-formed.
+ */
+void parse_value_events(view_t& view, handler_t& handler);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_SAX_H_
@@ -0,0 +1,308 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/stream_parser.cpp
+ * @brief implement tomload::stream_parser_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/stream_parser.h"
+#include <istream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "tomload/parser.h"
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @brief Feed `parser` with `in` until the end, and finish it.
+ * @note the buffer is allocated once, so the memory for reading does not grow with the document.
+ */
+void feed_stream(std::istream& in, stream_parser_t& parser, size_t buffer_size) {
+    if (buffer_size == 0) {
+        throw std::invalid_argument("buffer size is 0");
+    }
+    std::vector<char> buffer(buffer_size);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        size_t count = static_cast<size_t>(in.gcount());
+        if (count > 0) {
+            parser.feed(view_t(buffer.data(), count));
+        }
+    }
+    if (in.bad()) {
+        throw std::ios_base::failure("failed to read the stream");
+    }
+    parser.finish();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @brief Build item_t from the chunks.
+ * @param options[in]: options of parsing. `parse_options_t::lazy_numbers` is ignored,
+ *                     because the chunks are not kept.
+ */
+stream_parser_t::stream_parser_t(const parse_options_t& options) :
+    options_(options),
+    handler_(nullptr) {
+    options_.lazy_numbers = false;
+    resource_scope_t scope(options_.resource);
+    root_.reset(new item_t(std::vector<view_t>{}, options_));
+    context_.reset(new parse_context_t(options_));
+    document_.reset(new document_handler_t(root_.get(), *context_));
+    handler_ = document_.get();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Give the events of the chunks to `handler`.
+ * @param handler[in,out]: receiver of the events, which must outlive this object.
+ *                         the views given to it are valid only in each call.
+ */
+stream_parser_t::stream_parser_t(handler_t& handler) :
+    handler_(&handler) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+stream_parser_t::~stream_parser_t(void) = default;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Give the next chunk of the document.
+ * @param chunk[in]: part of the document. it is not referred to after this call.
+ * @throw parse_error: if a complete statement is ill-formed.
+ * @throw std::logic_error: if finish() is already called.
+ */
+void stream_parser_t::feed(view_t chunk) {
+    if (finished_) {
+        throw std::logic_error("already finished");
+    }
+    buffer_.append(chunk.data(), chunk.size());
+    parse(scan());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse the rest of the document.
+ * @throw parse_error: if the rest is ill-formed, e.g. a string is not closed.
+ * @throw std::logic_error: if finish() is already called.
+ */
+void stream_parser_t::finish(void) {
+    if (finished_) {
+        throw std::logic_error("already finished");
+    }
+    finished_ = true;
+    parse(buffer_.size());
+    if (context_) {
+        context_->report();
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get the document built.
+ * @throw std::logic_error: if finish() is not called, or this parser gives the events to a handler.
+ */
+item_t stream_parser_t::release(void) {
+    if (not finished_ || not root_) {
+        throw std::logic_error("no document");
+    }
+    return std::move(*root_);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Scan buffer_ from scanned_ for the ends of statements.
+ * @return bytes of the complete statements at the beginning of buffer_.
+ */
+size_t stream_parser_t::scan(void) {
+    size_t ret = 0;
+    size_t pos = scanned_;
+    while (pos < buffer_.size()) {
+        char c = buffer_[pos];
+        if (escaped_) {
+            escaped_ = false;
+            if (c == '\n') {  // a line ending backslash of a multi-line string
+                start_line(pos + 1);
+            }
+            ++pos;
+            continue;
+        }
+
+        // a run of quotes decides the opening and the closing of strings, so it must be complete.
+        if (((c == '"') || (c == '\'')) && (state_ != SCAN_COMMENT)) {
+            size_t end = buffer_.find_first_not_of(c, pos);
+            if (end == std::string::npos) {
+                break;  // wait for the next chunk. finish() parses the rest without scanning.
+            }
+            size_t run = end - pos;
+            scan_state_t basic = (c == '"') ? SCAN_BASIC : SCAN_LITERAL;
+            scan_state_t multi = (c == '"') ? SCAN_MULTI_BASIC : SCAN_MULTI_LITERAL;
+            if (state_ == SCAN_NORMAL) {
+                if (run >= 3) {
+                    state_ = multi;  // the quotes after the delimiter are the content
+                    pos += 3;
+                } else {
+                    state_ = (run == 1) ? basic : SCAN_NORMAL;  // "" is an empty string
+                    pos += run;
+                }
+                continue;
+            } else if (state_ == basic) {
+                state_ = SCAN_NORMAL;
+                ++pos;
+                continue;
+            } else if (state_ == multi) {
+                if (run >= 3) {
+                    state_ = SCAN_NORMAL;  // up to two quotes before the delimiter are the content
+                }
+                pos += run;
+                continue;
+            }
+        }
+
+        switch (state_) {
+        case SCAN_NORMAL:
+            if (c == '#') {
+                state_ = SCAN_COMMENT;
+            } else if ((c == '[') || (c == '{')) {
+                ++depth_;
+            } else if (((c == ']') || (c == '}')) && (depth_ > 0)) {
+                --depth_;
+            } else if (c == '\n') {
+                ret = end_line(pos, ret);
+            }
+            break;
+        case SCAN_COMMENT:
+            if (c == '\n') {
+                state_ = SCAN_NORMAL;
+                ret = end_line(pos, ret);
+            }
+            break;
+        case SCAN_BASIC:
+        case SCAN_LITERAL:
+            if (c == '\n') {
+                // ill-formed, and the parser reports it. the error is found within this line,
+                // so it is the same whether the rest of the document follows or not.
+                state_ = SCAN_NORMAL;
+                ret = end_line(pos, ret);
+            } else if ((c == '\\') && (state_ == SCAN_BASIC)) {
+                escaped_ = true;
+            }
+            break;
+        case SCAN_MULTI_BASIC:
+            if (c == '\\') {
+                escaped_ = true;
+            } else if (c == '\n') {
+                start_line(pos + 1);
+            }
+            break;
+        default:  // SCAN_MULTI_LITERAL
+            if (c == '\n') {
+                start_line(pos + 1);
+            }
+            break;
+        }
+        ++pos;
+    }
+    scanned_ = pos;
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Record the beginning of a line at `pos` in buffer_, and whether it is in an array or
+ *        an inline table outside of strings.
+ */
+void stream_parser_t::start_line(size_t pos) noexcept {
+    line_ = pos;
+    in_value_ = (state_ == SCAN_NORMAL) && (depth_ > 0);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Handle the newline at `pos` outside of multi-line strings.
+ * @param ret[in]: bytes of the complete statements so far.
+ * @return bytes of the complete statements including this line, if it ends a statement.
+ * @note a line in an array or an inline table which starts a statement, like "b = 2", is
+ *       always ill-formed there, and the error is found at or before its '='. so the unclosed
+ *       value is parsed up to the line, and reported without waiting for the rest of the document.
+ */
+size_t stream_parser_t::end_line(size_t pos, size_t ret) {
+    if (in_value_) {
+        view_t line(buffer_.data() + line_, pos - line_);
+        skip_space(line, " \t", false);
+        if ((line.find('=') != view_t::npos) && starts_statement(line, false)) {
+            depth_ = 0;  // the parser reports the error
+        }
+    }
+    if (depth_ == 0) {
+        ret = pos + 1;
+    }
+    start_line(pos + 1);
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse the first `size` bytes of buffer_, and remove them.
+ */
+void stream_parser_t::parse(size_t size) {
+    if (size == 0) {
+        return;
+    }
+    resource_scope_t scope(options_.resource);
+    parse_status_t& status = handler_->status();
+    view_t view(buffer_.data(), size);
+    status.reset();
+    check_control_character(view, status);
+    if (not status.failed()) {
+        view_t rest = view;
+        parse_statements(rest, *handler_);
+    }
+    status.raise(view.data(), parsed_);  // the offset is in the whole document
+    buffer_.erase(0, size);
+    scanned_ -= size;
+    line_ -= size;
+    parsed_ += size;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a document read from `in`, through a buffer of fixed size.
+ * @param in[in,out]: stream of the document. it is read until the end.
+ * @param options[in]: options of parsing. `parse_options_t::lazy_numbers` is ignored.
+ * @param buffer_size[in]: size of the buffer to read into.
+ * @return the document.
+ * @throw parse_error: if the document is ill-formed.
+ * @throw std::ios_base::failure: if reading `in` fails.
+ * @throw std::invalid_argument: if `buffer_size` is 0.
+ */
+item_t parse_stream(std::istream& in, const parse_options_t& options, size_t buffer_size) {
+    stream_parser_t parser(options);
+    feed_stream(in, parser, buffer_size);
+    return parser.release();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Give the events of a document read from `in` to `handler`, through a buffer of fixed size.
+ * @param in[in,out]: stream of the document. it is read until the end.
+ * @param handler[in,out]: receiver of the events. the views given to it are valid only in each call.
+ * @param buffer_size[in]: size of the buffer to read into.
+ * @throw parse_error: if the document is ill-formed.
+ * @throw std::ios_base::failure: if reading `in` fails.
+ * @throw std::invalid_argument: if `buffer_size` is 0.
+ */
+void parse_stream(std::istream& in, handler_t& handler, size_t buffer_size) {
+    stream_parser_t parser(handler);
+    feed_stream(in, parser, buffer_size);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,173 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/stream_parser.h
+ * @brief Header file for stream_parser_t class.
+ * @details stream_parser_t parses a TOML document given in chunks of any size, e.g. read from a
+ *          pipe or a decompressor:
+ *            - feed() scans the chunk for the ends of statements, which are newlines outside of
+ *              strings, comments, arrays and inline tables, and parses the complete statements,
+ *            - only the incomplete statement at the end is kept, so the memory for the input is
+ *              bounded by the largest statement, e.g. a long array, not by the whole document.
+ *              an array left open is reported at the first line in it which starts a statement,
+ *              so it does not keep the rest of the document,
+ *            - a token split between chunks, like a multi-line string, a number or CR LF, is
+ *              parsed after the chunk which completes its statement arrives,
+ *            - finish() parses the rest, which may lack the last newline.
+ *          the values are given to a handler_t, or build item_t which release() returns.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::stream_parser_t parser;
+ *      while (size_t n = std::fread(buffer, 1, sizeof(buffer), pipe)) {
+ *          parser.feed(tomload::view_t(buffer, n));
+ *      }
+ *      parser.finish();
+ *      tomload::item_t item = parser.release();
+ *
+ *      std::ifstream file("config.toml");
+ *      tomload::item_t config = tomload::parse_stream(file);  // read through a buffer of 64 KiB
+ */
+
+#ifndef TOMLOAD_STREAM_PARSER_H_
+#define TOMLOAD_STREAM_PARSER_H_
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include "tomload/sax.h"
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+class parse_context_t;
+class document_handler_t;
+
+/*
+ * @class stream_parser_t
+ * @brief Incremental parser which accepts a document in chunks.
+ */
+class stream_parser_t {
+ public:
+    /*
+     * @brief Build item_t from the chunks.
+     * @param options[in]: options of parsing. `parse_options_t::lazy_numbers` is ignored,
+     *                     because the chunks are not kept.
+     */
+    explicit stream_parser_t(const parse_options_t& options = parse_options_t{});
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Give the events of the chunks to `handler`.
+     * @param handler[in,out]: receiver of the events, which must outlive this object.
+     *                         the views given to it are valid only in each call.
+     */
+    explicit stream_parser_t(handler_t& handler);
+    /////////////////////////////////////////////////////////////////////////////
+
+    ~stream_parser_t(void);
+    stream_parser_t(const stream_parser_t&) = delete;
+    stream_parser_t& operator=(const stream_parser_t&) = delete;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Give the next chunk of the document.
+     * @param chunk[in]: part of the document. it is not referred to after this call.
+     * @throw parse_error: if a complete statement is ill-formed.
+     * @throw std::logic_error: if finish() is already called.
+     */
+    void feed(view_t chunk);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Parse the rest of the document.
+     * @throw parse_error: if the rest is ill-formed, e.g. a string is not closed.
+     * @throw std::logic_error: if finish() is already called.
+     */
+    void finish(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get the document built.
+     * @throw std::logic_error: if finish() is not called, or this parser gives the events to a handler.
+     */
+    item_t release(void);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Bytes kept for the incomplete statement.
+     */
+    size_t pending(void) const noexcept { return buffer_.size(); }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    enum scan_state_t {
+        SCAN_NORMAL,
+        SCAN_COMMENT,
+        SCAN_BASIC,          // "..."
+        SCAN_LITERAL,        // '...'
+        SCAN_MULTI_BASIC,    // """..."""
+        SCAN_MULTI_LITERAL,  // '''...'''
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    size_t scan(void);
+    void start_line(size_t pos) noexcept;
+    size_t end_line(size_t pos, size_t ret);
+    void parse(size_t size);
+    /////////////////////////////////////////////////////////////////////////////
+
+    parse_options_t options_;
+    std::unique_ptr<item_t> root_;
+    std::unique_ptr<parse_context_t> context_;
+    std::unique_ptr<document_handler_t> document_;
+    handler_t* handler_;
+    bool finished_ = false;
+
+    std::string buffer_;  // incomplete statement and the chunk
+    size_t scanned_ = 0;  // bytes of buffer_ already scanned
+    size_t parsed_ = 0;   // bytes of the document before buffer_
+    scan_state_t state_ = SCAN_NORMAL;
+    size_t depth_ = 0;    // nesting of arrays, inline tables and table headers
+    bool escaped_ = false;
+    size_t line_ = 0;     // beginning of the line in buffer_
+    bool in_value_ = false;  // the line begins in an array or an inline table
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Default size of the buffer which parse_stream() reads into.
+ */
+constexpr size_t default_stream_buffer_size = 64 * 1024;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Parse a document read from `in`, through a buffer of fixed size.
+ * @param in[in,out]: stream of the document. it is read until the end.
+ * @param options[in]: options of parsing. `parse_options_t::lazy_numbers` is ignored.
+ * @param buffer_size[in]: size of the buffer to read into.
+ * @return the document.
+ * @throw parse_error: if the document is ill-formed.
+ * @throw std::ios_base::failure: if reading `in` fails.
+ * @throw std::invalid_argument: if `buffer_size` is 0.
+ */
+item_t parse_stream(std::istream& in, const parse_options_t& options = parse_options_t{},
+                    size_t buffer_size = default_stream_buffer_size);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Give the events of a document read from `in` to `handler`, through a buffer of fixed size.
+ * @param in[in,out]: stream of the document. it is read until the end.
+ * @param handler[in,out]: receiver of the events. the views given to it are valid only in each call.
+ * @param buffer_size[in]: size of the buffer to read into.
+ * @throw parse_error: if the document is ill-formed.
+ * @throw std::ios_base::failure: if reading `in` fails.
+ * @throw std::invalid_argument: if `buffer_size` is 0.
+ */
+void parse_stream(std::istream& in, handler_t& handler, size_t buffer_size = default_stream_buffer_size);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_STREAM_PARSER_H_
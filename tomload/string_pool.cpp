@@ -0,0 +1,61 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/string_pool.cpp
+ * @brief implement tomload::string_pool_t.
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/string_pool.h"
+#include <utility>
+
+namespace tomload {
+
+/*
+ * @brief Get the node which holds the same string as `str`.
+ * @param str[in,out]: string to be interned. moved into a new node when it is not pooled yet.
+ * @return node shared by all strings equal to `str`.
+ */
+node_ptr<text_t> string_pool_t::intern(text_t&& str) {
+    ++requested_;
+
+    // keep load factor under 1/2
+    if ((stored_ + 1) * 2 > slots_.size()) {
+        rehash(slots_.empty() ? 64 : slots_.size() * 2);
+    }
+
+    size_t hash = hash_bytes(to_view(str));
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        slot_t& slot = slots_[i];
+        if (not slot.node) {
+            slot.hash = hash;
+            slot.node = node_ptr<text_t>::make(std::move(str));
+            ++stored_;
+            return slot.node;
+        } else if ((slot.hash == hash) && (*slot.node == str)) {
+            return slot.node;
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void string_pool_t::rehash(size_t capacity) {
+    std::vector<slot_t> old(capacity);
+    std::swap(old, slots_);
+
+    size_t mask = slots_.size() - 1;
+    for (slot_t& slot : old) {
+        if (slot.node) {
+            size_t i = slot.hash & mask;
+            while (slots_[i].node) {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = std::move(slot);
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/string_pool.h
+ * @brief Header file for string_pool_t class.
+ * @details string_pool_t deduplicates identical string values while parsing one document.
+ *          Each distinct string is stored once, and every item_t holding it shares the same node.
+ * @note target version of C++ is C++14.
+ */
+
+#ifndef TOMLOAD_STRING_POOL_H_
+#define TOMLOAD_STRING_POOL_H_
+
+#include <cstddef>
+#include <vector>
+#include "tomload/node_ptr.h"
+#include "tomload/tomload.h"
+
+namespace tomload {
+
+/*
+ * @class string_pool_t
+ * @brief Hash pool of string nodes, used by the parser in `parse_options_t::dedup_strings` mode.
+ * @details open addressing with linear probing. the pool only lives while parsing;
+ *          the interned nodes are kept alive by the items which refer to them.
+ */
+class string_pool_t {
+ public:
+    /*
+     * @brief Get the node which holds the same string as `str`.
+     * @param str[in,out]: string to be interned. moved into a new node when it is not pooled yet.
+     * @return node shared by all strings equal to `str`.
+     */
+    node_ptr<text_t> intern(text_t&& str);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of strings passed to intern().
+     */
+    size_t requested(void) const noexcept { return requested_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Number of distinct strings stored in the pool.
+     */
+    size_t stored(void) const noexcept { return stored_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    void rehash(size_t capacity);
+    /////////////////////////////////////////////////////////////////////////////
+
+    struct slot_t {
+        size_t hash;
+        node_ptr<text_t> node;
+    };
+
+    std::vector<slot_t> slots_;
+    size_t requested_ = 0;
+    size_t stored_ = 0;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_STRING_POOL_H_
@@ -9,9 +9,155 @@
 
 #include "tomload/tomload.h"
 #include "tomload/parser.h"
+#include <cstring>
+#include <unordered_set>
+#include "tomload/detail_number.h"
 
 namespace tomload {
 
+namespace {
+
+// estimated overhead of one std::map node: color and three links of a red-black tree.
+const size_t map_node_overhead = 4 * sizeof(void*);
+
+/*
+ * @brief Add heap bytes of `text` to `payload` and `slack`. nothing is added when it is stored inline.
+ */
+template <typename String>
+void add_text_usage(const String& text, size_t& payload, size_t& slack) {
+    const char* begin = reinterpret_cast<const char*>(&text);
+    if ((text.data() < begin) || (begin + sizeof(text) <= text.data())) {
+        payload += text.size() + 1;
+        slack += text.capacity() - text.size();
+    }
+}
+
+/*
+ * @brief Finalizer of splitmix64, which spreads every input bit to all output bits.
+ */
+uint64_t scramble(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/*
+ * @brief Order dependent combination of hashes.
+ */
+uint64_t combine(uint64_t seed, uint64_t value) noexcept {
+    return scramble(seed + 0x9e3779b97f4a7c15ULL + value);
+}
+
+/*
+ * @brief 64-bit FNV-1a, independent of the size of size_t.
+ */
+uint64_t hash_text(view_t view) noexcept {
+    uint64_t ret = 14695981039346656037ULL;
+    for (char c : view) {
+        ret ^= static_cast<unsigned char>(c);
+        ret *= 1099511628211ULL;
+    }
+    return ret;
+}
+
+/*
+ * @brief Hash of float, where all NaNs are the same, and 0.0 and -0.0 are the same.
+ */
+uint64_t hash_float(float_t d) noexcept {
+    if (std::isnan(d)) {
+        return 0x7ff8000000000000ULL;
+    } else if (d == 0.0) {
+        return 0;
+    }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+/*
+ * @brief Float equality, where NaN equals NaN.
+ */
+bool equal_float(float_t lhs, float_t rhs) noexcept {
+    return (lhs == rhs) || (std::isnan(lhs) && std::isnan(rhs));
+}
+
+/*
+ * @brief Visitor to write item_t in JSON format.
+ */
+struct json_writer_t {
+    std::ostream& os;
+
+    void operator()(boolean_t b) const {
+        os << (b ? "true" : "false");
+    }
+    void operator()(integer_t i) const {
+        os << i;
+    }
+    void operator()(float_t d) const {
+        os << d;
+    }
+    void operator()(view_t str) const {
+        os << '\"';
+        for (char c : str) {
+            if (c == '\"') {
+                os << "\\\"";
+            } else if (c == '\t') {
+                os << "\\t";
+            } else if (c == '\n') {
+                os << "\\n";
+            } else if (c == '\r') {
+                os << "\\r";
+            } else if (c == '\\') {
+                os << "\\\\";
+            } else {
+                os << c;
+            }
+        }
+        os << '\"';
+    }
+    void operator()(const array_range_t& range) const {
+        const char* sep = "";
+        os << '[';
+        for (const auto& i : range) {
+            os << sep;
+            visit(i, *this);
+            sep = ", ";
+        }
+        os << ']';
+    }
+    void operator()(const table_range_t& range) const {
+        const char* sep = "";
+        os << '{';
+        for (const auto& i : range) {
+            os << sep << i.first << ": ";
+            visit(i.second, *this);
+            sep = ", ";
+        }
+        os << '}';
+    }
+};
+
+}  // namespace
+
+/*
+ * @brief Format an error with its line and column, like "line 2, column 5: already reginstered".
+ * @param source[in]: the document.
+ * @param offset[in]: byte offset of the error in `source`, or view_t::npos if it is unknown.
+ * @param message[in]: message of the error.
+ * @return the message with the location, or the message only if `offset` is unknown.
+ */
+std::string format_error(view_t source, size_t offset, const std::string& message) {
+    if (offset == view_t::npos) {
+        return message;
+    }
+    source_location_t location = locate(source, offset);
+    return "line " + std::to_string(location.line) + ", column " + std::to_string(location.column) + ": " + message;
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @brief Constructor that initializes item_t from a view_t which holds TOML raw string.
  * @param view[in]: The view_t object containing raw TOML string.
@@ -22,9 +168,41 @@ namespace tomload {
  * @note Most users must use only this constructor to parse TOML string.
  */
 item_t::item_t(view_t view) :
-    type(TYPE_TABLE),
-    m(std::make_shared<std::map<key_t, item_t>>()) {
-    parse_main(view);
+    item_t(view, parse_options_t{}) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Constructor that initializes item_t from raw TOML string with options.
+ * @param view[in]: The view_t object containing raw TOML string.
+ * @param options[in]: options of parsing.
+ * @throws parse_error: if the view cannot be parsed correctly.
+ */
+item_t::item_t(view_t view, const parse_options_t& options) :
+    item_t(std::vector<view_t>{view}, options) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Constructor that initializes item_t from one TOML document split into pieces.
+ * @param pieces[in]: consecutive parts of the document. each piece must end at the end of a line.
+ * @param options[in]: options of parsing.
+ * @throws parse_error: if the pieces cannot be parsed correctly.
+ * @note the pieces are parsed as if they are concatenated, without copying them.
+ */
+item_t::item_t(const std::vector<view_t>& pieces, const parse_options_t& options) :
+    type(TYPE_TABLE) {
+    resource_scope_t scope(options.resource);
+    new (&m) node_ptr<table_t>(node_ptr<table_t>::make());  // after the scope, which allocates it
+
+    try {
+        parse_context_t context(options);
+        parse_main(pieces, context);
+        context.report();
+    } catch (...) {
+        destroy();  // the destructor does not run for a constructor which throws
+        throw;
+    }
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -64,14 +242,54 @@ item_t::item_t(single_construct_t, float_t val) noexcept :
 }
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Constructor with integer or float, which is converted when it is read first.
+ * @param lazy_construct_t[in]: placeholder.
+ * @param is_float[in]: `token` is float or integer.
+ * @param token[in]: validated decimal integer or float in the source string.
+ * @pre 0 < token.size() <= UINT32_MAX, and the conversion of `token` never fails.
+ */
+item_t::item_t(lazy_construct_t, boolean_t is_float, view_t token) noexcept :
+    type(is_float ? TYPE_FLOAT : TYPE_INTEGER),
+    lazy_length(static_cast<uint32_t>(token.size())) {
+    u.token = token.data();
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @ingroup SingleConstruct
  * @brief Constructor with string.
  * @param single_construct_t[in]: placeholder.
  * @param val[in,out]: input string.
  */
-item_t::item_t(single_construct_t, string_t&& val) noexcept :
+item_t::item_t(single_construct_t, string_t&& val) :
     type(TYPE_STRING),
+    str(val.data(), val.size()) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @ingroup SingleConstruct
+ * @brief Constructor with string, which is held inline.
+ * @param single_construct_t[in]: placeholder.
+ * @param val[in,out]: input string. it is moved into this item.
+ */
+item_t::item_t(single_construct_t, text_t&& val) noexcept :
+    type(TYPE_STRING),
+    str(std::move(val)) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @ingroup SingleConstruct
+ * @brief Constructor with string node, which may be shared with other items.
+ * @param single_construct_t[in]: placeholder.
+ * @param val[in]: node of input string.
+ * @pre static_cast<bool>(val) == true.
+ */
+item_t::item_t(single_construct_t, node_ptr<text_t> val) noexcept :
+    type(TYPE_STRING),
+    pooled(true),
     s(std::move(val)) {
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -80,11 +298,11 @@ item_t::item_t(single_construct_t, string_t&& val) noexcept :
  * @ingroup SingleConstruct
  * @brief Constructor with array.
  * @param single_construct_t[in]: placeholder.
- * @param val[in]: pointer of input array.
+ * @param val[in,out]: input array. its elements are moved into this item.
  */
-item_t::item_t(single_construct_t, std::shared_ptr<std::vector<item_t>> val) noexcept :
+item_t::item_t(single_construct_t, array_t&& val) :
     type(TYPE_ARRAY),
-    v(val) {
+    v(node_ptr<array_t>::make(std::move(val))) {
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -92,11 +310,144 @@ item_t::item_t(single_construct_t, std::shared_ptr<std::vector<item_t>> val) noe
  * @ingroup SingleConstruct
  * @brief Constructor with table.
  * @param single_construct_t[in]: placeholder.
- * @param val[in]: pointer of input table.
+ * @param val[in,out]: input table. its elements are moved into this item.
  */
-item_t::item_t(single_construct_t, std::shared_ptr<std::map<key_t, item_t>> val) noexcept:
+item_t::item_t(single_construct_t, table_t&& val) :
     type(TYPE_TABLE),
-    m(val) {
+    m(node_ptr<table_t>::make(std::move(val))) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @ingroup SingleConstruct
+ * @brief Constructor with array.
+ * @param single_construct_t[in]: placeholder.
+ * @param val[in]: pointer of input array. the array is copied, not shared.
+ * @note kept for compatibility. use the constructor with array_t&& instead.
+ */
+item_t::item_t(single_construct_t, std::shared_ptr<std::vector<item_t>> val) :
+    type(TYPE_ARRAY),
+    v(node_ptr<array_t>::make(val->begin(), val->end())) {
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @ingroup SingleConstruct
+ * @brief Constructor with table.
+ * @param single_construct_t[in]: placeholder.
+ * @param val[in]: pointer of input table. the table is copied, not shared.
+ * @note kept for compatibility. use the constructor with table_t&& instead.
+ */
+item_t::item_t(single_construct_t, std::shared_ptr<std::map<key_t, item_t>> val) :
+    type(TYPE_TABLE),
+    m(node_ptr<table_t>::make()) {
+    table_t& table = m.mutate();
+    for (const auto& i : *val) {
+        table.emplace_hint(table.end(), i.first, i.second);
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t::item_t(const item_t& other) :
+    type(other.type),
+    pooled(other.pooled),
+    lazy_length(other.lazy_length) {
+    construct_from(other);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t::item_t(item_t&& other) noexcept :
+    type(other.type),
+    pooled(other.pooled),
+    lazy_length(other.lazy_length) {
+    construct_from(std::move(other));
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @note `other` may be a descendant of this item, so it is copied before this item is destroyed.
+ */
+item_t& item_t::operator=(const item_t& other) {
+    if (this != &other) {
+        *this = item_t(other);
+    }
+    return *this;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @note `other` may be a descendant of this item, so it is moved out before this item is destroyed.
+ */
+item_t& item_t::operator=(item_t&& other) noexcept {
+    if (this != &other) {
+        item_t tmp(std::move(other));
+        destroy();
+        type = tmp.type;
+        pooled = tmp.pooled;
+        lazy_length = tmp.lazy_length;
+        construct_from(std::move(tmp));
+    }
+    return *this;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+item_t::~item_t(void) {
+    destroy();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre the payload of this item is not alive, and `type` and `pooled` are the same as `other`.
+ */
+void item_t::construct_from(const item_t& other) {
+    if (type == TYPE_STRING) {
+        if (pooled) {
+            new (&s) node_ptr<text_t>(other.s);
+        } else {
+            new (&str) text_t(other.str);
+        }
+    } else if (type == TYPE_ARRAY) {
+        new (&v) node_ptr<array_t>(other.v);
+    } else if ((type == TYPE_TABLE) || (type == TYPE_INLINE_TABLE)) {
+        new (&m) node_ptr<table_t>(other.m);
+    } else {
+        u = other.u;
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @pre the payload of this item is not alive, and `type` and `pooled` are the same as `other`.
+ */
+void item_t::construct_from(item_t&& other) noexcept {
+    if (type == TYPE_STRING) {
+        if (pooled) {
+            new (&s) node_ptr<text_t>(std::move(other.s));
+        } else {
+            new (&str) text_t(std::move(other.str));
+        }
+    } else if (type == TYPE_ARRAY) {
+        new (&v) node_ptr<array_t>(std::move(other.v));
+    } else if ((type == TYPE_TABLE) || (type == TYPE_INLINE_TABLE)) {
+        new (&m) node_ptr<table_t>(std::move(other.m));
+    } else {
+        u = other.u;
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+void item_t::destroy(void) noexcept {
+    if (type == TYPE_STRING) {
+        if (pooled) {
+            s.~node_ptr<text_t>();
+        } else {
+            str.~text_t();
+        }
+    } else if (type == TYPE_ARRAY) {
+        v.~node_ptr<array_t>();
+    } else if ((type == TYPE_TABLE) || (type == TYPE_INLINE_TABLE)) {
+        m.~node_ptr<table_t>();
+    }
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -180,6 +531,9 @@ integer_t item_t::get_integer(void) const {
     if (not is_integer()) {
         throw type_error("type mismatch");
     }
+    if (lazy_length != 0) {
+        resolve_number();
+    }
     return u.i;
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -195,6 +549,9 @@ float_t item_t::get_float(void) const {
     if (not is_float()) {
         throw type_error("type mismatch");
     }
+    if (lazy_length != 0) {
+        resolve_number();
+    }
     return u.d;
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -210,7 +567,8 @@ string_t item_t::get_string(void) const {
     if (not is_string()) {
         throw type_error("type mismatch");
     }
-    return s;
+    view_t text = text_view();
+    return string_t(text.data(), text.size());
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -273,7 +631,11 @@ const item_t& item_t::operator[](size_t index) const {
  */
 const item_t& item_t::operator[](const key_t& key) const {
     if (is_table()) {
-        return m->at(key);
+        table_iterator it = m->find(view_t(key));
+        if (it == m->end()) {
+            throw std::out_of_range("key is not found");
+        }
+        return it->second;
     } else {
         throw type_error("not table");
     }
@@ -289,7 +651,7 @@ const item_t& item_t::operator[](const key_t& key) const {
  */
 bool item_t::contains(const key_t& key) const {
     if (is_table()) {
-        return m->find(key) != m->cend();
+        return m->find(view_t(key)) != m->cend();
     } else {
         throw type_error("not table");
     }
@@ -388,23 +750,302 @@ const table_range_t item_t::table_range(void) const {
 }
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Get heap bytes owned by this item and its descendants.
+ * @return breakdown of the bytes. the item_t object itself is not included,
+ *         because it is a part of the parent container, or owned by the caller.
+ * @note a node shared by several items (a copy, or a pooled string) is counted once.
+ *       the tree is walked without recursion, so the cost is linear in the number of items.
+ */
+memory_usage_t item_t::memory_usage(void) const {
+    memory_usage_t usage;
+    std::unordered_set<const void*> shared;  // shared nodes already counted
+    auto first_visit = [&shared](const void* node, bool unique) {
+        return unique || shared.insert(node).second;
+    };
+
+    std::vector<const item_t*> stack{this};
+    while (not stack.empty()) {
+        const item_t* item = stack.back();
+        stack.pop_back();
+
+        if (item->is_string() && not item->pooled) {
+            add_text_usage(item->str, usage.strings, usage.slack);
+        } else if (item->is_string()) {
+            if (first_visit(item->s.get(), item->s.unique())) {
+                usage.nodes += node_ptr<text_t>::node_size();
+                add_text_usage(*item->s, usage.strings, usage.slack);
+            }
+        } else if (item->is_array()) {
+            if (first_visit(item->v.get(), item->v.unique())) {
+                usage.nodes += node_ptr<array_t>::node_size() + item->v->size() * sizeof(item_t);
+                usage.slack += (item->v->capacity() - item->v->size()) * sizeof(item_t);
+                for (const item_t& child : *item->v) {
+                    stack.push_back(&child);
+                }
+            }
+        } else if (item->is_table()) {
+            if (first_visit(item->m.get(), item->m.unique())) {
+                usage.nodes += node_ptr<table_t>::node_size() +
+                               item->m->size() * (map_node_overhead + sizeof(table_t::value_type));
+                for (const auto& child : *item->m) {
+                    add_text_usage(child.first, usage.keys, usage.slack);
+                    stack.push_back(&child.second);
+                }
+            }
+        }
+    }
+    return usage;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get a new document whose item at `path` is replaced with `value`. this item is not modified.
+ * @param path[in]: keys of tables and indexes of arrays from this item, like {"server", "ports", 0}.
+ *                  a missing key is added, and a missing intermediate table is created.
+ *                  an index equal to the size of array appends to the array.
+ * @param value[in]: new item.
+ * @return new document. only the arrays and tables along `path` are copied.
+ * @throw type_error: if an element of `path` does not match the type of the item.
+ * @throw std::out_of_range: if an index is larger than the size of array.
+ */
+item_t item_t::with(const path_t& path, item_t value) const {
+    // the copy shares every node with this item. mutate() clones the nodes on the path only.
+    item_t ret = *this;
+    item_t* p_item = &ret;
+    for (const path_element_t& element : path) {
+        if (element.is_index()) {
+            if (not p_item->is_array()) {
+                throw type_error("not array");
+            }
+            array_t& array = p_item->v.mutate();
+            if (element.index() < array.size()) {
+                p_item = &array[element.index()];
+            } else if (element.index() == array.size()) {
+                resource_scope_t scope(array.get_allocator().resource());
+                array.push_back(item_t{single_construct, table_t{}});
+                p_item = &array.back();
+            } else {
+                throw std::out_of_range("index is out of range");
+            }
+        } else {
+            if (not p_item->is_table()) {
+                throw type_error("not table");
+            }
+            table_t& table = p_item->m.mutate();
+            const key_t& key = element.key();
+            table_t::iterator it = table.lower_bound(view_t(key));
+            if ((it == table.end()) || (compare_key(to_view(it->first), view_t(key)) != 0)) {
+                resource_scope_t scope(table.get_allocator().resource());
+                it = table.emplace_hint(it, key, item_t{single_construct, table_t{}});
+            }
+            p_item = &it->second;
+        }
+    }
+    *p_item = std::move(value);
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get a new document which is this item overridden by `upper`. this item is not modified.
+ * @param upper[in]: overriding item. tables are merged recursively, and any other value of
+ *                   `upper` replaces the value of this item.
+ * @return new document. only the tables which `upper` overrides are copied.
+ */
+item_t item_t::merged(const item_t& upper) const {
+    item_t ret = *this;
+    merge_into(ret, upper);
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Override `lower` by `upper` in place, for merged().
+ */
+void item_t::merge_into(item_t& lower, const item_t& upper) {
+    if (not lower.is_table() || not upper.is_table()) {
+        lower = upper;
+        return;
+    } else if (lower.m.get() == upper.m.get()) {
+        return;
+    }
+
+    // mutate() clones the table only when it is shared, and the clone shares the children.
+    table_t& table = lower.m.mutate();
+    resource_scope_t scope(table.get_allocator().resource());
+    for (const auto& i : *upper.m) {
+        table_t::iterator it = table.lower_bound(to_view(i.first));
+        if ((it != table.end()) && (compare_key(to_view(it->first), to_view(i.first)) == 0)) {
+            merge_into(it->second, i.second);
+        } else {
+            table.emplace_hint(it, i.first, i.second);
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Structural equality.
+ */
+bool item_t::operator==(const item_t& other) const {
+    if (is_table() != other.is_table()) {
+        return false;
+    } else if (not is_table() && (type != other.type)) {
+        return false;
+    }
+
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return u.b == other.u.b;
+    case TYPE_INTEGER:
+        return get_integer() == other.get_integer();
+    case TYPE_FLOAT:
+        return equal_float(get_float(), other.get_float());
+    case TYPE_STRING:
+        return (pooled && other.pooled && (s.get() == other.s.get())) || (text_view() == other.text_view());
+    case TYPE_ARRAY:
+        if (v.get() == other.v.get()) {
+            return true;
+        } else if ((v->size() != other.v->size()) || (hash() != other.hash())) {
+            return false;
+        }
+        return std::equal(v->begin(), v->end(), other.v->begin());
+    default:
+        if (m.get() == other.m.get()) {
+            return true;
+        } else if ((m->size() != other.m->size()) || (hash() != other.hash())) {
+            return false;
+        }
+        return std::equal(m->begin(), m->end(), other.m->begin(),
+                          [](const table_t::value_type& lhs, const table_t::value_type& rhs) {
+                              return (lhs.first == rhs.first) && (lhs.second == rhs.second);
+                          });
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+bool item_t::operator!=(const item_t& other) const {
+    return not (*this == other);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Structural hash, which is consistent with operator==.
+ * @return 64-bit hash, which does not depend on the process, the platform, or the address.
+ * @note the hash of string, array and table is cached in its node, and reset when it is
+ *       modified, so hashing an unchanged subtree again is O(1).
+ */
+uint64_t item_t::hash(void) const {
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return combine(TYPE_BOOLEAN, u.b ? 1 : 0);
+    case TYPE_INTEGER:
+        return combine(TYPE_INTEGER, static_cast<uint64_t>(get_integer()));
+    case TYPE_FLOAT:
+        return combine(TYPE_FLOAT, hash_float(get_float()));
+    case TYPE_STRING:
+        if (not pooled) {
+            return combine(TYPE_STRING, hash_text(to_view(str)));
+        }
+        break;
+    default:
+        break;
+    }
+
+    uint64_t ret = (type == TYPE_STRING) ? s.cached_hash() :
+                   (type == TYPE_ARRAY) ? v.cached_hash() : m.cached_hash();
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (type == TYPE_STRING) {
+        ret = combine(TYPE_STRING, hash_text(to_view(*s)));
+    } else if (type == TYPE_ARRAY) {
+        ret = combine(TYPE_ARRAY, v->size());
+        for (const item_t& i : *v) {
+            ret = combine(ret, i.hash());
+        }
+    } else {
+        ret = combine(TYPE_TABLE, m->size());
+        for (const auto& i : *m) {
+            ret = combine(combine(ret, hash_text(to_view(i.first))), i.second.hash());
+        }
+    }
+    ret = (ret != 0) ? ret : 1;  // 0 means not cached
+
+    if (type == TYPE_STRING) {
+        s.cache_hash(ret);
+    } else if (type == TYPE_ARRAY) {
+        v.cache_hash(ret);
+    } else {
+        m.cache_hash(ret);
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Copy booleans.
+ */
+void item_t::copy_elements(const item_t* items, size_t n, bool* out, std::true_type) {
+    for (size_t i = 0; i < n; ++i) {
+        if (items[i].type != TYPE_BOOLEAN) {
+            throw type_error((items[0].type == TYPE_BOOLEAN) ? "mixed array" : "type mismatch");
+        }
+        out[i] = items[i].u.b;
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Convert the lazy number and cache it.
+ * @pre lazy_length != 0.
+ */
+void item_t::resolve_number(void) const {
+    view_t token(u.token, lazy_length);
+    if (type == TYPE_INTEGER) {
+        u.i = convert_integer(token, token.size());
+    } else {
+        u.d = convert_float(token, token.size());
+    }
+    lazy_length = 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @brief Construct inline table from multiple keys-value pairs.
  * @param key_vals[in]: keys-value pairs.
  * @throw parse_error: type is not table, or [keys] spot is inappropreate.
  * @note this method is intended to be used in parsing process.
  */
-void item_t::set_inline_table_keys_value(std::vector<std::pair<std::vector<key_t>, item_t>> key_vals) {
+void item_t::set_inline_table_keys_value(std::vector<std::pair<std::vector<text_t>, item_t>> key_vals) {
+    parse_status_t status;
+    set_inline_table_keys_value(std::move(key_vals), status);
+    status.raise();
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Same as set_inline_table_keys_value(key_vals), but the error is recorded in `status`.
+ */
+void item_t::set_inline_table_keys_value(std::vector<std::pair<std::vector<text_t>, item_t>> key_vals,
+                                         parse_status_t& status) {
     if (type != TYPE_TABLE) {
-        throw parse_error("not table");
+        status.fail(PARSE_SYNTAX, "not table");
+        return;
     }
 
-    for (std::pair<std::vector<key_t>, item_t>& key_val : key_vals) {
+    for (std::pair<std::vector<text_t>, item_t>& key_val : key_vals) {
         if (key_val.first.empty()) {
-            throw parse_error("no keys");
+            status.fail(PARSE_SYNTAX, "no keys");
+            return;
         }
 
-        insert_keys_val(this, std::move(key_val.first), key_val.second);
+        insert_keys_val(this, std::move(key_val.first), std::move(key_val.second), status);
+        if (status.failed()) {
+            return;
+        }
     }
 
     type = TYPE_INLINE_TABLE;
@@ -416,61 +1057,75 @@ void item_t::set_inline_table_keys_value(std::vector<std::pair<std::vector<key_t
  * @return A pointer to the inserted `val`. If the `key` is already registered, `val` will not be inserted;
  *         instead, a pointer to the already registered `item_t` is returned.
  */
-item_t* item_t::push(const key_t& key, item_t val) {
+item_t* item_t::push(const text_t& key, item_t val) {
     if (type != TYPE_TABLE) {
         throw parse_error("not table");
     }
-    auto ret = m->insert({key, val});
+    auto ret = m.mutate().emplace(key_t(key.data(), key.size()), std::move(val));
     return &ret.first->second;
 }
 /////////////////////////////////////////////////////////////////////////////
 
 /*
- * @pre brackets_set.empty() == false.
+ * @brief Same as push(key, empty table), but no table is allocated when `key` is already registered.
+ * @throw parse_error: thrown if the this->type is not TYPE_TABLE.
+ * @return A pointer to the inserted or the already registered `item_t`.
  */
-item_t* item_t::insert_brackets_table(const std::vector<std::vector<key_t>>& brackets_set) {
-    if (type == TYPE_INLINE_TABLE) {
-        throw parse_error("inline table error");
+item_t* item_t::push_table(const text_t& key) {
+    if (type != TYPE_TABLE) {
+        throw parse_error("not table");
     }
+    table_t& table = m.mutate();
+    table_t::iterator it = table.lower_bound(to_view(key));
+    if ((it == table.end()) || (compare_key(to_view(it->first), to_view(key)) != 0)) {
+        it = table.emplace_hint(it, key_t(key.data(), key.size()), item_t{single_construct, table_t{}});
+    }
+    return &it->second;
+}
+/////////////////////////////////////////////////////////////////////////////
 
-    std::vector<std::vector<key_t>>::const_iterator begin = brackets_set.cbegin();
-    std::vector<std::vector<key_t>>::const_iterator end = brackets_set.cend() - 1;
-    const std::vector<key_t>& latest = brackets_set.back();
-
-    // check identical bracket is already defined or not
-    if (std::find(begin, end, latest) != end) {
-        throw parse_error("duplicate bracket table");
+/*
+ * @param latest[in]: keys of the latest header, which is checked by table_registry_t::insert_header().
+ * @param super_table[in]: the latest header is a super-table of an earlier header.
+ * @return the table of the latest header, or nullptr if an error is recorded in `status`.
+ * @pre latest.empty() == false.
+ */
+item_t* item_t::insert_brackets_table(const std::vector<text_t>& latest, bool super_table, parse_status_t& status) {
+    if (type == TYPE_INLINE_TABLE) {
+        status.fail(PARSE_REDEFINED_TABLE, "inline table error");
+        return nullptr;
     }
 
     // check the table is already registered or not. super-table is allowed
-    bool super_table = false;
-    for (decltype(begin) it = begin; it != end; ++it) {
-        if ((latest.size() < it->size()) &&
-            std::equal(latest.cbegin(), latest.cend(), it->cbegin())) {
-            super_table = true;
-            break;
-        }
-    }
     if (not super_table) {
-        item_t* p_item = this;
-        std::vector<key_t>::const_iterator it = latest.cbegin();
+        const item_t* p_item = this;
+        std::vector<text_t>::const_iterator it = latest.cbegin();
         for (; it != latest.cend(); ++it) {
-            if (not (p_item->is_table() && p_item->contains(*it))) {
+            if (not p_item->is_table()) {
                 break;
             }
-            p_item = &(p_item->m->find(*it)->second);
+            table_iterator found = p_item->m->find(to_view(*it));
+            if (found == p_item->m->end()) {
+                break;
+            }
+            p_item = &found->second;
         }
         if (it == latest.cend()) {
-            throw parse_error("the table already registered");
+            status.fail(PARSE_REDEFINED_TABLE, "the table already registered");
+            return nullptr;
         }
     }
 
     item_t* p_item = this;
-    for (const key_t& key : latest) {
-        auto next_table = item_t{single_construct, std::make_shared<std::map<key_t, item_t>>()};
-        p_item = p_item->push(key, next_table);
+    for (const text_t& key : latest) {
+        if (p_item->type != TYPE_TABLE) {  // push_table() would throw
+            status.fail(PARSE_REDEFINED_TABLE, "not table");
+            return nullptr;
+        }
+        p_item = p_item->push_table(key);
         if (not p_item->is_table()) {
-            throw parse_error("expected table");
+            status.fail(PARSE_REDEFINED_TABLE, "expected table");
+            return nullptr;
         }
     }
     return p_item;
@@ -480,26 +1135,32 @@ item_t* item_t::insert_brackets_table(const std::vector<std::vector<key_t>>& bra
 /*
  * @pre p_item != nullptr.
  */
-void item_t::insert_keys_val(item_t* p_item, std::vector<key_t> keys, item_t val) {
+void item_t::insert_keys_val(item_t* p_item, std::vector<text_t> keys, item_t val, parse_status_t& status) {
     if (p_item == nullptr) {
-        throw parse_error("unknown error");
+        status.fail(PARSE_SYNTAX, "unknown error");
+        return;
     }
     if (type == TYPE_INLINE_TABLE) {
-        throw parse_error("inline table error");
+        status.fail(PARSE_DUPLICATE_KEY, "inline table error");
+        return;
     }
 
-    for (const key_t& key : keys) {
-        if (&key != &keys.back()) {
-            auto next_table = item_t{single_construct, std::make_shared<std::map<key_t, item_t>>()};
-            p_item = p_item->push(key, next_table);
+    for (const text_t& key : keys) {
+        if (p_item->type != TYPE_TABLE) {  // push_table() and push() would throw
+            status.fail(PARSE_DUPLICATE_KEY, "not table");
+            return;
+        } else if (&key != &keys.back()) {
+            p_item = p_item->push_table(key);
             if (not p_item->is_table()) {
-                throw parse_error("expected table");
+                status.fail(PARSE_DUPLICATE_KEY, "expected table");
+                return;
             }
         } else {
-            if (not p_item->contains(key)) {
-                p_item = p_item->push(key, val);
+            if (p_item->m->find(to_view(key)) == p_item->m->end()) {
+                p_item = p_item->push(key, std::move(val));
             } else {
-                throw parse_error("already reginstered");
+                status.fail(PARSE_DUPLICATE_KEY, "already reginstered");
+                return;
             }
         }
     }
@@ -508,51 +1169,11 @@ void item_t::insert_keys_val(item_t* p_item, std::vector<key_t> keys, item_t val
 
 /*
  * @param view[in,out]: toml string.
+ * @param context[in,out]: options and working state of parsing.
  */
-void item_t::parse_main(view_t& view) {
-    check_control_character(view);  // may throw
-
-    std::vector<std::vector<key_t>> brackets_set;
-    item_t* p_brackets_end = this;
-
-    skip_space(view, " \t\r\n", true);
-    while (not view.empty()) {
-        if (starts_with(view, "[")) {  // parse "[brackets]" line
-            view.remove_prefix(1);
-            std::vector<key_t> brackets = parse_keys(view);
-
-            skip_space(view, " \t", false);
-            if (starts_with(view, "]")) {
-                brackets_set.push_back(std::move(brackets));
-                p_brackets_end = insert_brackets_table(brackets_set);
-                view.remove_prefix(1);
-            } else {
-                throw parse_error("expected ']'");
-            }
-        } else {  // parse "key = value" line
-            std::vector<key_t> keys = parse_keys(view);
-
-            skip_space(view, " \t", false);
-            if (starts_with(view, "=")) {
-                view.remove_prefix(1);
-            } else {
-                throw parse_error("expected '='");
-            }
-
-            check_duplex_keys(keys, brackets_set);
-
-            skip_space(view, " \t", false);
-            insert_keys_val(p_brackets_end, std::move(keys), parse_item(view));
-        }
-
-        // wait new line (allow end of text)
-        if (wait_newline(view)) {
-        } else {
-            throw parse_error("expected newline");
-        }
-
-        skip_space(view, " \t\r\n", true);
-    }
+void item_t::parse_main(const std::vector<view_t>& pieces, parse_context_t& context) {
+    document_handler_t handler(this, context);
+    parse_events(pieces, handler);
 }
 /////////////////////////////////////////////////////////////////////////////
 
@@ -564,51 +1185,12 @@ void item_t::parse_main(view_t& view) {
  * @return `os`
  */
 std::ostream& operator<<(std::ostream& os, const item_t& item) {
-    if (item.is_array()) {
-        std::string sep = "";
-        os << '[';
-        for (const auto& i : item.array_range()) {
-            os << sep << i;
-            sep = ", ";
-        }
-        os << ']';
-    } else  if (item.is_table()) {
-        std::string sep = "";
-        os << '{';
-        for (const auto& i : item.table_range()) {
-            os << sep << i.first << ": " << i.second;
-            sep = ", ";
-        }
-        os << '}';
-    } else if (item.is_boolean()) {
-        os << (item.get_boolean() ? "true" : "false");
-    } else if (item.is_integer()) {
-        os << item.get_integer();
-    } else if (item.is_float()) {
-        os << item.get_float();
-    } else if (item.is_string()) {
-        os << '\"';
-        for (char c : item.get_string()) {
-            if (c == '\"') {
-                os << "\\\"";
-            } else if (c == '\t') {
-                os << "\\t";
-            } else if (c == '\n') {
-                os << "\\n";
-            } else if (c == '\r') {
-                os << "\\r";
-            } else if (c == '\\') {
-                os << "\\\\";
-            } else {
-                os << c;
-            }
-        }
-        os << '\"';
-    }
+    visit(item, json_writer_t{os});
     return os;
 }
 /////////////////////////////////////////////////////////////////////////////
 
+
 /*
  * @ingroup Getters
  * @brief This is the template specialization when PARAM is string_t.
@@ -616,7 +1198,8 @@ std::ostream& operator<<(std::ostream& os, const item_t& item) {
 template <>
 bool item_t::get<string_t>(string_t& val) const {
     if (is_string()) {
-        val = s;
+        view_t text = text_view();
+        val.assign(text.data(), text.size());
     } else {
         return false;
     }
@@ -30,8 +30,10 @@
 #define TOMLOAD_TOMLOAD_H_
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <exception>
+#include <limits>
 #include <map>
 #include <memory>
 #include <ostream>
@@ -39,10 +41,23 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "tomload/memory_resource.h"
+#include "tomload/node_ptr.h"
 #include "tomload/view_t.h"
 
 namespace tomload {
 
+/*
+ * @brief Format an error with its line and column, like "line 2, column 5: already reginstered".
+ * @param source[in]: the document.
+ * @param offset[in]: byte offset of the error in `source`, or view_t::npos if it is unknown.
+ * @param message[in]: message of the error.
+ * @return the message with the location, or the message only if `offset` is unknown.
+ * @note the location is computed by this call, so recording the offset costs nothing until then.
+ */
+std::string format_error(view_t source, size_t offset, const std::string& message);
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @class parse_error
  * @brief Exception class for parsing errors.
@@ -53,6 +68,124 @@ class parse_error : public std::runtime_error {
     explicit parse_error(const std::string& what_arg) :
         runtime_error(what_arg) {
     }
+
+    /*
+     * @param offset[in]: byte offset in the document where the error is detected.
+     */
+    parse_error(const std::string& what_arg, size_t offset) :
+        runtime_error(what_arg),
+        offset_(offset) {
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Byte offset in the document where the error is detected, or view_t::npos if it is unknown.
+     * @note the document is the string given to item_t, or the pieces concatenated.
+     */
+    size_t offset(void) const noexcept { return offset_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Line and column of the error, which are computed by this call.
+     * @param source[in]: the document.
+     */
+    source_location_t locate(view_t source) const noexcept { return tomload::locate(source, offset_); }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Same as format_error(source, offset(), what()).
+     */
+    std::string format(view_t source) const { return format_error(source, offset_, what()); }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    size_t offset_ = view_t::npos;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @enum parse_errc_t
+ * @brief Category of a parse error.
+ */
+enum parse_errc_t {
+    PARSE_OK = 0,
+    PARSE_SYNTAX,             // ill-formed statement, key, array or inline table.
+    PARSE_STRING,             // ill-formed string or escape sequence.
+    PARSE_NUMBER,             // ill-formed integer or float.
+    PARSE_OUT_OF_RANGE,       // integer or float which does not fit in integer_t or float_t.
+    PARSE_CONTROL_CHARACTER,  // disallowed control character or single CR.
+    PARSE_DUPLICATE_KEY,      // key defined twice, or a key which extends a value.
+    PARSE_REDEFINED_TABLE,    // table defined twice, or a table which extends an inline table.
+    PARSE_TOO_DEEP,           // arrays and inline tables nested deeper than the limit.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class parse_status_t
+ * @brief The first error of parsing, which the parser passes along instead of throwing.
+ * @details recording an error costs no allocation: the message is a string literal, and the
+ *          position is a pointer into the source.
+ */
+class parse_status_t {
+ public:
+    bool failed(void) const noexcept { return code_ != PARSE_OK; }
+    parse_errc_t code(void) const noexcept { return code_; }
+    const char* message(void) const noexcept { return message_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Where the error is detected in the source, or nullptr if it is not known.
+     */
+    const char* where(void) const noexcept { return where_; }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Record an error. the first error is kept.
+     * @param code[in]: category of the error.
+     * @param message[in]: string literal, which is the message of parse_error.
+     * @param where[in]: where the error is detected, or nullptr to be located by the caller.
+     */
+    void fail(parse_errc_t code, const char* message, const char* where = nullptr) noexcept {
+        if (not failed()) {
+            code_ = code;
+            message_ = message;
+            where_ = where;
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Set the position of the error if it is not known yet.
+     */
+    void locate(const char* where) noexcept {
+        if (failed() && (where_ == nullptr)) {
+            where_ = where;
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void reset(void) noexcept { *this = parse_status_t(); }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Throw the error, if any.
+     * @param begin[in]: top of the source which the offset of parse_error is measured from,
+     *                   or nullptr if the offset is not needed.
+     * @param preceding[in]: bytes of the document before `begin`.
+     * @throw parse_error: if an error is recorded.
+     */
+    void raise(const char* begin = nullptr, size_t preceding = 0) const {
+        if (failed()) {
+            bool located = (begin != nullptr) && (where_ != nullptr);
+            throw parse_error(message_, located ? preceding + static_cast<size_t>(where_ - begin) : view_t::npos);
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    parse_errc_t code_ = PARSE_OK;
+    const char* message_ = "";
+    const char* where_ = nullptr;
 };
 /////////////////////////////////////////////////////////////////////////////
 
@@ -93,18 +226,157 @@ class range_t {
 /////////////////////////////////////////////////////////////////////////////
 
 class item_t;
+class parse_context_t;
+class document_handler_t;
 using boolean_t = bool;
 using integer_t = int64_t;
 using float_t = double;
 using string_t = std::string;
 using key_t = std::string;
-using array_iterator = std::vector<item_t>::const_iterator;
-using table_iterator = std::map<key_t, item_t>::const_iterator;
+using text_t = std::basic_string<char, std::char_traits<char>, allocator_t<char>>;  // stored keys and strings
+
+/*
+ * @brief Get view_t of stored key or string.
+ */
+inline view_t to_view(const text_t& text) noexcept {
+    return view_t(text.data(), text.size());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Get view_t of table key.
+ */
+inline view_t to_view(const key_t& key) noexcept {
+    return view_t(key.data(), key.size());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Compare keys in the same order as std::string.
+ * @return negative, zero or positive like std::string::compare().
+ */
+inline int compare_key(view_t lhs, view_t rhs) noexcept {
+    int ret = std::char_traits<char>::compare(lhs.data(), rhs.data(), (std::min)(lhs.size(), rhs.size()));
+    if (ret != 0) {
+        return ret;
+    }
+    return (lhs.size() < rhs.size()) ? -1 : (lhs.size() > rhs.size()) ? 1 : 0;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct key_compare_t
+ * @brief Transparent comparator of table keys, which allows lookup by view_t without allocation.
+ */
+struct key_compare_t {
+    using is_transparent = void;
+
+    bool operator()(const key_t& lhs, const key_t& rhs) const noexcept { return compare_key(to_view(lhs), to_view(rhs)) < 0; }
+    bool operator()(const key_t& lhs, view_t rhs) const noexcept { return compare_key(to_view(lhs), rhs) < 0; }
+    bool operator()(view_t lhs, const key_t& rhs) const noexcept { return compare_key(lhs, to_view(rhs)) < 0; }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+using array_t = std::vector<item_t, allocator_t<item_t>>;
+// the key of table is key_t, so that table_iterator gives std::string keys. the nodes are allocated
+// through allocator_t, but a key longer than the small buffer of std::string is on the default heap.
+using table_t = std::map<key_t, item_t, key_compare_t, allocator_t<std::pair<const key_t, item_t>>>;
+using array_iterator = array_t::const_iterator;
+using table_iterator = table_t::const_iterator;
 using array_range_t = range_t<array_iterator>;
 using table_range_t = range_t<table_iterator>;
 static_assert(sizeof(long long) == sizeof(integer_t), "sizeof(long long) must be 8");
 struct single_construct_t { explicit single_construct_t() = default; };
 constexpr single_construct_t single_construct;
+struct lazy_construct_t { explicit lazy_construct_t() = default; };
+constexpr lazy_construct_t lazy_construct;
+
+/*
+ * @struct parse_stats_t
+ * @brief Statistics reported by parsing, see `parse_options_t::stats`.
+ */
+struct parse_stats_t {
+    size_t strings = 0;         // number of string values in the document.
+    size_t unique_strings = 0;  // number of string values actually stored.
+
+    /*
+     * @brief strings / unique_strings. 1.0 means no string is shared.
+     */
+    double dedup_ratio(void) const noexcept {
+        return (unique_strings != 0) ? static_cast<double>(strings) / static_cast<double>(unique_strings) : 1.0;
+    }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Default of parse_options_t::max_depth and handler_t::max_depth().
+ */
+constexpr size_t DEFAULT_MAX_DEPTH = 1000;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct parse_options_t
+ * @brief Options of parsing.
+ */
+struct parse_options_t {
+    // identical string values share one storage through a per-document hash pool.
+    bool dedup_strings = false;
+    // when not nullptr, statistics of parsing are written to it.
+    parse_stats_t* stats = nullptr;
+    // when not nullptr, every container, node and string of the document is allocated from it.
+    // keys longer than the small buffer of std::string are on the default heap.
+    // the resource must outlive the document.
+    memory_resource* resource = nullptr;
+    // integers and floats are validated while parsing, but converted on the first get_integer(),
+    // get_float() or get<T>(), and the result is cached.
+    // the source string must outlive the document until all numbers needed are read.
+    // the first read of a number is not thread-safe; read it before sharing the document among threads.
+    bool lazy_numbers = false;
+    // maximum nesting of arrays and inline tables. a deeper value is an error of PARSE_TOO_DEEP.
+    // the parser keeps its stack usage constant at any depth, but item_t is destroyed, copied,
+    // compared and written recursively, so the default keeps them within the stack.
+    size_t max_depth = DEFAULT_MAX_DEPTH;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct memory_usage_t
+ * @brief Heap bytes owned by a document or a subtree, see `item_t::memory_usage()`.
+ * @note map node overhead is estimated as a red-black tree node of the usual layout,
+ *       and short keys and strings stored inline (small string optimization) cost no heap bytes.
+ */
+struct memory_usage_t {
+    size_t nodes = 0;    // string, array and table nodes, array elements and table entries.
+    size_t keys = 0;     // heap payload of keys.
+    size_t strings = 0;  // heap payload of string values.
+    size_t slack = 0;    // reserved but unused capacity of arrays, keys and strings.
+
+    size_t total(void) const noexcept { return nodes + keys + strings + slack; }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class path_element_t
+ * @brief One step of a path in a document: a key of table, or an index of array.
+ */
+class path_element_t {
+ public:
+    path_element_t(const char* key) : key_(key) {}              // NOLINT: implicit for {"a", 0, "b"}
+    path_element_t(const key_t& key) : key_(key) {}             // NOLINT
+    path_element_t(size_t index) : is_index_(true), index_(index) {}  // NOLINT
+    path_element_t(int index) : is_index_(true), index_(static_cast<size_t>(index)) {}  // NOLINT: for literal 0
+
+    bool is_index(void) const noexcept { return is_index_; }
+    size_t index(void) const noexcept { return index_; }
+    const key_t& key(void) const noexcept { return key_; }
+
+ private:
+    bool is_index_ = false;
+    size_t index_ = 0;
+    key_t key_;
+};
+using path_t = std::vector<path_element_t>;
+/////////////////////////////////////////////////////////////////////////////
 
 /**
  * @class item_t
@@ -121,6 +393,17 @@ class item_t {
     item_t(void) = delete;  // Default constructor is deleted.
     /////////////////////////////////////////////////////////////////////////////
 
+    /*
+     * @brief Copy and move. the payload is a union, so its active member is copied or moved.
+     * @note copying shares the nodes of array, table and pooled string, and copies an inline string.
+     */
+    item_t(const item_t& other);
+    item_t(item_t&& other) noexcept;
+    item_t& operator=(const item_t& other);
+    item_t& operator=(item_t&& other) noexcept;
+    ~item_t(void);
+    /////////////////////////////////////////////////////////////////////////////
+
     /*
      * @brief Constructor that initializes item_t from raw TOML string.
      * @param view[in]: The view_t object containing raw TOML string.
@@ -133,6 +416,25 @@ class item_t {
     explicit item_t(view_t view);
     /////////////////////////////////////////////////////////////////////////////
 
+    /*
+     * @brief Constructor that initializes item_t from raw TOML string with options.
+     * @param view[in]: The view_t object containing raw TOML string.
+     * @param options[in]: options of parsing.
+     * @throws parse_error: if the view cannot be parsed correctly.
+     */
+    item_t(view_t view, const parse_options_t& options);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Constructor that initializes item_t from one TOML document split into pieces.
+     * @param pieces[in]: consecutive parts of the document. each piece must end at the end of a line.
+     * @param options[in]: options of parsing.
+     * @throws parse_error: if the pieces cannot be parsed correctly.
+     * @note the pieces are parsed as if they are concatenated, without copying them.
+     */
+    item_t(const std::vector<view_t>& pieces, const parse_options_t& options);
+    /////////////////////////////////////////////////////////////////////////////
+
     /**
      * @defgroup SingleConstruct Constructors with Single Element
      * @brief A set of constructors used to create item_t with single element.
@@ -173,25 +475,75 @@ class item_t {
      * @param single_construct_t[in]: placeholder.
      * @param val[in]: pointer of input array.
      */
-    item_t(single_construct_t, string_t&& val) noexcept;
+    item_t(single_construct_t, string_t&& val);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @ingroup SingleConstruct
+     * @brief Constructor with string, which is held inline.
+     * @param single_construct_t[in]: placeholder.
+     * @param val[in,out]: input string. it is moved into this item.
+     */
+    item_t(single_construct_t, text_t&& val) noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @ingroup SingleConstruct
+     * @brief Constructor with string node, which may be shared with other items.
+     * @param single_construct_t[in]: placeholder.
+     * @param val[in]: node of input string.
+     * @pre static_cast<bool>(val) == true.
+     */
+    item_t(single_construct_t, node_ptr<text_t> val) noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @ingroup SingleConstruct
+     * @brief Constructor with array.
+     * @param single_construct_t[in]: placeholder.
+     * @param val[in,out]: input array. its elements are moved into this item.
+     */
+    item_t(single_construct_t, array_t&& val);
     /////////////////////////////////////////////////////////////////////////////
 
     /*
      * @ingroup SingleConstruct
      * @brief Constructor with table.
      * @param single_construct_t[in]: placeholder.
-     * @param val[in]: pointer of input table.
+     * @param val[in,out]: input table. its elements are moved into this item.
+     */
+    item_t(single_construct_t, table_t&& val);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @ingroup SingleConstruct
+     * @brief Constructor with array.
+     * @param single_construct_t[in]: placeholder.
+     * @param val[in]: pointer of input array. the array is copied, not shared.
+     * @note kept for compatibility. use the constructor with array_t&& instead.
      */
-    item_t(single_construct_t, std::shared_ptr<std::vector<item_t>> val) noexcept;
+    item_t(single_construct_t, std::shared_ptr<std::vector<item_t>> val);
     /////////////////////////////////////////////////////////////////////////////
 
     /*
      * @ingroup SingleConstruct
      * @brief Constructor with table.
      * @param single_construct_t[in]: placeholder.
-     * @param val[in]: pointer of input table.
+     * @param val[in]: pointer of input table. the table is copied, not shared.
+     * @note kept for compatibility. use the constructor with table_t&& instead.
      */
-    item_t(single_construct_t, std::shared_ptr<std::map<key_t, item_t>> val) noexcept;
+    item_t(single_construct_t, std::shared_ptr<std::map<key_t, item_t>> val);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Constructor with integer or float, which is converted when it is read first.
+     * @param lazy_construct_t[in]: placeholder.
+     * @param is_float[in]: `token` is float or integer.
+     * @param token[in]: validated decimal integer or float in the source string.
+     * @pre 0 < token.size() <= UINT32_MAX, and the conversion of `token` never fails.
+     * @note this constructor is intended to be used in parsing process.
+     */
+    item_t(lazy_construct_t, boolean_t is_float, view_t token) noexcept;
     /////////////////////////////////////////////////////////////////////////////
 
     /**
@@ -409,44 +761,179 @@ class item_t {
     const table_range_t table_range(void) const;
     /////////////////////////////////////////////////////////////////////////////
 
+    /*
+     * @brief Get heap bytes owned by this item and its descendants.
+     * @return breakdown of the bytes. the item_t object itself is not included,
+     *         because it is a part of the parent container, or owned by the caller.
+     * @note a node shared by several items (a copy, or a pooled string) is counted once.
+     *       the tree is walked without recursion, so the cost is linear in the number of items.
+     */
+    memory_usage_t memory_usage(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get a new document whose item at `path` is replaced with `value`. this item is not modified.
+     * @param path[in]: keys of tables and indexes of arrays from this item, like {"server", "ports", 0}.
+     *                  a missing key is added, and a missing intermediate table is created.
+     *                  an index equal to the size of array appends to the array.
+     * @param value[in]: new item.
+     * @return new document. only the arrays and tables along `path` are copied, and the other
+     *         subtrees are shared with this item, so the cost depends on the depth of `path`
+     *         and the sizes of the containers on it, not on the size of the whole document.
+     * @throw type_error: if an element of `path` does not match the type of the item.
+     * @throw std::out_of_range: if an index is larger than the size of array.
+     */
+    item_t with(const path_t& path, item_t value) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Get a new document which is this item overridden by `upper`. this item is not modified.
+     * @param upper[in]: overriding item. tables are merged recursively, and any other value of
+     *                   `upper` replaces the value of this item.
+     * @return new document. only the tables which `upper` overrides are copied, so the cost depends
+     *         on the size of `upper` and the tables it touches, not on the size of this item.
+     */
+    item_t merged(const item_t& upper) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Call `visitor` with the typed value of this item. the type is checked only once.
+     * @param visitor[in]: callable which accepts each of boolean_t, integer_t, float_t,
+     *                     view_t (string), array_range_t, and table_range_t.
+     *                     all of them must return the same type.
+     * @return return value of `visitor`.
+     * @note same as tomload::visit(item, visitor).
+     */
+    template <typename VISITOR>
+    decltype(auto) visit(VISITOR&& visitor) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Structural equality.
+     * @details items are equal when they have the same type and value, recursively:
+     *            - integer and float are different types, so 1 != 1.0,
+     *            - table and inline table are the same type,
+     *            - floats are compared by value, except that NaN equals NaN regardless of
+     *              its sign and payload, so that equality is reflexive. 0.0 equals -0.0,
+     *            - tables are compared by keys and values, not by the order of definition.
+     *          shared nodes are equal without comparing, and arrays or tables with different
+     *          hashes are unequal without comparing their elements.
+     */
+    bool operator==(const item_t& other) const;
+    bool operator!=(const item_t& other) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Structural hash, which is consistent with operator==.
+     * @return 64-bit hash, which does not depend on the process, the platform, or the address.
+     * @note the hash of string, array and table is cached in its node, and reset when it is
+     *       modified, so hashing an unchanged subtree again is O(1).
+     */
+    uint64_t hash(void) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Copy the elements of array into `out`. the types of the elements are checked at once.
+     * @param out[out]: buffer of at least `n` elements.
+     * @param n[in]: size of `out`.
+     * @return number of the copied elements, min(n, size()).
+     * @throw type_error: if the type is not array, the elements have different types,
+     *                    or the elements cannot be converted to T.
+     * @throw std::out_of_range: if an element overflows T.
+     * @tparam T: bool for array of booleans. integral or floating point types for array of integers.
+     *            floating point types for array of floats.
+     * @note the types are checked and the elements are converted in one pass.
+     *       the contents of `out` are unspecified when an exception is thrown.
+     */
+    template <typename T>
+    size_t copy_to(T* out, size_t n) const;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Copy the elements of array into `out`, which is resized to size().
+     * @param out[out]: destination.
+     * @throw type_error: if the type is not array, the elements have different types,
+     *                    or the elements cannot be converted to T.
+     * @throw std::out_of_range: if an element overflows T.
+     * @tparam T: same as copy_to(T*, size_t), except bool.
+     * @note `out` is not modified when an exception is thrown.
+     */
+    template <typename T, typename A>
+    void copy_to(std::vector<T, A>& out) const;
+    /////////////////////////////////////////////////////////////////////////////
+
     /*
      * @brief Construct inline table from multiple keys-value pairs.
      * @param key_vals[in]: keys-value pairs.
      * @throw parse_error: type is not table, or [keys] spot is inappropreate.
      * @note this method is intended to be used in parsing process.
      */
-    void set_inline_table_keys_value(std::vector<std::pair<std::vector<key_t>, item_t>> key_vals);
+    void set_inline_table_keys_value(std::vector<std::pair<std::vector<text_t>, item_t>> key_vals);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Same as set_inline_table_keys_value(key_vals), but the error is recorded in `status`.
+     */
+    void set_inline_table_keys_value(std::vector<std::pair<std::vector<text_t>, item_t>> key_vals,
+                                     parse_status_t& status);
     /////////////////////////////////////////////////////////////////////////////
 
  private:
+    friend class document_handler_t;  // inserts the parsed values
+
     /*
      * @throw parse_error: thrown if the this->type is not TYPE_TABLE.
      * @return A pointer to the inserted `val`. If the `key` is already registered, `val` will not be inserted;
      *         instead, a pointer to the already registered `item_t` is returned.
      */
-    item_t* push(const key_t& key, item_t val);
+    item_t* push(const text_t& key, item_t val);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Same as push(key, empty table), but no table is allocated when `key` is already registered.
+     * @throw parse_error: thrown if the this->type is not TYPE_TABLE.
+     * @return A pointer to the inserted or the already registered `item_t`.
+     */
+    item_t* push_table(const text_t& key);
     /////////////////////////////////////////////////////////////////////////////
 
     /*
-     * @pre brackets_set.empty() == false.
+     * @param latest[in]: keys of the latest header, which is checked by table_registry_t::insert_header().
+     * @param super_table[in]: the latest header is a super-table of an earlier header.
+     * @return the table of the latest header, or nullptr if an error is recorded in `status`.
+     * @pre latest.empty() == false.
      */
-    item_t* insert_brackets_table(const std::vector<std::vector<key_t>>& brackets_set);
+    item_t* insert_brackets_table(const std::vector<text_t>& latest, bool super_table, parse_status_t& status);
     /////////////////////////////////////////////////////////////////////////////
 
     /*
     * @pre p_item != nullptr.
     */
-    void insert_keys_val(item_t* p_item, std::vector<key_t> keys, item_t val);
+    void insert_keys_val(item_t* p_item, std::vector<text_t> keys, item_t val, parse_status_t& status);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @param pieces[in]: toml string split at the end of lines.
+     * @param context[in,out]: options and working state of parsing.
+     */
+    void parse_main(const std::vector<view_t>& pieces, parse_context_t& context);
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Convert the lazy number and cache it.
+     * @pre lazy_length != 0.
+     */
+    void resolve_number(void) const;
     /////////////////////////////////////////////////////////////////////////////
 
     /*
-     * @param view[in,out]: toml string.
+     * @brief Override `lower` by `upper` in place, for merged().
      */
-    void parse_main(view_t& view);
+    static void merge_into(item_t& lower, const item_t& upper);
     /////////////////////////////////////////////////////////////////////////////
 
  private:
-    enum type_t : int {
+    enum type_t : uint8_t {
         TYPE_BOOLEAN = 0,
         TYPE_INTEGER,
         TYPE_FLOAT,
@@ -455,17 +942,57 @@ class item_t {
         TYPE_TABLE,
         TYPE_INLINE_TABLE,
     } type;
+    // the string is held by the node `s`, which is shared with other items through the pool of
+    // `parse_options_t::dedup_strings`, or by `str` in this item.
+    bool pooled = false;
+    // length of the source token of a lazy number, or 0 when the number is already converted.
+    // it is placed in the padding after `type`, so the size of item_t does not change.
+    mutable uint32_t lazy_length = 0;
 
-    union {
+    union scalar_t {
         boolean_t b;
         integer_t i;
         float_t d;
-    } u = {false};
-    // to keep source code clean, string, array and table are not in union.
-    // if you want to use union, you can use std::variant instead, but it requires C++17.
-    string_t s;
-    std::shared_ptr<std::vector<item_t>> v;
-    std::shared_ptr<std::map<key_t, item_t>> m;
+        const char* token;  // lazy number
+    };
+    // only the member of `type` is alive, which the special members construct, copy and destroy.
+    // array and table are copy-on-write nodes: copying item_t shares them, and they are
+    // cloned before modification only when they are shared.
+    // a string is held inline as before, unless it is pooled, which needs a shared node.
+    union {
+        mutable scalar_t u = {false};
+        text_t str;
+        node_ptr<text_t> s;
+        node_ptr<array_t> v;
+        node_ptr<table_t> m;
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief The string value, inline or pooled.
+     * @pre type == TYPE_STRING.
+     */
+    view_t text_view(void) const noexcept { return to_view(pooled ? *s : str); }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Construct the payload from `other`, or destroy the payload.
+     * @pre the payload of this item is not alive for construct_from().
+     */
+    void construct_from(const item_t& other);
+    void construct_from(item_t&& other) noexcept;
+    void destroy(void) noexcept;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Copy elements of array, for copy_to().
+     * @pre 0 < n <= the number of `items`.
+     */
+    template <typename T>
+    static void copy_elements(const item_t* items, size_t n, T* out, std::true_type /*integral*/);
+    template <typename T>
+    static void copy_elements(const item_t* items, size_t n, T* out, std::false_type /*floating point*/);
+    static void copy_elements(const item_t* items, size_t n, bool* out, std::true_type /*integral*/);
     /////////////////////////////////////////////////////////////////////////////
 };
 /////////////////////////////////////////////////////////////////////////////
@@ -488,6 +1015,172 @@ template <>
 bool item_t::get<string_t>(string_t& val) const;
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * @brief Call `visitor` with the typed value of this item. the type is checked only once.
+ * @param visitor[in]: callable which accepts each of boolean_t, integer_t, float_t,
+ *                     view_t (string), array_range_t, and table_range_t.
+ *                     all of them must return the same type.
+ * @return return value of `visitor`.
+ */
+template <typename VISITOR>
+decltype(auto) item_t::visit(VISITOR&& visitor) const {
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return std::forward<VISITOR>(visitor)(u.b);
+    case TYPE_INTEGER:
+        if (lazy_length != 0) {
+            resolve_number();
+        }
+        return std::forward<VISITOR>(visitor)(u.i);
+    case TYPE_FLOAT:
+        if (lazy_length != 0) {
+            resolve_number();
+        }
+        return std::forward<VISITOR>(visitor)(u.d);
+    case TYPE_STRING:
+        return std::forward<VISITOR>(visitor)(text_view());
+    case TYPE_ARRAY:
+        return std::forward<VISITOR>(visitor)(array_range_t(v->begin(), v->end()));
+    default:
+        return std::forward<VISITOR>(visitor)(table_range_t(m->begin(), m->end()));
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Copy the elements of array into `out`. the types of the elements are checked at once.
+ * @param out[out]: buffer of at least `n` elements.
+ * @param n[in]: size of `out`.
+ * @return number of the copied elements, min(n, size()).
+ * @throw type_error: if the type is not array, the elements have different types,
+ *                    or the elements cannot be converted to T.
+ * @throw std::out_of_range: if an element overflows T.
+ * @note the contents of `out` are unspecified when an exception is thrown.
+ */
+template <typename T>
+size_t item_t::copy_to(T* out, size_t n) const {
+    static_assert(std::is_arithmetic<T>::value, "T must be bool, integral or floating point type");
+    if (not is_array()) {
+        throw type_error("not array");
+    }
+
+    n = (std::min)(n, v->size());
+    if (n != 0) {
+        copy_elements(v->data(), n, out, typename std::is_integral<T>::type());
+    }
+    return n;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Copy the elements of array into `out`, which is resized to size().
+ * @param out[out]: destination.
+ * @throw type_error: if the type is not array, the elements have different types,
+ *                    or the elements cannot be converted to T.
+ * @throw std::out_of_range: if an element overflows T.
+ */
+template <typename T, typename A>
+void item_t::copy_to(std::vector<T, A>& out) const {
+    static_assert(not std::is_same<T, bool>::value, "use copy_to(bool*, size_t) for booleans");
+    if (not is_array()) {
+        throw type_error("not array");
+    }
+
+    std::vector<T, A> ret(v->size(), T(), out.get_allocator());
+    copy_to(ret.data(), ret.size());
+    out.swap(ret);
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Copy integers into integral type. the range is checked once after the copy.
+ */
+template <typename T>
+void item_t::copy_elements(const item_t* items, size_t n, T* out, std::true_type) {
+    integer_t low = 0;
+    integer_t high = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const item_t& item = items[i];
+        if (item.type != TYPE_INTEGER) {
+            throw type_error((items[0].type == TYPE_INTEGER) ? "mixed array" : "type mismatch");
+        }
+        if (item.lazy_length != 0) {
+            item.resolve_number();
+        }
+        integer_t x = item.u.i;
+        low = (x < low) ? x : low;
+        high = (high < x) ? x : high;
+        out[i] = static_cast<T>(x);
+    }
+
+    using limits = std::numeric_limits<T>;
+    bool fits = std::is_signed<T>::value ?
+                ((static_cast<integer_t>(limits::min()) <= low) && (high <= static_cast<integer_t>(limits::max()))) :
+                ((0 <= low) && (static_cast<uint64_t>(high) <= static_cast<uint64_t>(limits::max())));
+    if (not fits) {
+        throw std::out_of_range("overflow");
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Copy integers or floats into floating point type. overflow of a narrower type is checked.
+ */
+template <typename T>
+void item_t::copy_elements(const item_t* items, size_t n, T* out, std::false_type) {
+    const type_t type = items[0].type;
+    if ((type != TYPE_INTEGER) && (type != TYPE_FLOAT)) {
+        throw type_error("type mismatch");
+    }
+
+    bool overflow = false;
+    for (size_t i = 0; i < n; ++i) {
+        const item_t& item = items[i];
+        if (item.type != type) {
+            throw type_error("mixed array");
+        }
+        if (item.lazy_length != 0) {
+            item.resolve_number();
+        }
+        if (type == TYPE_INTEGER) {
+            out[i] = static_cast<T>(item.u.i);
+        } else {
+            // a finite value beyond the range of the narrower type is checked before the
+            // conversion, which is undefined for it.
+            const long double max = static_cast<long double>((std::numeric_limits<T>::max)());
+            if ((std::fabs(static_cast<long double>(item.u.d)) > max) && not std::isinf(item.u.d)) {
+                overflow = true;
+                continue;
+            }
+            out[i] = static_cast<T>(item.u.d);
+        }
+    }
+    if (overflow) {
+        throw std::out_of_range("overflow");
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Call `visitor` with the typed value of `item`. the type is checked only once.
+ * @param item[in]: item to be visited.
+ * @param visitor[in]: callable which accepts each of boolean_t, integer_t, float_t,
+ *                     view_t (string), array_range_t, and table_range_t.
+ *                     all of them must return the same type.
+ * @return return value of `visitor`.
+ * @example
+ *      struct counter_t {
+ *          size_t operator()(boolean_t) const { return 1; }
+ *          ...
+ *          size_t operator()(const array_range_t& r) const { size_t n = 1; for (auto& i : r) n += visit(i, *this); return n; }
+ *      };
+ */
+template <typename VISITOR>
+decltype(auto) visit(const item_t& item, VISITOR&& visitor) {
+    return item.visit(std::forward<VISITOR>(visitor));
+}
+/////////////////////////////////////////////////////////////////////////////
+
 /*
  * @ingroup Getters
  * @brief Getter of param[out] version. supported types are boolean, integer, float, and string.
@@ -498,6 +1191,10 @@ bool item_t::get<string_t>(string_t& val) const;
  */
 template <class PARAM>
 bool item_t::get(PARAM& val) const {
+    if (lazy_length != 0) {
+        resolve_number();
+    }
+
     if (std::is_same<PARAM, boolean_t>() && is_boolean()) {
         val = u.b;
     } else if (std::is_same<PARAM, integer_t>() && is_integer()) {
@@ -522,4 +1219,19 @@ bool item_t::get(PARAM& val) const {
 
 }  // namespace tomload
 
+namespace std {
+
+/*
+ * @brief Hash of item_t for unordered containers.
+ */
+template <>
+struct hash<tomload::item_t> {
+    size_t operator()(const tomload::item_t& item) const {
+        return static_cast<size_t>(item.hash());
+    }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace std
+
 #endif  // TOMLOAD_TOMLOAD_H_
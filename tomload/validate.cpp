@@ -0,0 +1,408 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/validate.cpp
+ * @brief implement tomload::validate() and tomload::lint().
+ * @note target version of C++ is C++14.
+ */
+
+#include "tomload/validate.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "tomload/detail_number.h"
+#include "tomload/detail_string.h"
+#include "tomload/parser.h"
+#include "tomload/sax.h"
+
+namespace tomload {
+
+namespace {
+
+/*
+ * @enum shape_t
+ * @brief What a path of the document is, which is all the duplication checks need.
+ */
+enum shape_t {
+    SHAPE_TABLE,         // table by a header, a dotted key or implicitly. it accepts more keys.
+    SHAPE_INLINE_TABLE,  // inline table. it accepts no more keys.
+    SHAPE_VALUE,         // any other value, including array.
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @class validator_t
+ * @brief Handler of parse_events() which follows the rules of item_t without building it.
+ * @details the rules are those of item_t::insert_brackets_table(), item_t::insert_keys_val()
+ *          and table_registry_t, applied to the shapes of the paths instead of the items.
+ *          a path is numbered by the order of registration, and found by its parent and its last key.
+ */
+class validator_t : public handler_t {
+ public:
+    validator_t(void) :
+        scopes_(1) {
+        scopes_.front().reset(false);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_table_header(std::vector<text_t>& latest) override {
+        scope_t& scope = scopes_.front();
+
+        // check the table is already registered or not. super-table is allowed
+        bool super_table = tables_.insert_header(latest, status());
+        if (status().failed()) {
+            return;
+        } else if (not super_table) {
+            uint32_t path = ROOT;
+            std::vector<text_t>::const_iterator it = latest.cbegin();
+            for (; (it != latest.cend()) && (scope.shapes[path] != SHAPE_VALUE); ++it) {
+                registry_t::const_iterator found = scope.registry.find(path_child_t{path, to_view(*it)});
+                if (found == scope.registry.end()) {
+                    break;
+                }
+                path = found->second;
+            }
+            if (it == latest.cend()) {
+                status().fail(PARSE_REDEFINED_TABLE, "the table already registered");
+                return;
+            }
+        }
+
+        scope.base = ROOT;
+        for (const text_t& key : latest) {
+            scope.base = push_table(scope, scope.base, text_t(key), PARSE_REDEFINED_TABLE);
+            if (status().failed()) {
+                return;
+            }
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_key_value(std::vector<text_t>& keys) override {
+        if (depth_ == 0) {
+            tables_.check_dotted_keys(keys, status());
+            if (status().failed()) {
+                return;
+            }
+        }
+
+        scope_t& scope = scopes_[depth_];
+        uint32_t path = scope.base;
+        for (size_t i = 0; i + 1 < keys.size(); ++i) {
+            path = push_table(scope, path, std::move(keys[i]), PARSE_DUPLICATE_KEY);
+            if (status().failed()) {
+                return;
+            }
+        }
+        if (scope.registry.find(path_child_t{path, to_view(keys.back())}) != scope.registry.end()) {
+            status().fail(PARSE_DUPLICATE_KEY, "already reginstered");
+            return;
+        } else if (scope.shapes[path] != SHAPE_TABLE) {
+            status().fail(PARSE_DUPLICATE_KEY, "not table");
+            return;
+        }
+        scope.value = insert(scope, path, std::move(keys.back()), SHAPE_VALUE);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_array_begin(void) override {
+        enter(true);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_array_end(void) override {
+        --depth_;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_inline_table_begin(void) override {
+        enter(false);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_inline_table_end(void) override {
+        --depth_;
+        scope_t& scope = scopes_[depth_];
+        if (not scope.is_array) {
+            scope.shapes[scope.value] = SHAPE_INLINE_TABLE;
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_escaped_string(view_t raw) override {
+        validate_escapes(raw, status());
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    void on_number(view_t token, bool is_float) override {
+        // the conversion is needed only to find out of range, as lazy numbers of item_t.
+        parse_status_t& status = this->status();
+        if (is_float) {
+            validate_float(token, token.size(), status);
+            if (not status.failed() && not is_float_in_range(token, token.size())) {
+                convert_float(token, token.size(), status);
+            }
+        } else {
+            validate_integer(token, token.size(), status);
+            if (not status.failed() && not is_integer_in_range(token, token.size())) {
+                convert_integer(token, token.size(), status);
+            }
+        }
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Go on after an error: close the arrays and the inline tables, and clear the status.
+     */
+    void recover(void) {
+        depth_ = 0;
+        status().reset();
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+ private:
+    using registry_t = std::unordered_map<path_child_t, uint32_t, path_child_hash_t>;  // path to its number
+    static constexpr uint32_t ROOT = 0;
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @struct scope_t
+     * @brief The document, an array or an inline table under construction.
+     */
+    struct scope_t {
+        bool is_array = false;
+        std::vector<shape_t> shapes;  // shape of each path. the root is the table of the scope.
+        registry_t registry;
+        std::deque<text_t> keys;      // keys which the registry refers to. a deque does not move them.
+        uint32_t base = ROOT;         // path of the table which receives the key-value pairs
+        uint32_t value = ROOT;        // path of the value under construction
+
+        void reset(bool array) {
+            is_array = array;
+            shapes.assign(1, SHAPE_TABLE);
+            registry.clear();
+            keys.clear();
+            base = ROOT;
+            value = ROOT;
+        }
+    };
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Start an array or an inline table. the scopes are reused, so are their buffers.
+     */
+    void enter(bool is_array) {
+        ++depth_;
+        if (depth_ == scopes_.size()) {
+            scopes_.emplace_back();
+        }
+        scopes_[depth_].reset(is_array);
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Register a new path, whose last key is `key` under `parent`.
+     * @return number of the path.
+     */
+    uint32_t insert(scope_t& scope, uint32_t parent, text_t&& key, shape_t shape) {
+        uint32_t ret = static_cast<uint32_t>(scope.shapes.size());
+        scope.keys.push_back(std::move(key));
+        scope.shapes.push_back(shape);
+        scope.registry.emplace(path_child_t{parent, to_view(scope.keys.back())}, ret);
+        return ret;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    /*
+     * @brief Same as item_t::push_table() for the table at `parent`.
+     * @param code[in]: category of the error, which depends on the caller.
+     * @return number of the table, or ROOT if an error is recorded in status().
+     */
+    uint32_t push_table(scope_t& scope, uint32_t parent, text_t&& key, parse_errc_t code) {
+        if (scope.shapes[parent] != SHAPE_TABLE) {
+            status().fail(code, "not table");
+            return ROOT;
+        }
+        registry_t::const_iterator found = scope.registry.find(path_child_t{parent, to_view(key)});
+        uint32_t ret = (found != scope.registry.end()) ? found->second : insert(scope, parent, std::move(key), SHAPE_TABLE);
+        if (scope.shapes[ret] == SHAPE_VALUE) {
+            status().fail(code, "expected table");
+            return ROOT;
+        }
+        return ret;
+    }
+    /////////////////////////////////////////////////////////////////////////////
+
+    std::deque<scope_t> scopes_;  // the document, and the arrays and inline tables. a deque does not move them.
+    size_t depth_ = 0;
+    table_registry_t tables_;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Skip to the next line which starts a statement.
+ * @param view[in,out]: toml string from the error. it starts with the statement after the call,
+ *                      or it is empty.
+ * @param header[in]: skip to the next table header.
+ */
+void resync(view_t& view, bool header) {
+    while (not view.empty()) {
+        view_t::size_type pos = view.find('\n');
+        if (pos == view_t::npos) {
+            view = view_t();
+            return;
+        }
+        view.remove_prefix(pos + 1);
+        skip_space(view, " \t", false);
+        if (starts_statement(view, header)) {
+            return;
+        }
+    }
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Find the end of the multi-line string which contains an error, so lint() does not resume
+ *        at the lines in it.
+ * @param view[in]: the document.
+ * @param begin[in]: position of the statement which has the error.
+ * @param offset[in]: position of the error.
+ * @return position just after the string, or `offset` if the error is not in a multi-line string.
+ */
+size_t skip_multi_line_string(view_t view, size_t begin, size_t offset) {
+    for (size_t pos = begin; (pos <= offset) && (pos < view.size()); ) {
+        char c = view[pos];
+        if ((c == '"') || (c == '\'')) {
+            bool multi = starts_with(view.substr(pos), (c == '"') ? "\"\"\"" : "'''");
+            size_t end = skip_string(view, pos);
+            if (offset < end) {
+                return multi ? end : offset;
+            }
+            pos = end;
+        } else if (c == '#') {
+            pos = view.find('\n', pos);
+            pos = (pos != view_t::npos) ? pos : view.size();
+        } else {
+            ++pos;
+        }
+    }
+    return offset;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Make an error of validate_result_t.
+ */
+validate_result_t make_error(parse_errc_t code, size_t offset, const char* message) {
+    validate_result_t ret;
+    ret.valid = false;
+    ret.code = code;
+    ret.offset = offset;
+    ret.message = message;
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace
+
+/*
+ * @brief Check a TOML document without building item_t.
+ * @param view[in]: raw TOML string.
+ * @return valid, or the first error. a document is valid if and only if item_t accepts it.
+ */
+validate_result_t validate(view_t view) {
+    validator_t validator;
+    parse_status_t& status = validator.status();
+    check_control_character(view, status);
+    if (not status.failed()) {
+        view_t rest = view;
+        parse_statements(rest, validator);
+    }
+
+    validate_result_t ret;
+    if (status.failed()) {
+        ret.valid = false;
+        ret.code = status.code();
+        ret.offset = static_cast<size_t>(status.where() - view.data());
+        ret.message = status.message();
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check a TOML document without building item_t, and report all the errors.
+ * @param view[in]: raw TOML string.
+ * @param max_errors[in]: upper bound of the reported errors.
+ * @return the errors. the first one is the same as validate() if the document has no control character.
+ */
+lint_result_t lint(view_t view, size_t max_errors) {
+    lint_result_t ret;
+    if (max_errors == 0) {
+        ret.truncated = not validate(view).valid;
+        return ret;
+    }
+
+    // control characters, which the statements do not check
+    std::vector<validate_result_t>& errors = ret.errors;
+    for (size_t pos = 0; ; ) {
+        parse_status_t control;
+        check_control_character(view.substr(pos), control);
+        if (not control.failed()) {
+            break;
+        } else if (errors.size() == max_errors) {
+            ret.truncated = true;
+            break;
+        }
+        pos = static_cast<size_t>(control.where() - view.data());
+        errors.push_back(make_error(control.code(), pos, control.message()));
+        ++pos;
+    }
+    size_t controls = errors.size();
+
+    // statements, resumed after each error
+    validator_t validator;
+    parse_status_t& status = validator.status();
+    view_t rest = view;
+    skip_space(rest, " \t\r\n", true);
+    while (not rest.empty()) {
+        if (errors.size() - controls == max_errors) {
+            ret.truncated = true;
+            break;
+        }
+        bool header = starts_with(rest, "[");
+        size_t begin = static_cast<size_t>(rest.data() - view.data());
+        if (parse_statement(rest, validator)) {
+            skip_space(rest, " \t\r\n", true);
+            continue;
+        }
+
+        size_t offset = static_cast<size_t>(status.where() - view.data());
+        std::vector<validate_result_t>::const_iterator control = std::lower_bound(
+            errors.cbegin(), errors.cbegin() + controls, offset,
+            [](const validate_result_t& lhs, size_t rhs) { return lhs.offset < rhs; });
+        if ((control == errors.cbegin() + controls) || (control->offset != offset)) {  // not at a control character
+            errors.push_back(make_error(status.code(), offset, status.message()));
+        }
+        rest = view.substr(skip_multi_line_string(view, begin, offset));
+        resync(rest, header);
+        validator.recover();
+    }
+
+    // merge the two sorted lists
+    std::inplace_merge(errors.begin(), errors.begin() + controls, errors.end(),
+                       [](const validate_result_t& lhs, const validate_result_t& rhs) { return lhs.offset < rhs.offset; });
+    if (errors.size() > max_errors) {
+        errors.resize(max_errors);
+        ret.truncated = true;
+    }
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
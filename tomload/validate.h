@@ -0,0 +1,95 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file tomload/validate.h
+ * @brief Header file for validation of TOML documents.
+ * @details validate() checks a document as strictly as item_t does, but builds nothing:
+ *            - the syntax is checked by parse_events(),
+ *            - escape sequences of strings are checked without unescaping,
+ *            - numbers are checked without conversion, unless they may be out of range,
+ *            - redefined tables and duplicated keys are detected by a registry of the paths of
+ *              the tables and the keys, which holds no values. an inline table or an array is
+ *              checked in its own scope, which is dropped after its end.
+ *          the first error is returned instead of thrown, and no exception is used to report it.
+ *          lint() goes on after an error and reports every error of the document in one pass:
+ *            - control characters are found by a scan of the whole document, apart from the syntax,
+ *            - after an error, the statements are resumed at the next line which starts a statement,
+ *              a table header or a key followed by '='. after an error in a table header, they are
+ *              resumed at the next table header, since its key-value pairs have no table. the lines
+ *              in a multi-line string which has the error are skipped.
+ *            - the registry is kept, so redefinitions are checked against the statements before and
+ *              after an error. an array or an inline table which has an error is dropped.
+ *          up to `max_errors` are reported, and the rest of the document is not checked.
+ * @note target version of C++ is C++14.
+ * @example
+ *      tomload::validate_result_t result = tomload::validate("a = 1\na = 2\n");
+ *      if (not result) {
+ *          std::cerr << result.offset << ": " << result.message;  // => "10: already reginstered"
+ *      }
+ *      for (const tomload::validate_result_t& e : tomload::lint(src).errors) {
+ *          std::cerr << tomload::format_error(src, e.offset, e.message.c_str()) << std::endl;
+ *      }
+ */
+
+#ifndef TOMLOAD_VALIDATE_H_
+#define TOMLOAD_VALIDATE_H_
+
+#include <string>
+#include <vector>
+#include "tomload/tomload.h"
+#include "tomload/view_t.h"
+
+namespace tomload {
+
+/*
+ * @struct validate_result_t
+ * @brief Result of validate().
+ */
+struct validate_result_t {
+    bool valid = true;
+    parse_errc_t code = PARSE_OK;  // category of the first error.
+    size_t offset = 0;             // byte offset where the first error is detected.
+    std::string message;           // message of the first error. see validate() for parse_error::what().
+
+    explicit operator bool(void) const noexcept { return valid; }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check a TOML document without building item_t.
+ * @param view[in]: raw TOML string.
+ * @return valid, or the first error. a document is valid if and only if item_t accepts it.
+ * @note the message and the offset are the same as parse_error of item_t, unless the code is
+ *       PARSE_DUPLICATE_KEY or PARSE_REDEFINED_TABLE. a conflict in an inline table is detected as
+ *       soon as its key is read, while item_t detects it when the table is merged. so the offset
+ *       is at or before the one of parse_error, and the message may differ.
+ */
+validate_result_t validate(view_t view);
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct lint_result_t
+ * @brief Result of lint().
+ */
+struct lint_result_t {
+    std::vector<validate_result_t> errors;  // every error, in the order of the offsets.
+    bool truncated = false;                 // true if the check stopped at `max_errors`.
+
+    explicit operator bool(void) const noexcept { return errors.empty(); }
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Check a TOML document without building item_t, and report all the errors.
+ * @param view[in]: raw TOML string.
+ * @param max_errors[in]: upper bound of the reported errors.
+ * @return the errors. the first one is at the same offset as validate() if the document has no
+ *         control character.
+ */
+lint_result_t lint(view_t view, size_t max_errors = 100);
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace tomload
+
+#endif  // TOMLOAD_VALIDATE_H_
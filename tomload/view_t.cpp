@@ -9,6 +9,11 @@
 
 #include "tomload/view_t.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TOMLOAD_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace tomload {
 
 /* 
@@ -65,4 +70,65 @@ bool contains(view_t view, std::initializer_list<const char*> list) {
 }
 /////////////////////////////////////////////////////////////////////////////
 
+/* 
+ * @brief Hash value of bytes in `view` (64-bit FNV-1a when size_t is 64-bit).
+ */
+size_t hash_bytes(view_t view) noexcept {
+    const bool is_64bit = (sizeof(size_t) >= 8);
+    size_t hash = is_64bit ? static_cast<size_t>(14695981039346656037ULL) : static_cast<size_t>(2166136261UL);
+    const size_t prime = is_64bit ? static_cast<size_t>(1099511628211ULL) : static_cast<size_t>(16777619UL);
+    for (char c : view) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= prime;
+    }
+    return hash;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Count '\n' in `view`, 16 bytes at a time where SSE2 is available.
+ */
+size_t count_newlines(view_t view) noexcept {
+    const char* p = view.data();
+    const char* end = p + view.size();
+    size_t ret = 0;
+#if defined(TOMLOAD_HAS_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        // each byte lane counts up to 255 matches, and then the lanes are summed up.
+        size_t blocks = std::min(static_cast<size_t>(end - p) / 16, static_cast<size_t>(255));
+        __m128i counts = _mm_setzero_si128();
+        for (size_t i = 0; i < blocks; ++i, p += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(bytes, newline));  // a match is -1
+        }
+        __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        ret += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+    }
+#endif
+    ret += static_cast<size_t>(std::count(p, end, '\n'));
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Compute the line and the column of the byte at `offset` in `source`.
+ * @param source[in]: the whole text.
+ * @param offset[in]: byte offset in `source`, or view_t::npos if it is unknown.
+ * @return location of the byte, or {0, 0} if `offset` is view_t::npos.
+ *         an offset past the end is located at the end.
+ */
+source_location_t locate(view_t source, size_t offset) noexcept {
+    source_location_t ret;
+    if (offset == view_t::npos) {
+        return ret;
+    }
+    view_t prefix = source.substr(0, offset);
+    view_t::size_type lf_pos = prefix.rfind('\n');
+    ret.line = count_newlines(prefix) + 1;
+    ret.column = prefix.size() - ((lf_pos != view_t::npos) ? lf_pos + 1 : 0) + 1;
+    return ret;
+}
+/////////////////////////////////////////////////////////////////////////////
+
 }  // namespace tomload
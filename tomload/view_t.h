@@ -13,6 +13,7 @@
 #define TOMLOAD_VIEW_T_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <string_view14.hpp>
 
 namespace tomload {
@@ -56,6 +57,38 @@ bool ends_with(view_t view, std::initializer_list<const char*> list);
 bool contains(view_t view, std::initializer_list<const char*> list);
 /////////////////////////////////////////////////////////////////////////////
 
+/* 
+ * @brief Hash value of bytes in `view` (64-bit FNV-1a when size_t is 64-bit).
+ */
+size_t hash_bytes(view_t view) noexcept;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Count '\n' in `view`, 16 bytes at a time where SSE2 is available.
+ */
+size_t count_newlines(view_t view) noexcept;
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @struct source_location_t
+ * @brief Line and column of a byte in a text, both 1-based. the column counts bytes.
+ */
+struct source_location_t {
+    size_t line = 0;    // 0 if the location is unknown.
+    size_t column = 0;
+};
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * @brief Compute the line and the column of the byte at `offset` in `source`.
+ * @param source[in]: the whole text.
+ * @param offset[in]: byte offset in `source`, or view_t::npos if it is unknown.
+ * @return location of the byte, or {0, 0} if `offset` is view_t::npos.
+ *         an offset past the end is located at the end.
+ */
+source_location_t locate(view_t source, size_t offset) noexcept;
+/////////////////////////////////////////////////////////////////////////////
+
 }  // namespace tomload
 
 #endif  // TOMLOAD_VIEW_T_H_
@@ -7,6 +7,9 @@
  * @note target version of C++ is C++14. 
  */
 
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 #include <doctest/doctest.h>
 #include "tomload/tomload.h"
 
@@ -324,3 +327,101 @@ TEST_CASE("testing table item accessors") {
     CHECK_THROWS_AS(item.array_end(), tomload::type_error&);
     CHECK_THROWS_AS(item.array_range(), tomload::type_error&);
 }
+
+TEST_CASE("testing item_t copy and move") {
+    tomload::array_t array;
+    array.push_back(item_t{tomload::single_construct, static_cast<tomload::integer_t>(1)});
+    array.push_back(item_t{tomload::single_construct, tomload::string_t("abc")});
+    tomload::table_t table;
+    table.emplace("array", item_t{tomload::single_construct, std::move(array)});
+    item_t item{tomload::single_construct, std::move(table)};
+
+    CHECK(item.size() == 1);
+    CHECK(item["array"].size() == 2);
+    CHECK(item["array"][0].get_integer() == 1);
+    CHECK(item["array"][1].get_string() == "abc");
+
+    // copy shares the nodes instead of duplicating them.
+    item_t copied = item;
+    CHECK(&copied["array"] == &item["array"]);
+    CHECK(&copied["array"][1] == &item["array"][1]);
+
+    // move keeps the nodes.
+    const item_t* p_element = &item["array"][0];
+    item_t moved = std::move(copied);
+    CHECK(&moved["array"][0] == p_element);
+    CHECK(moved["array"][0].get_integer() == 1);
+}
+
+TEST_CASE("testing item_t::with()") {
+    const item_t item("title = \"a\"\n[server]\nports = [80, 443]\n[server.tls]\ncert = \"a.pem\"\n[client]\nretry = 3\n");
+
+    item_t updated = item.with({"server", "ports", 1}, item_t{tomload::single_construct, static_cast<tomload::integer_t>(8443)});
+    CHECK(updated["server"]["ports"][1].get_integer() == 8443);
+    CHECK(item["server"]["ports"][1].get_integer() == 443);
+
+    // untouched subtrees are shared, and the path is copied.
+    CHECK(&updated["client"]["retry"] == &item["client"]["retry"]);
+    CHECK(&updated["server"]["tls"]["cert"] == &item["server"]["tls"]["cert"]);
+    CHECK(&updated["server"]["ports"][0] != &item["server"]["ports"][0]);
+
+    // add keys, intermediate tables, and array elements.
+    item_t added = updated.with({"server", "ports", 2}, item_t{tomload::single_construct, static_cast<tomload::integer_t>(9000)})
+                          .with({"new", "nested", "key"}, item_t{tomload::single_construct, true});
+    CHECK(added["server"]["ports"].size() == 3);
+    CHECK(added["server"]["ports"][2].get_integer() == 9000);
+    CHECK(added["new"]["nested"]["key"].get_boolean() == true);
+    CHECK(updated.contains("new") == false);
+    CHECK(updated["server"]["ports"].size() == 2);
+
+    // replace the whole document, or a subtree.
+    CHECK(item.with({}, item_t{tomload::single_construct, false}).get_boolean() == false);
+    item_t replaced = item.with({"server"}, item_t{tomload::single_construct, tomload::string_t("none")});
+    CHECK(replaced["server"].get_string() == "none");
+    CHECK(replaced["title"].get_string() == "a");
+
+    CHECK_THROWS_AS(item.with({"title", "x"}, item), tomload::type_error&);
+    CHECK_THROWS_AS(item.with({"server", 0}, item), tomload::type_error&);
+    CHECK_THROWS_AS(item.with({"server", "ports", "x"}, item), tomload::type_error&);
+    CHECK_THROWS_AS(item.with({"server", "ports", 3}, item), std::out_of_range&);
+}
+
+TEST_CASE("testing item_t::copy_to()") {
+    const item_t item("i = [1, -2, 300]\nf = [0.5, 1e300]\nb = [true, false]\nm = [1, 2.5]\ne = []\ns = [\"a\"]\n");
+
+    std::vector<int> ints;
+    item["i"].copy_to(ints);
+    CHECK(ints == std::vector<int>{1, -2, 300});
+    std::vector<double> doubles;
+    item["i"].copy_to(doubles);
+    CHECK(doubles == std::vector<double>{1.0, -2.0, 300.0});
+    item["f"].copy_to(doubles);
+    CHECK(doubles == std::vector<double>{0.5, 1e300});
+    item["e"].copy_to(doubles);
+    CHECK(doubles.empty() == true);
+
+    bool bools[3] = {false, true, true};
+    CHECK(item["b"].copy_to(bools, 3) == 2);
+    CHECK(bools[0] == true);
+    CHECK(bools[1] == false);
+    CHECK(bools[2] == true);
+    int64_t partial[2] = {0, 0};
+    CHECK(item["i"].copy_to(partial, 2) == 2);
+    CHECK(partial[1] == -2);
+
+    // overflow and type errors
+    int8_t narrow[3] = {7, 7, 7};
+    CHECK_THROWS_AS(item["i"].copy_to(narrow, 3), std::out_of_range&);
+    CHECK(item["i"].copy_to(narrow, 2) == 2);
+    CHECK(narrow[1] == -2);
+    std::vector<unsigned> unsigneds;
+    CHECK_THROWS_AS(item["i"].copy_to(unsigneds), std::out_of_range&);
+    std::vector<float> floats;
+    CHECK_THROWS_AS(item["f"].copy_to(floats), std::out_of_range&);
+    CHECK_THROWS_AS(item["f"].copy_to(ints), tomload::type_error&);
+    CHECK_THROWS_AS(item["m"].copy_to(doubles), tomload::type_error&);
+    CHECK_THROWS_AS(item["s"].copy_to(doubles), tomload::type_error&);
+    CHECK_THROWS_AS(item["b"].copy_to(ints), tomload::type_error&);
+    CHECK_THROWS_AS(item.copy_to(ints), tomload::type_error&);
+    CHECK(ints == std::vector<int>{1, -2, 300});
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_builder.cpp
+ * @brief testing tomload::builder_t and monotonic_resource_t using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <doctest/doctest.h>
+#include "tomload/builder.h"
+#include "tomload/tomload.h"
+
+using tomload::builder_t;
+using tomload::item_t;
+
+TEST_CASE("testing tomload::builder_t") {
+    builder_t root = builder_t::make_table();
+    builder_t ports = root.make_child_array();
+    ports.reserve(2).emplace_back(80).emplace_back(443);
+    builder_t tls = root.make_child_table();
+    tls.emplace("cert", std::string("a.pem")).emplace("enabled", true);
+    root.emplace("name", "frontend")
+        .emplace("ports", std::move(ports))
+        .emplace("ratio", 0.5)
+        .emplace("tls", std::move(tls))
+        .emplace("copied", item_t{tomload::single_construct, static_cast<tomload::integer_t>(7)});
+    CHECK(root.size() == 5);
+    item_t item = std::move(root).build();
+
+    std::ostringstream built;
+    built << item;
+    std::ostringstream parsed;
+    parsed << item_t("name = \"frontend\"\nports = [80, 443]\nratio = 0.5\ntls = { cert = \"a.pem\", enabled = true }\ncopied = 7\n");
+    CHECK(built.str() == parsed.str());
+    CHECK(item["ports"][1].get_integer() == 443);
+    CHECK(item["tls"]["enabled"].get_boolean() == true);
+
+    builder_t table = builder_t::make_table();
+    table.emplace("a", 1);
+    CHECK_THROWS_AS(table.emplace("a", 2), std::invalid_argument&);
+    CHECK_THROWS_AS(table.emplace_back(1), tomload::type_error&);
+    builder_t array = builder_t::make_array();
+    CHECK_THROWS_AS(array.emplace("a", 1), tomload::type_error&);
+    CHECK(std::move(array).build().empty() == true);
+}
+
+TEST_CASE("testing tomload::monotonic_resource_t") {
+    tomload::monotonic_resource_t arena(64);
+    {
+        builder_t root = builder_t::make_table(&arena);
+        for (int i = 0; i < 1000; ++i) {
+            std::string key = "key" + std::to_string(1000 + i);
+            root.emplace(key, "a string value which is not in small buffer " + key);
+        }
+        item_t item = std::move(root).build();
+        CHECK(item.size() == 1000);
+        CHECK(item["key1999"].get_string() == "a string value which is not in small buffer key1999");
+
+        // items allocated from an arena can be updated.
+        item_t updated = item.with({"key1000"}, item_t{tomload::single_construct, false});
+        CHECK(updated["key1000"].get_boolean() == false);
+    }
+    arena.release();
+
+    // alignment
+    void* p1 = arena.allocate(1, 1);
+    void* p2 = arena.allocate(8, 8);
+    void* p3 = arena.allocate(100000, 16);
+    CHECK(p1 != p2);
+    CHECK(reinterpret_cast<uintptr_t>(p2) % 8 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(p3) % 16 == 0);
+}
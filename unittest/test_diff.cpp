@@ -0,0 +1,248 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_diff.cpp
+ * @brief testing tomload::diff() using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/diff.h"
+#include "tomload/tomload.h"
+
+using tomload::change_t;
+using tomload::item_t;
+
+namespace {
+
+/*
+ * @brief Minimal JSON reader for the round trip of to_json_patch(). it throws on any ill-formed JSON.
+ */
+class json_reader_t {
+ public:
+    explicit json_reader_t(const std::string& src) : src_(src) {}
+
+    item_t read_document(void) {
+        item_t ret = read_value();
+        skip_space();
+        expect(pos_ == src_.size());
+        return ret;
+    }
+
+ private:
+    item_t read_value(void) {
+        skip_space();
+        expect(pos_ < src_.size());
+        char c = src_[pos_];
+        if (c == '{') {
+            tomload::table_t table;
+            ++pos_;
+            while (not consume('}')) {
+                if (not table.empty()) {
+                    expect(consume(','));
+                }
+                skip_space();
+                std::string key = read_string();
+                expect(consume(':'));
+                table.emplace(std::move(key), read_value());
+            }
+            return item_t{tomload::single_construct, std::move(table)};
+        } else if (c == '[') {
+            tomload::array_t array;
+            ++pos_;
+            while (not consume(']')) {
+                if (not array.empty()) {
+                    expect(consume(','));
+                }
+                array.push_back(read_value());
+            }
+            return item_t{tomload::single_construct, std::move(array)};
+        } else if (c == '"') {
+            return item_t{tomload::single_construct, read_string()};
+        } else if (src_.compare(pos_, 4, "true") == 0) {
+            pos_ += 4;
+            return item_t{tomload::single_construct, true};
+        } else if (src_.compare(pos_, 5, "false") == 0) {
+            pos_ += 5;
+            return item_t{tomload::single_construct, false};
+        }
+        size_t end = src_.find_first_not_of("+-0123456789.eE", pos_);
+        std::string number = src_.substr(pos_, end - pos_);
+        expect(not number.empty());
+        pos_ = end;
+        if (number.find_first_of(".eE") == std::string::npos) {
+            return item_t{tomload::single_construct, static_cast<tomload::integer_t>(std::stoll(number))};
+        }
+        return item_t{tomload::single_construct, std::stod(number)};
+    }
+
+    std::string read_string(void) {
+        expect(consume('"'));
+        std::string ret;
+        while (true) {
+            expect(pos_ < src_.size());
+            char c = src_[pos_++];
+            expect(static_cast<unsigned char>(c) >= 0x20);
+            if (c == '"') {
+                return ret;
+            } else if (c != '\\') {
+                ret += c;
+                continue;
+            }
+            expect(pos_ < src_.size());
+            char e = src_[pos_++];
+            const std::string escapes = "\"\\/bfnrt";
+            const std::string values = "\"\\/\b\f\n\r\t";
+            if (escapes.find(e) != std::string::npos) {
+                ret += values[escapes.find(e)];
+            } else {
+                expect((e == 'u') && (pos_ + 4 <= src_.size()));
+                long code = std::strtol(src_.substr(pos_, 4).c_str(), nullptr, 16);
+                expect(code < 0x80);  // enough for the control characters
+                ret += static_cast<char>(code);
+                pos_ += 4;
+            }
+        }
+    }
+
+    void skip_space(void) {
+        while ((pos_ < src_.size()) && (src_[pos_] == ' ')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_space();
+        if ((pos_ < src_.size()) && (src_[pos_] == c)) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(bool ok) const {
+        if (not ok) {
+            throw std::runtime_error("ill-formed JSON at " + std::to_string(pos_));
+        }
+    }
+
+    const std::string& src_;
+    size_t pos_ = 0;
+};
+
+/*
+ * @brief Decode one token of JSON Pointer.
+ */
+std::string unescape_pointer(const std::string& token) {
+    std::string ret;
+    for (size_t i = 0; i < token.size(); ++i) {
+        if ((token[i] == '~') && (i + 1 < token.size())) {
+            ret += (token[++i] == '1') ? '/' : '~';
+        } else {
+            ret += token[i];
+        }
+    }
+    return ret;
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::diff()") {
+    item_t before("[server]\nhost = \"a\"\nport = 80\n[db]\nnames = [\"x\", \"y\", \"z\"]\n[old]\nk = 1\n");
+    item_t after("[server]\nport = 8080\nip = \"b\"\n[db]\nnames = [\"x\", \"w\"]\n[new]\nk = 1\n");
+
+    std::vector<change_t> changes = tomload::diff(before, after);
+    REQUIRE(changes.size() == 7);
+
+    CHECK(changes[0].kind == tomload::CHANGE_REPLACE);
+    CHECK(tomload::to_json_pointer(changes[0].path) == "/db/names/1");
+    CHECK(changes[0].old_value->get_string() == "y");
+    CHECK(changes[0].new_value->get_string() == "w");
+    CHECK(changes[1].kind == tomload::CHANGE_REMOVE);
+    CHECK(tomload::to_json_pointer(changes[1].path) == "/db/names/2");
+    CHECK(changes[1].new_value == nullptr);
+    CHECK(changes[2].kind == tomload::CHANGE_ADD);
+    CHECK(tomload::to_json_pointer(changes[2].path) == "/new");
+    CHECK(changes[2].old_value == nullptr);
+    CHECK(changes[3].kind == tomload::CHANGE_REMOVE);
+    CHECK(tomload::to_json_pointer(changes[3].path) == "/old");
+    CHECK(changes[4].kind == tomload::CHANGE_REMOVE);
+    CHECK(tomload::to_json_pointer(changes[4].path) == "/server/host");
+    CHECK(changes[5].kind == tomload::CHANGE_ADD);
+    CHECK(tomload::to_json_pointer(changes[5].path) == "/server/ip");
+    CHECK(changes[6].kind == tomload::CHANGE_REPLACE);
+    CHECK(changes[6].path.size() == 2);
+    CHECK(changes[6].path[1].key() == "port");
+    CHECK(changes[6].old_value->get_integer() == 80);
+    CHECK(changes[6].new_value->get_integer() == 8080);
+
+    CHECK(tomload::to_json_patch(std::vector<change_t>(changes.begin(), changes.begin() + 2)) ==
+          "[{\"op\": \"replace\", \"path\": \"/db/names/1\", \"value\": \"w\"}, "
+          "{\"op\": \"remove\", \"path\": \"/db/names/2\"}]");
+
+    // identical documents and shared subtrees have no change.
+    CHECK(tomload::diff(before, item_t(before)).empty());
+    item_t updated = before.with({"server", "port"}, item_t("v = 81\n")["v"]);
+    changes = tomload::diff(before, updated);
+    REQUIRE(changes.size() == 1);
+    CHECK(tomload::to_json_pointer(changes[0].path) == "/server/port");
+
+    // the change of type is a replacement, and the root is the empty path.
+    item_t types("a = 1\nb = [1]\n");
+    item_t types2("a = 1.0\nb = { c = 1 }\n");
+    changes = tomload::diff(types, types2);
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].kind == tomload::CHANGE_REPLACE);
+    CHECK(changes[1].kind == tomload::CHANGE_REPLACE);
+    CHECK(changes[1].new_value->is_table());
+    changes = tomload::diff(types["b"], types2["a"]);
+    REQUIRE(changes.size() == 1);
+    CHECK(tomload::to_json_pointer(changes[0].path) == "");
+
+    // array grows at the tail.
+    changes = tomload::diff(item_t("a = [1]\n"), item_t("a = [1, 2, 3]\n"));
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].kind == tomload::CHANGE_ADD);
+    CHECK(tomload::to_json_pointer(changes[0].path) == "/a/1");
+    CHECK(tomload::to_json_pointer(changes[1].path) == "/a/2");
+}
+
+TEST_CASE("testing tomload::to_json_pointer()") {
+    CHECK(tomload::to_json_pointer({}) == "");
+    CHECK(tomload::to_json_pointer({"a", 0, "b/c", "d~e"}) == "/a/0/b~1c/d~0e");
+}
+
+TEST_CASE("testing tomload::to_json_patch() round trip") {
+    item_t before("a = 1\n");
+    item_t after("a = 1.0\n\"k/~\\\"\\u0001\" = { s = \"x\\ty\\u001f\\\\\", f = [1.0, -0.5, 1e300, 0.1], b = true }\n");
+
+    std::vector<change_t> changes = tomload::diff(before, after);
+    REQUIRE(changes.size() == 2);
+    std::string patch = tomload::to_json_patch(changes);
+
+    item_t records = json_reader_t(patch).read_document();
+    REQUIRE(records.size() == 2);
+    for (size_t i = 0; i < changes.size(); ++i) {
+        CAPTURE(patch);
+        CHECK(records[i]["op"].get_string() == ((i == 0) ? "replace" : "add"));
+        CHECK(records[i]["value"] == *changes[i].new_value);
+    }
+    CHECK(records[0]["value"].is_float());
+    CHECK(records[0]["value"].get_float() == 1.0);
+    std::string path = records[1]["path"].get_string();
+    REQUIRE(path.size() > 1);
+    CHECK(unescape_pointer(path.substr(1)) == "k/~\"\x01");
+
+    // nan and inf are strings, because JSON does not have them.
+    item_t special("a = [nan, inf, -inf, 1.5e-7]\n");
+    changes = tomload::diff(before, special);
+    REQUIRE(changes.size() == 1);
+    CHECK(tomload::to_json_patch(changes) ==
+          "[{\"op\": \"replace\", \"path\": \"/a\", \"value\": [\"nan\", \"inf\", \"-inf\", 1.5e-07]}]");
+}
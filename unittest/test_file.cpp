@@ -0,0 +1,61 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_file.cpp
+ * @brief testing tomload::load_file() using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <doctest/doctest.h>
+#include "tomload/file.h"
+#include "tomload/tomload.h"
+
+using tomload::document_t;
+using tomload::item_t;
+
+namespace {
+
+std::string read_all(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::load_file()") {
+    const std::string path = std::string(TOML_TEST_DIR) + "valid/table/keyword-with-values.toml";
+    std::string content = read_all(path);
+    REQUIRE_FALSE(content.empty());
+
+    tomload::mapped_file_t file(path);
+    CHECK(file.view() == tomload::view_t(content.data(), content.size()));
+
+    document_t doc = tomload::load_file(path);
+    CHECK(doc.root() == item_t(content));
+    CHECK(doc.file() == nullptr);  // nothing refers to the file
+
+    // lazy numbers refer to the file, so it is kept.
+    tomload::parse_options_t options;
+    options.lazy_numbers = true;
+    document_t lazy = tomload::load_file(path, options);
+    REQUIRE(lazy.file() != nullptr);
+    CHECK(lazy.file()->view() == file.view());
+    CHECK(lazy.root() == doc.root());
+
+    CHECK_THROWS_AS(tomload::load_file(std::string(TOML_TEST_DIR) + "no-such-file.toml"), std::system_error);
+    CHECK_THROWS_AS(tomload::load_file(std::string(TOML_TEST_DIR) + "invalid/table/append-with-dotted-keys-01.toml"), tomload::parse_error);
+}
+
+#if defined(__unix__)
+TEST_CASE("testing tomload::load_file(not mappable)") {
+    tomload::mapped_file_t file("/dev/null");
+    CHECK_FALSE(file.is_mapped());
+    CHECK(file.view().empty());
+    CHECK(tomload::load_file("/dev/null").root().size() == 0);
+}
+#endif
@@ -0,0 +1,119 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_frozen.cpp
+ * @brief testing tomload::freeze() and frozen_t using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/frozen.h"
+#include "tomload/tomload.h"
+
+using tomload::frozen_item_t;
+using tomload::frozen_t;
+using tomload::item_t;
+
+TEST_CASE("testing tomload::freeze()") {
+    item_t item("title = \"frozen\"\n[server]\nports = [80, 443]\nratio = 0.5\nenabled = true\n[server.tls]\ncert = \"a.pem\"\n");
+    frozen_t frozen = tomload::freeze(item);
+    frozen_item_t root = frozen.root();
+
+    CHECK(root.is_table() == true);
+    CHECK(root.size() == 2);
+    CHECK(root.contains("title") == true);
+    CHECK(root.contains("missing") == false);
+    CHECK(root["title"].get_string() == "frozen");
+    CHECK(root["server"]["ports"].is_array() == true);
+    CHECK(root["server"]["ports"].size() == 2);
+    CHECK(root["server"]["ports"][0].get_integer() == 80);
+    CHECK(root["server"]["ports"][1].get_integer() == 443);
+    CHECK(root["server"]["ratio"].get_float() == 0.5);
+    CHECK(root["server"]["enabled"].get_boolean() == true);
+    CHECK(root["server"]["tls"]["cert"].get_string() == "a.pem");
+
+    CHECK_THROWS_AS(root["title"].get_integer(), tomload::type_error&);
+    CHECK_THROWS_AS(root["title"].size(), tomload::type_error&);
+    CHECK_THROWS_AS(root[0], tomload::type_error&);
+    CHECK_THROWS_AS(root["missing"], std::out_of_range&);
+    CHECK_THROWS_AS(root["server"]["ports"][2], std::out_of_range&);
+
+    std::vector<tomload::view_t> keys;
+    for (frozen_item_t i : root["server"].children()) {
+        keys.push_back(i.key());
+    }
+    CHECK(keys == std::vector<tomload::view_t>{"enabled", "ports", "ratio", "tls"});
+
+    tomload::integer_t sum = 0;
+    for (frozen_item_t i : root["server"]["ports"].children()) {
+        sum += i.get_integer();
+    }
+    CHECK(sum == 523);
+}
+
+TEST_CASE("testing tomload::frozen_t(data, size)") {
+    frozen_t frozen = tomload::freeze(item_t("a = [\"x\", { b = 1 }]\n"));
+
+    // the block is trivially copyable.
+    std::vector<char> bytes(frozen.data(), frozen.data() + frozen.size());
+    frozen_t restored(bytes.data(), bytes.size());
+    bytes.assign(bytes.size(), '\0');
+
+    CHECK(restored.root()["a"][0].get_string() == "x");
+    CHECK(restored.root()["a"][1]["b"].get_integer() == 1);
+
+    CHECK_THROWS_AS(frozen_t(bytes.data(), bytes.size()), std::invalid_argument&);
+    CHECK_THROWS_AS(frozen_t(bytes.data(), 4), std::invalid_argument&);
+}
+
+TEST_CASE("testing tomload::frozen_t(data, size) with corrupt nodes") {
+    frozen_t frozen = tomload::freeze(item_t("a = [\"x\", { b = 1 }]\n"));
+    const size_t header_size = 16;  // magic, node_count and strings_offset
+    std::vector<tomload::frozen_node_t> nodes(4);
+    std::memcpy(nodes.data(), frozen.data() + header_size, nodes.size() * sizeof(tomload::frozen_node_t));
+    REQUIRE(nodes[1].type == tomload::frozen_node_t::TYPE_ARRAY);
+    REQUIRE(nodes[2].type == tomload::frozen_node_t::TYPE_STRING);
+
+    auto restore = [&](const std::vector<tomload::frozen_node_t>& corrupt) {
+        std::vector<char> bytes(frozen.data(), frozen.data() + frozen.size());
+        std::memcpy(&bytes[header_size], corrupt.data(), corrupt.size() * sizeof(tomload::frozen_node_t));
+        frozen_t restored(bytes.data(), bytes.size());
+    };
+    CHECK_NOTHROW(restore(nodes));
+
+    std::vector<tomload::frozen_node_t> corrupt = nodes;
+    corrupt[2].type = 9;
+    CHECK_THROWS_AS(restore(corrupt), std::invalid_argument&);
+    corrupt = nodes;
+    corrupt[2].size = 0x10000;
+    CHECK_THROWS_AS(restore(corrupt), std::invalid_argument&);
+    corrupt = nodes;
+    corrupt[1].key_offset = 0xffffffff;
+    CHECK_THROWS_AS(restore(corrupt), std::invalid_argument&);
+    corrupt = nodes;
+    corrupt[1].size = 100;
+    CHECK_THROWS_AS(restore(corrupt), std::invalid_argument&);
+    corrupt = nodes;
+    corrupt[1].value.offset = 0;  // a cycle
+    CHECK_THROWS_AS(restore(corrupt), std::invalid_argument&);
+}
+
+TEST_CASE("testing tomload::frozen_item_t::operator[](non-ASCII key)") {
+    // the keys are sorted as unsigned bytes like item_t's table.
+    frozen_t frozen = tomload::freeze(item_t("a = 1\n\"\u00e9\" = 2\nz = 3\n\"\u3042\" = 4\n"));
+    frozen_item_t root = frozen.root();
+
+    std::vector<tomload::view_t> keys;
+    for (frozen_item_t i : root.children()) {
+        keys.push_back(i.key());
+    }
+    CHECK(keys == std::vector<tomload::view_t>{"a", "z", "\xc3\xa9", "\xe3\x81\x82"});
+    CHECK(root["a"].get_integer() == 1);
+    CHECK(root["\xc3\xa9"].get_integer() == 2);
+    CHECK(root["z"].get_integer() == 3);
+    CHECK(root["\xe3\x81\x82"].get_integer() == 4);
+}
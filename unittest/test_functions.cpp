@@ -7,8 +7,13 @@
  * @note target version of C++ is C++14. 
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include <doctest/doctest.h>
 #include "tomload/tomload.h"
 #include "tomload/parser.h"
@@ -50,6 +55,41 @@ TEST_CASE("testing tomload::skip_space()") {
     }
 }
 
+TEST_CASE("testing tomload::table_registry_t") {
+    using keys_t = std::vector<tomload::text_t>;
+    tomload::table_registry_t tables;
+    tomload::parse_status_t status;
+
+    tables.check_dotted_keys(keys_t{"a", "b", "c"}, status);  // before the first header
+    CHECK_FALSE(status.failed());
+
+    CHECK_FALSE(tables.insert_header(keys_t{"a", "b", "c"}, status));
+    CHECK_FALSE(tables.insert_header(keys_t{"x"}, status));
+    CHECK(tables.insert_header(keys_t{"a", "b"}, status));  // super-table of [a.b.c]
+    CHECK_FALSE(status.failed());
+
+    tables.check_dotted_keys(keys_t{"d", "e"}, status);
+    tables.check_dotted_keys(keys_t{"c"}, status);  // not dotted
+    CHECK_FALSE(status.failed());
+    tables.check_dotted_keys(keys_t{"c", "d"}, status);  // [a.b.c] is already defined
+    CHECK(status.code() == tomload::PARSE_DUPLICATE_KEY);
+    status.reset();
+
+    CHECK(tables.insert_header(keys_t{"a"}, status));
+    CHECK_FALSE(status.failed());
+    tables.check_dotted_keys(keys_t{"b", "c", "d"}, status);
+    CHECK(status.code() == tomload::PARSE_DUPLICATE_KEY);
+    status.reset();
+
+    tables.insert_header(keys_t{"a", "b", "c"}, status);
+    CHECK(status.code() == tomload::PARSE_REDEFINED_TABLE);
+    status.reset();
+
+    // headers of the same keys under different parents
+    CHECK_FALSE(tables.insert_header(keys_t{"x", "a", "b"}, status));
+    CHECK_FALSE(status.failed());
+}
+
 TEST_CASE("testing tomload::item_t::item_t()") {
     {
         item_t result("[aa]  #comm\n");
@@ -76,3 +116,393 @@ TEST_CASE("testing tomload::item_t::item_t()") {
     }
 }
 
+
+TEST_CASE("testing tomload::item_t::item_t(dedup_strings)") {
+    const char src[] = "a = \"us-east-1\"\nb = [\"us-east-1\", \"enabled\"]\nc = { d = \"enabled\", e = \"x\" }\n";
+    {
+        tomload::parse_stats_t stats;
+        tomload::parse_options_t options;
+        options.stats = &stats;
+        item_t result(src, options);
+
+        CHECK(stats.strings == 5);
+        CHECK(stats.unique_strings == 5);
+        CHECK(stats.dedup_ratio() == 1.0);
+    }
+    {
+        tomload::parse_stats_t stats;
+        tomload::parse_options_t options;
+        options.dedup_strings = true;
+        options.stats = &stats;
+        item_t result(src, options);
+
+        CHECK(stats.strings == 5);
+        CHECK(stats.unique_strings == 3);
+        CHECK(stats.dedup_ratio() == doctest::Approx(5.0 / 3.0));
+        CHECK(result["a"].get_string() == "us-east-1");
+        CHECK(result["b"][0].get_string() == "us-east-1");
+        CHECK(result["b"][1].get_string() == "enabled");
+        CHECK(result["c"]["d"].get_string() == "enabled");
+        CHECK(result["c"]["e"].get_string() == "x");
+    }
+    {
+        // pooled and inline strings compare and hash by their contents.
+        tomload::parse_options_t options;
+        options.dedup_strings = true;
+        item_t pooled(src, options);
+        item_t inlined(src);
+        CHECK(pooled == inlined);
+        CHECK(pooled.hash() == inlined.hash());
+        CHECK(pooled["a"] == inlined["b"][0]);
+    }
+}
+
+TEST_CASE("testing tomload::item_t::operator=(descendant)") {
+    const char src[] = "a = { b = [\"a long string which is not in small buffer\", 1] }\n";
+    {
+        item_t result(src);
+        result = result["a"];
+        CHECK(result["b"][0].get_string() == "a long string which is not in small buffer");
+        result = result["b"][0];
+        CHECK(result.get_string() == "a long string which is not in small buffer");
+        result = result;
+        CHECK(result.get_string() == "a long string which is not in small buffer");
+    }
+    {
+        item_t result(src);
+        result = std::move(result["a"]["b"]);
+        CHECK(result[1].get_integer() == 1);
+        result = std::move(result[0]);
+        CHECK(result.get_string() == "a long string which is not in small buffer");
+    }
+}
+
+
+namespace {
+
+class counting_resource_t : public tomload::memory_resource {
+ public:
+    size_t allocations = 0;
+    size_t outstanding = 0;
+
+ private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += bytes;
+        return tomload::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        tomload::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const tomload::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+#if defined(TOMLOAD_USE_PMR)
+static_assert(std::is_same<tomload::memory_resource, std::pmr::memory_resource>::value,
+              "memory_resource must be std::pmr::memory_resource with TOMLOAD_USE_PMR");
+#endif
+
+TEST_CASE("testing tomload::item_t::item_t(resource)") {
+    const char src[] = "[server]\nname = \"a long string which is not in small buffer\"\nports = [80, 443]\n";
+    counting_resource_t resource;
+    {
+        tomload::parse_options_t options;
+        options.resource = &resource;
+        std::unique_ptr<item_t> result(new item_t(src, options));
+
+        CHECK(resource.allocations > 0);
+        CHECK(resource.outstanding > 0);
+        CHECK((*result)["server"]["name"].get_string() == "a long string which is not in small buffer");
+        CHECK((*result)["server"]["ports"][1].get_integer() == 443);
+
+        // a copy shares the nodes, and they are kept in the resource after the original is gone.
+        size_t allocations = resource.allocations;
+        item_t copy = *result;
+        CHECK(resource.allocations == allocations);
+        result.reset();
+        CHECK(resource.outstanding > 0);
+        CHECK(copy["server"]["ports"][0].get_integer() == 80);
+
+        // keys of table are std::string.
+        for (const auto& kv : copy.table_range()) {
+            const std::string& k = kv.first;
+            CHECK(k == "server");
+        }
+    }
+    CHECK(resource.outstanding == 0);
+    CHECK(tomload::get_default_resource() == tomload::new_delete_resource());
+}
+
+TEST_CASE("testing tomload::table_registry_t(allocation)") {
+    // keys longer than the small buffer are not copied for a check.
+    counting_resource_t resource;
+    tomload::resource_scope_t scope(&resource);
+    std::vector<tomload::text_t> header{"a_long_key_which_is_not_in_small_buffer", "another_long_key_of_the_header"};
+    std::vector<tomload::text_t> keys{"another_long_key_of_the_header", "x"};  // under the latest header
+    tomload::table_registry_t tables;
+    tomload::parse_status_t status;
+    tables.insert_header(header, status);
+    tables.insert_header(std::vector<tomload::text_t>{"a_long_key_which_is_not_in_small_buffer"}, status);
+
+    size_t allocations = resource.allocations;
+    tables.check_dotted_keys(keys, status);
+    CHECK(status.code() == tomload::PARSE_DUPLICATE_KEY);
+    CHECK(resource.allocations == allocations);
+}
+
+TEST_CASE("testing tomload::item_t::memory_usage()") {
+    const char src[] = "[server]\nname = \"a long string which is not in small buffer\"\nports = [80, 443]\n"
+                       "[client]\na_long_key_which_is_not_in_small_buffer = \"x\"\n";
+    counting_resource_t resource;
+    tomload::parse_options_t options;
+    options.resource = &resource;
+    item_t result(src, options);
+
+    tomload::memory_usage_t usage = result.memory_usage();
+    CHECK(usage.nodes > 0);
+    CHECK(usage.keys >= sizeof("a_long_key_which_is_not_in_small_buffer"));
+    CHECK(usage.strings >= sizeof("a long string which is not in small buffer"));
+    CHECK(usage.total() == usage.nodes + usage.keys + usage.strings + usage.slack);
+#if defined(__GLIBCXX__)
+    // the estimate matches the layout of libstdc++ exactly. a long key is std::string on the default heap.
+    CHECK(usage.total() == resource.outstanding + sizeof("a_long_key_which_is_not_in_small_buffer"));
+#endif
+
+    // subtree
+    tomload::memory_usage_t server = result["server"].memory_usage();
+    CHECK(server.total() < usage.total());
+    CHECK(server.keys == 0);
+    CHECK(server.strings == usage.strings);
+    CHECK(item_t(tomload::single_construct, true).memory_usage().total() == 0);
+
+    // shared nodes are counted once.
+    item_t copy = result;
+    CHECK(copy.memory_usage().total() == usage.total());
+    tomload::parse_options_t pooled;
+    pooled.dedup_strings = true;
+    const char repeated[] = "a = [\"a long string which is not in small buffer\", \"a long string which is not in small buffer\"]\n";
+    CHECK(item_t(repeated, pooled).memory_usage().strings * 2 == item_t(repeated).memory_usage().strings);
+}
+
+TEST_CASE("testing tomload::item_t::item_t(lazy_numbers)") {
+    tomload::parse_options_t options;
+    options.lazy_numbers = true;
+    {
+        std::string src = "a = 1_000\nb = -3.5e2\nc = [0, +7, 0.25]\nd = 9223372036854775807\ne = 1.7976931348623157e308\nf = 0xff\n";
+        item_t result(src, options);
+
+        int32_t a = 0;
+        CHECK(result["a"].get(a));
+        CHECK(a == 1000);
+        CHECK(result["a"].get_integer() == 1000);
+        CHECK(result["b"].get_float() == -350.0);
+        CHECK(result["c"][0].get_integer() == 0);
+        CHECK(result["c"][1].get_integer() == 7);
+        double c2 = 0.0;
+        CHECK(result["c"][2].get(c2));
+        CHECK(c2 == 0.25);
+        CHECK(result["d"].get_integer() == 9223372036854775807LL);
+        CHECK(result["e"].get_float() == 1.7976931348623157e308);
+        CHECK(result["f"].get_integer() == 255);
+
+        // a copy made before the first read is converted independently.
+        item_t copy = result["b"];
+        CHECK(copy.get_float() == -350.0);
+        CHECK_THROWS_AS(result["b"].get_integer(), tomload::type_error&);
+    }
+    {
+        // errors are still reported while parsing.
+        CHECK_THROWS_AS(item_t("a = 01\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = 1__0\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = 9223372036854775808\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = 1_.5\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = 1e400\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = +\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("a = -\n", options), tomload::parse_error&);
+        CHECK_THROWS_AS(item_t("b = [+]\n", options), tomload::parse_error&);
+    }
+    {
+        // lazy and eager parsing accept and reject the same documents.
+        const char* srcs[] = {
+            "a = +\n", "a = -\n", "b = [+]\n", "b = [-, 1]\n", "c = { d = + }\n", "a = +_1\n", "a = -0\n",
+            "a = +1\n", "a = 1_000\n", "a = 00\n", "a = 1_\n", "a = +.5\n", "a = -e5\n", "a = +1.5\n",
+            "a = 9223372036854775807\n", "a = -9223372036854775809\n", "a = 1.7976931348623157e309\n",
+        };
+        for (const char* src : srcs) {
+            bool eager = true;
+            bool lazy = true;
+            try { item_t{src}; } catch (const tomload::parse_error&) { eager = false; }
+            try { item_t(src, options); } catch (const tomload::parse_error&) { lazy = false; }
+            CAPTURE(src);
+            CHECK(eager == lazy);
+        }
+    }
+}
+
+namespace {
+
+struct type_name_t {
+    std::string operator()(tomload::boolean_t) const { return "boolean"; }
+    std::string operator()(tomload::integer_t) const { return "integer"; }
+    std::string operator()(tomload::float_t) const { return "float"; }
+    std::string operator()(view_t) const { return "string"; }
+    std::string operator()(const tomload::array_range_t&) const { return "array"; }
+    std::string operator()(const tomload::table_range_t&) const { return "table"; }
+};
+
+struct leaf_counter_t {
+    size_t operator()(const tomload::array_range_t& range) const {
+        size_t ret = 0;
+        for (const auto& i : range) {
+            ret += tomload::visit(i, *this);
+        }
+        return ret;
+    }
+    size_t operator()(const tomload::table_range_t& range) const {
+        size_t ret = 0;
+        for (const auto& i : range) {
+            ret += tomload::visit(i.second, *this);
+        }
+        return ret;
+    }
+    template <typename T>
+    size_t operator()(const T&) const { return 1; }
+};
+
+struct integer_of_t {
+    tomload::integer_t operator()(tomload::integer_t i) const { return i; }
+    template <typename T>
+    tomload::integer_t operator()(const T&) const { return -1; }
+};
+
+}  // namespace
+
+TEST_CASE("testing tomload::visit()") {
+    item_t result("a = true\nb = 1\nc = 1.5\nd = \"x\"\ne = [1, [2, 3]]\nf = { g = 4 }\n");
+
+    CHECK(tomload::visit(result["a"], type_name_t{}) == "boolean");
+    CHECK(tomload::visit(result["b"], type_name_t{}) == "integer");
+    CHECK(tomload::visit(result["c"], type_name_t{}) == "float");
+    CHECK(tomload::visit(result["d"], type_name_t{}) == "string");
+    CHECK(tomload::visit(result["e"], type_name_t{}) == "array");
+    CHECK(tomload::visit(result["f"], type_name_t{}) == "table");
+    CHECK(result.visit(type_name_t{}) == "table");
+    CHECK(tomload::visit(result, leaf_counter_t{}) == 8);
+
+    // the value is passed with its own type.
+    CHECK(tomload::visit(result["d"], [](auto value) { return std::is_same<decltype(value), view_t>::value; }) == true);
+    CHECK(tomload::visit(result["b"], [](auto value) { return std::is_same<decltype(value), tomload::integer_t>::value; }) == true);
+
+    // lazy numbers are converted before visiting.
+    tomload::parse_options_t options;
+    options.lazy_numbers = true;
+    std::string src = "n = 42\n";
+    item_t lazy(src, options);
+    CHECK(tomload::visit(lazy["n"], integer_of_t{}) == 42);
+}
+
+TEST_CASE("testing tomload::item_t::operator==() and hash()") {
+    item_t a("x = 1\ny = [1.5, \"s\", { z = true }]\n[t]\nk = \"v\"\n");
+    item_t b("[t]\nk = \"v\"\n\n[root]\n");
+    item_t c("y = [1.5, \"s\", { z = true }]\nx = 1\nt = { k = \"v\" }\n");
+
+    // tables are compared by keys and values, and table equals inline table.
+    CHECK(a == c);
+    CHECK(a.hash() == c.hash());
+    CHECK(a != b);
+    CHECK(a["t"] == b["t"]);
+    CHECK(a["t"].hash() == b["t"].hash());
+
+    // integer and float are different types.
+    item_t numbers("i = 1\nf = 1.0\nnan1 = nan\nnan2 = -nan\nz1 = 0.0\nz2 = -0.0\n");
+    CHECK(numbers["i"] != numbers["f"]);
+    CHECK(numbers["i"].hash() != numbers["f"].hash());
+    // NaN equals NaN, and 0.0 equals -0.0.
+    CHECK(numbers["nan1"] == numbers["nan2"]);
+    CHECK(numbers["nan1"].hash() == numbers["nan2"].hash());
+    CHECK(numbers["z1"] == numbers["z2"]);
+    CHECK(numbers["z1"].hash() == numbers["z2"].hash());
+
+    // shared nodes are equal, and the cache is reset by the update.
+    item_t copy = a;
+    CHECK(copy == a);
+    uint64_t before = a.hash();
+    item_t updated = a.with({"y", 2, "z"}, item_t("v = false\n")["v"]);
+    CHECK(a.hash() == before);
+    CHECK(updated != a);
+    CHECK(updated.hash() != before);
+    CHECK(updated["t"] == a["t"]);
+    item_t restored = updated.with({"y", 2, "z"}, item_t("v = true\n")["v"]);
+    CHECK(restored == a);
+    CHECK(restored.hash() == before);
+
+    // lazy numbers are compared by value.
+    tomload::parse_options_t options;
+    options.lazy_numbers = true;
+    std::string src = "x = 0x01\ny = [1.50, \"s\", { z = true }]\n[t]\nk = \"v\"\n";
+    item_t lazy(src, options);
+    CHECK(lazy.hash() == a.hash());
+    CHECK(lazy == a);
+
+    // the hash does not depend on the process.
+    CHECK(item_t("a = 1\n").hash() == item_t("a = 1\n").hash());
+}
+
+TEST_CASE("testing tomload::count_newlines() and locate()") {
+    CHECK(tomload::count_newlines("") == 0);
+    CHECK(tomload::count_newlines("a\nb\n") == 2);
+    for (size_t size : {15, 16, 17, 255 * 16, 255 * 16 + 1, 10000}) {
+        std::string text;
+        for (size_t i = 0; i < size; ++i) {
+            text.push_back((i % 3 == 0) ? '\n' : 'x');
+        }
+        CAPTURE(size);
+        CHECK(tomload::count_newlines(text) == static_cast<size_t>(std::count(text.begin(), text.end(), '\n')));
+        CHECK(tomload::count_newlines(view_t(text).substr(1)) == static_cast<size_t>(std::count(text.begin() + 1, text.end(), '\n')));
+    }
+
+    view_t source = "a = 1\nbb = 2\n\nc";
+    CHECK(tomload::locate(source, 0).line == 1);
+    CHECK(tomload::locate(source, 0).column == 1);
+    CHECK(tomload::locate(source, 5).column == 6);  // the newline belongs to line 1
+    CHECK(tomload::locate(source, 11).line == 2);
+    CHECK(tomload::locate(source, 11).column == 6);
+    CHECK(tomload::locate(source, 14).line == 4);
+    CHECK(tomload::locate(source, 14).column == 1);
+    CHECK(tomload::locate(source, 100).line == 4);
+    CHECK(tomload::locate(source, 100).column == 2);
+    CHECK(tomload::locate(source, std::string::npos).line == 0);
+}
+
+TEST_CASE("testing tomload::parse_error::offset()") {
+    std::string src = "a = 1\nb = [1, 2\nc = 3\n";
+    try {
+        item_t item(src);
+        FAIL("not thrown");
+    } catch (const tomload::parse_error& e) {
+        CHECK(e.offset() == src.find("\nc") + 1);
+        CHECK(e.locate(src).line == 3);
+        CHECK(e.locate(src).column == 1);
+        CHECK(e.format(src) == std::string("line 3, column 1: ") + e.what());
+    }
+
+    // the offset is in the pieces concatenated.
+    std::vector<view_t> pieces = {"a = 1\n", "b = 2\n", "a = 3\n"};
+    try {
+        item_t item(pieces, tomload::parse_options_t{});
+        FAIL("not thrown");
+    } catch (const tomload::parse_error& e) {
+        CHECK(e.offset() == 16);
+        CHECK(e.format("a = 1\nb = 2\na = 3\n") == "line 3, column 5: already reginstered");
+    }
+
+    // unknown offset
+    tomload::parse_error error("message");
+    CHECK(error.offset() == std::string::npos);
+    CHECK(error.format("a = 1\n") == "message");
+}
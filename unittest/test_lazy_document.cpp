@@ -0,0 +1,166 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_lazy_document.cpp
+ * @brief testing tomload::lazy_document_t using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/lazy_document.h"
+#include "tomload/tomload.h"
+
+using tomload::item_t;
+using tomload::lazy_document_t;
+
+namespace {
+
+std::string to_json(const item_t& item) {
+    std::ostringstream oss;
+    oss << item;
+    return oss.str();
+}
+
+// offset of parse_error which `f` throws.
+template <typename F>
+size_t error_offset(F f) {
+    try {
+        f();
+    } catch (const tomload::parse_error& e) {
+        return e.offset();
+    }
+    return 0;
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::lazy_document_t") {
+    const std::string src =
+        "title = \"lazy\"\n"
+        "owner.name = \"x\"\n"
+        "[service.frontend]\n"
+        "ports = [\n"
+        "  [80, 443],\n"
+        "]\n"
+        "[database]\n"
+        "note = '''\n"
+        "[not_a_header]\n"
+        "'''\n"
+        "quoted = \"[also not]\" # [comment]\n"
+        "  [service.backend]  # indented\n"
+        "threads = 4\n"
+        "[\"quoted key\"]\n"
+        "a = 1\n";
+    lazy_document_t doc(src);
+
+    CHECK(doc.size() == 5);
+    CHECK(doc.contains("title") == true);
+    CHECK(doc.contains("service") == true);
+    CHECK(doc.contains("quoted key") == true);
+    CHECK(doc.contains("not_a_header") == false);
+    CHECK(doc["title"].get_string() == "lazy");
+    CHECK(doc["owner"]["name"].get_string() == "x");
+    CHECK(doc.is_materialized("service") == false);
+    CHECK(doc.is_materialized("database") == false);
+
+    const item_t& service = doc["service"];
+    CHECK(doc.is_materialized("service") == true);
+    CHECK(doc.is_materialized("database") == false);
+    CHECK(service["frontend"]["ports"][0][1].get_integer() == 443);
+    CHECK(service["backend"]["threads"].get_integer() == 4);
+    CHECK(&doc["service"] == &service);
+
+    CHECK(doc["database"]["note"].get_string() == "[not_a_header]\n");
+    CHECK(doc["database"]["quoted"].get_string() == "[also not]");
+    CHECK(doc["quoted key"]["a"].get_integer() == 1);
+    CHECK_THROWS_AS(doc["missing"], std::out_of_range&);
+
+    CHECK(to_json(doc.root()) == to_json(item_t(src)));
+    size_t count = 0;
+    for (const auto& i : doc.table_range()) {
+        (void)i;
+        ++count;
+    }
+    CHECK(count == 5);
+}
+
+TEST_CASE("testing tomload::lazy_document_t errors") {
+    // errors in a section are reported when it is accessed.
+    const std::string src = "a = 1\n[good]\nb = 2\n[bad]\nc = \n[good.sub]\nd = 3\n";
+    lazy_document_t doc(src);
+    CHECK(doc["good"]["sub"]["d"].get_integer() == 3);
+    CHECK_THROWS_AS(doc["bad"], tomload::parse_error&);
+    CHECK_THROWS_AS(doc.root(), tomload::parse_error&);
+
+    // conflicts with the key-value pairs before the first header are detected.
+    lazy_document_t conflict("x = 1\n[x]\ny = 2\n");
+    CHECK_THROWS_AS(conflict["x"], tomload::parse_error&);
+    lazy_document_t duplicated("[x]\ny = 2\n[z]\n[x]\nw = 3\n");
+    CHECK_THROWS_AS(duplicated["x"], tomload::parse_error&);
+    CHECK(duplicated["z"].empty() == true);
+
+    // a group is parsed with the key-value pairs of its first key before the first header.
+    const std::string dotted = "a.b = 1\nx = [\n  1,\n]\n\"a\".c = 2 # a\n'y' = 3\n[a.d]\ne = 4\n";
+    lazy_document_t partial(dotted);
+    CHECK(to_json(partial["a"]) == to_json(item_t(dotted)["a"]));
+    CHECK(to_json(partial.root()) == to_json(item_t(dotted)));
+    lazy_document_t redefined("a.b.c = 1\nx = 1\n[a.b]\n");
+    CHECK_THROWS_AS(redefined["a"], tomload::parse_error&);
+    lazy_document_t inline_table("x = 1\na = {b = 1}\n[a.c]\n");
+    CHECK_THROWS_AS(inline_table["a"], tomload::parse_error&);
+    lazy_document_t other("x.a = 1\n[a]\n[x.b]\n");
+    CHECK(other["a"].empty() == true);
+    CHECK(other["x"]["a"].get_integer() == 1);
+
+    CHECK_THROWS_AS(lazy_document_t("a = \n[x]\n"), tomload::parse_error&);
+    CHECK_THROWS_AS(lazy_document_t("[x.]\n"), tomload::parse_error&);
+}
+
+TEST_CASE("testing tomload::lazy_document_t errors(offset)") {
+    // the offset of an error is in the whole document, the same as item_t.
+    const char* sources[] = {
+        "x = 1\n[a]\nk = 1\n[b]\nk = 1\n[c]\nk = = 2\n",
+        "x = 1\n[c]\nk = 1\n[b]\nk = 1\n[c.d]\nk = \"x\n",
+        "c.k = 1\nx = 1\n[b]\n[c]\nk = 2\n",
+        "x = 1\n[c]\nk = 1\n[b]\n[c]\n",
+    };
+    for (const char* src : sources) {
+        CAPTURE(src);
+        lazy_document_t doc(src);
+        size_t expected = error_offset([&] { item_t item(src); });
+        CHECK(expected > 0);
+        CHECK(error_offset([&] { doc["c"]; }) == expected);
+    }
+
+    // an error of a header is thrown by the constructor.
+    const std::string bad_header = "x = 1\n[a]\nk = 1\n[c.]\n";
+    CHECK(error_offset([&] { lazy_document_t doc(bad_header); }) == error_offset([&] { item_t item(bad_header); }));
+}
+
+TEST_CASE("testing tomload::lazy_document_t from threads") {
+    std::string src = "[big]\n";
+    for (int i = 0; i < 1000; ++i) {
+        src += "k" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+    }
+    lazy_document_t doc(src);
+
+    std::vector<const item_t*> results(8, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&doc, &results, i] { results[i] = &doc["big"]; });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (const item_t* p : results) {
+        CHECK(p == results.front());
+    }
+    CHECK(results.front()->size() == 1000);
+    CHECK((*results.front())["k999"].get_integer() == 999);
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_overlay.cpp
+ * @brief testing tomload::overlay_t and item_t::merged() using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/overlay.h"
+#include "tomload/tomload.h"
+
+using tomload::item_t;
+using tomload::overlay_t;
+
+TEST_CASE("testing tomload::item_t::merged()") {
+    item_t base("[server]\nhost = \"a\"\nport = 80\nports = [1, 2]\n[db]\nname = \"x\"\n");
+    item_t upper("[server]\nport = 8080\nports = [3]\ntls = { on = true }\n");
+
+    item_t merged = base.merged(upper);
+    CHECK(merged == item_t("[server]\nhost = \"a\"\nport = 8080\nports = [3]\ntls = { on = true }\n[db]\nname = \"x\"\n"));
+    CHECK(base["server"]["port"].get_integer() == 80);  // not modified
+    CHECK(upper.size() == 1);
+
+    // a value which is not a table replaces a table, and vice versa.
+    CHECK(base.merged(item_t("server = 1\n"))["server"].get_integer() == 1);
+    CHECK(item_t("a = 1\n").merged(item_t("a = { b = 2 }\n"))["a"]["b"].get_integer() == 2);
+    // merging with itself or an empty document changes nothing.
+    CHECK(base.merged(base) == base);
+    CHECK(base.merged(item_t("")) == base);
+}
+
+TEST_CASE("testing tomload::overlay_t") {
+    item_t defaults("[server]\nhost = \"localhost\"\nport = 80\n[log]\nlevel = \"info\"\n");
+    item_t region("[server]\nhost = \"eu.example.com\"\n[log]\nlevel = { value = \"debug\" }\n");
+    item_t host("[server]\nport = 8080\n[extra]\nk = 1\n");
+    overlay_t config({defaults, region, host});
+
+    CHECK(config.is_table());
+    CHECK(config.depth() == 3);
+    CHECK(config["server"]["host"].item().get_string() == "eu.example.com");
+    CHECK(config["server"]["port"].item().get_integer() == 8080);
+    CHECK(config["server"].depth() == 3);
+    CHECK(config["server"]["port"].depth() == 1);
+    CHECK(config["extra"]["k"].item().get_integer() == 1);
+    CHECK(config.keys() == std::vector<std::string>{"extra", "log", "server"});
+    CHECK(config["server"].keys() == std::vector<std::string>{"host", "port"});
+    CHECK(config.contains("log"));
+    CHECK_FALSE(config.contains("none"));
+    CHECK_THROWS_AS(config["none"], std::out_of_range);
+    CHECK_THROWS_AS(config["server"]["port"]["x"], tomload::type_error);
+
+    // a table hides the lower value which is not a table.
+    CHECK(config["log"]["level"].is_table());
+    CHECK(config["log"]["level"].depth() == 1);
+    CHECK(config["log"]["level"]["value"].item().get_string() == "debug");
+
+    // views keep the layers alive.
+    overlay_t server = overlay_t({defaults, host})["server"];
+    CHECK(server["host"].item().get_string() == "localhost");
+
+    item_t flat = config.flatten();
+    CHECK(flat == defaults.merged(region).merged(host));
+    CHECK(flat["server"]["host"].get_string() == "eu.example.com");
+    CHECK(flat["log"]["level"]["value"].get_string() == "debug");
+    CHECK(config["server"].flatten() == flat["server"]);
+    CHECK(config["server"]["port"].flatten() == flat["server"]["port"]);
+
+    CHECK_THROWS_AS(overlay_t(std::vector<item_t>{}), std::invalid_argument);
+}
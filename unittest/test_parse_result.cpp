@@ -0,0 +1,174 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_parse_result.cpp
+ * @brief testing tomload::try_parse() using doctest.
+ * @note target version of C++ is C++14.
+ */
+
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/parse_result.h"
+#include "tomload/tomload.h"
+#include "test_util.h"
+
+using tomload::parse_result_t;
+using tomload::try_parse;
+
+namespace {
+
+/*
+ * @brief Message of parse_error thrown by item_t, or empty if it is accepted.
+ */
+std::string thrown_message(const std::string& src) {
+    try {
+        tomload::item_t item(src);
+        return "";
+    } catch (const tomload::parse_error& e) {
+        return e.what();
+    }
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::try_parse()") {
+    const char* const sources[] = {
+        "",
+        "a = 1\nb = 'x'\nc = \"\\u00e9\\t\"\nd = \"\"\"\nline \\\n  next\"\"\"\n",
+        "a = [1, [2, {x = 1}], {y = 2}]\nb = {c.d = 1, c.e = {f = 2}}\n",
+        "[a.b]\nx = 1\n[a]\ny = 2\n[a.c]\nz = 3\n",
+        "a.b.c = 1\na.b.d = 2\n[x]\ny.z = 1\n",
+        // invalid
+        "a = 1\na = 2\n",
+        "[a]\n[a]\n",
+        "a.b = 1\n[a.b]\n",
+        "a = {b = 1}\na.c = 2\n",
+        "a = {b = 1}\n[a.c]\n",
+        "a = {b = 1, b = 2}\n",
+        "a = {b = {c = 1}, b.d = 2}\n",
+        "[a.b.c]\n[a]\nb.c.d = 1\n",
+        "a = \"\\uD800\"\n",
+        "a = \"\\q\"\n",
+        "a = 'x\n",
+        "a = 9223372036854775808\n",
+        "a = 0x1_\n",
+        "a = 1e999\n",
+        "a = 1.\n",
+        "a = 01\n",
+        "a = 1 b = 2\n",
+        "a = [1,\n",
+        "a = {b = 1,}\n",
+        "[a\n",
+        "= 1\n",
+        "a = 1\rb = 2\n",
+        "a = \x01\n",
+    };
+    for (const char* src : sources) {
+        CAPTURE(src);
+        parse_result_t result = try_parse(src);
+        std::string message = thrown_message(src);
+        CHECK(static_cast<bool>(result) == message.empty());
+        if (result) {
+            CHECK(result.value() == tomload::item_t(src));
+        } else {
+            CHECK(result.message() == message);
+            CHECK_THROWS_AS(result.value(), tomload::parse_error);
+        }
+    }
+}
+
+TEST_CASE("testing tomload::try_parse(error)") {
+    parse_result_t ok = try_parse("a = 1\n");
+    CHECK(ok);
+    CHECK(ok.error() == tomload::PARSE_OK);
+    CHECK(ok.value()["a"].get_integer() == 1);
+
+    std::string src = "a = 1\na = 2\n";
+    parse_result_t duplicate = try_parse(src);
+    CHECK(duplicate.error() == tomload::PARSE_DUPLICATE_KEY);
+    CHECK(duplicate.offset() == src.rfind('2'));  // at the value
+    CHECK(std::string(duplicate.message()) == "already reginstered");
+
+    src = "[a]\nx = 1\n[a]\n";
+    parse_result_t redefined = try_parse(src);
+    CHECK(redefined.error() == tomload::PARSE_REDEFINED_TABLE);
+    CHECK(redefined.offset() == src.rfind(']'));
+
+    src = "a = 1\nb = 1__0\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_NUMBER);
+    CHECK(try_parse(src).offset() == src.find("1__0"));
+
+    src = "a = 1\nb = 99999999999999999999\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_OUT_OF_RANGE);
+    CHECK(try_parse(src).offset() == src.find("999"));
+
+    src = "a = 1\nb = \"x\\qy\"\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_STRING);
+    CHECK(try_parse(src).offset() == src.find('q'));
+
+    src = "a = 1\nb = [1 2]\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_SYNTAX);
+    CHECK(try_parse(src).offset() == src.find('2'));
+
+    src = "a = 1\nb = 2\x7f\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_CONTROL_CHARACTER);
+    CHECK(try_parse(src).offset() == src.find('\x7f'));
+
+    src = "a = " + std::string(100000, '[') + std::string(100000, ']') + "\n";
+    CHECK(try_parse(src).error() == tomload::PARSE_TOO_DEEP);
+    CHECK(try_parse(src).offset() == 4 + tomload::DEFAULT_MAX_DEPTH);
+}
+
+TEST_CASE("testing tomload::parse_result_t::locate()") {
+    std::string src = "a = 1\n[t]\nb = [1,\n  2 3]\n";
+    parse_result_t result = try_parse(src);
+    REQUIRE_FALSE(result);
+    CHECK(result.locate(src).line == 4);
+    CHECK(result.locate(src).column == 5);
+    CHECK(result.format(src) == std::string("line 4, column 5: ") + result.message());
+
+    try {
+        result.value();
+        FAIL("not thrown");
+    } catch (const tomload::parse_error& e) {
+        CHECK(e.offset() == result.offset());
+    }
+
+    parse_result_t ok = try_parse("a = 1\n");
+    CHECK(ok.locate("a = 1\n").line == 0);
+    CHECK(ok.format("a = 1\n").empty());
+}
+
+TEST_CASE("testing tomload::try_parse(options)") {
+    std::string src = "a = 'x'\nb = 'x'\nc = 12\n";
+    tomload::parse_stats_t stats;
+    tomload::parse_options_t options;
+    options.dedup_strings = true;
+    options.lazy_numbers = true;
+    options.stats = &stats;
+    parse_result_t result = try_parse(src, options);
+    REQUIRE(result);
+    CHECK(result.value()["c"].get_integer() == 12);
+    CHECK(stats.strings == 2);
+    CHECK(stats.unique_strings == 1);
+}
+
+#if defined(__unix__)
+TEST_CASE("testing tomload::try_parse(toml-test)") {
+    std::vector<std::string> files;
+    test_util::list_files(std::string(TOML_TEST_DIR) + "valid", files);
+    test_util::list_files(std::string(TOML_TEST_DIR) + "invalid", files);
+    REQUIRE_FALSE(files.empty());
+    for (const std::string& path : files) {
+        std::string src = test_util::read_file(path);
+        CAPTURE(path);
+        parse_result_t result = try_parse(src);
+        std::string message = thrown_message(src);
+        CHECK(static_cast<bool>(result) == message.empty());
+        CHECK(std::string(result ? "" : result.message()) == message);
+        CHECK(result.offset() <= src.size());
+    }
+}
+#endif
@@ -0,0 +1,217 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_reader.cpp
+ * @brief testing tomload::reader_t using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/reader.h"
+#include "tomload/tomload.h"
+
+using tomload::reader_t;
+using tomload::token_t;
+using tomload::view_t;
+
+namespace {
+
+std::string to_string(view_t view) {
+    return std::string(view.data(), view.size());
+}
+
+std::string join(const std::vector<view_t>& keys) {
+    std::string ret;
+    for (view_t key : keys) {
+        ret += (ret.empty() ? "" : ".") + to_string(key);
+    }
+    return ret;
+}
+
+// offset of the error which reading all the tokens throws, or which item_t throws.
+size_t read_error_offset(const std::string& src, bool skip) {
+    try {
+        reader_t reader(src);
+        while (reader.next().kind != tomload::TOKEN_END) {
+            if (skip) {
+                reader.skip();
+            }
+        }
+    } catch (const tomload::parse_error& e) {
+        return e.offset();
+    }
+    return 0;
+}
+
+size_t parse_error_offset(const std::string& src) {
+    try {
+        tomload::item_t item(src);
+    } catch (const tomload::parse_error& e) {
+        return e.offset();
+    }
+    return 0;
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::reader_t::next()") {
+    std::string src =
+        "title = \"x\"  # comment\n"
+        "[server . \"m\\u0061in\"]\n"
+        "ports = [80, 0x1bb, [1.5], ]\n"
+        "opt = { a.b = true, c = 'lit' }\n"
+        "esc = \"a\\tb\"\n";
+    reader_t reader(src);
+
+    const token_t* t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_KEY);
+    CHECK(t->offset == 0);
+    CHECK(to_string(t->text) == "title");
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_STRING);
+    CHECK(to_string(t->text) == "x");
+    CHECK(t->text.data() == src.data() + 9);  // zero-copy
+    CHECK(t->offset == 8);
+
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_TABLE_HEADER);
+    CHECK(t->offset == src.find('['));
+    CHECK(to_string(t->text) == "server . \"m\\u0061in\"");
+    CHECK(join(reader.keys()) == "server.main");
+
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(join(reader.keys()) == "ports");
+    CHECK(reader.next().kind == tomload::TOKEN_ARRAY_BEGIN);
+    CHECK(reader.depth() == 1);
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_INTEGER);
+    CHECK(t->i == 80);
+    CHECK(to_string(t->text) == "80");
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_INTEGER);
+    CHECK(t->i == 443);
+    CHECK(reader.next().kind == tomload::TOKEN_ARRAY_BEGIN);
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_FLOAT);
+    CHECK(t->d == 1.5);
+    CHECK(reader.next().kind == tomload::TOKEN_ARRAY_END);
+    CHECK(reader.next().kind == tomload::TOKEN_ARRAY_END);
+    CHECK(reader.depth() == 0);
+
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(reader.next().kind == tomload::TOKEN_INLINE_TABLE_BEGIN);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(join(reader.keys()) == "a.b");
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_BOOLEAN);
+    CHECK(t->b == true);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(to_string(reader.next().text) == "lit");
+    CHECK(reader.next().kind == tomload::TOKEN_INLINE_TABLE_END);
+
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    t = &reader.next();
+    CHECK(t->kind == tomload::TOKEN_STRING);
+    CHECK(to_string(t->text) == "a\tb");
+    CHECK(t->offset == src.rfind('"', src.size() - 3));
+
+    CHECK(reader.next().kind == tomload::TOKEN_END);
+    CHECK(reader.next().kind == tomload::TOKEN_END);
+}
+
+TEST_CASE("testing tomload::reader_t::skip()") {
+    std::string src =
+        "a = [1, [2, \"\\u00e9\"], { x = 3 }]\n"
+        "b = { c = [4], d = \"\"\"\nmulti\"\"\" }\n"
+        "e = 5\n";
+    reader_t reader(src);
+
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    reader.skip();
+    CHECK(reader.depth() == 0);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(join(reader.keys()) == "b");
+    CHECK(reader.next().kind == tomload::TOKEN_INLINE_TABLE_BEGIN);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(reader.next().kind == tomload::TOKEN_ARRAY_BEGIN);
+    reader.skip();  // rest of the array
+    CHECK(reader.depth() == 1);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(join(reader.keys()) == "d");
+    CHECK(to_string(reader.next().text) == "multi");
+    CHECK(reader.next().kind == tomload::TOKEN_INLINE_TABLE_END);
+    CHECK(reader.next().kind == tomload::TOKEN_KEY);
+    CHECK(reader.next().i == 5);
+    CHECK(reader.next().kind == tomload::TOKEN_END);
+}
+
+TEST_CASE("testing tomload::reader_t::skip(invalid)") {
+    // skip() reports the same errors as next(), though it neither converts nor unescapes.
+    const char* invalids[] = {
+        "01", "1__0", "1_", "+", "-_1", "01.5", "1._5", "9223372036854775808", "1e400",
+        "\"\\x\"", "\"\\uD800\"", "\"\\u12\"", "\"\"\"\\q\"\"\"",
+    };
+    for (const char* value : invalids) {
+        std::string src = std::string("a = [1, ") + value + "]\n";
+        CAPTURE(src);
+        {
+            reader_t reader(src);
+            CHECK(reader.next().kind == tomload::TOKEN_KEY);
+            CHECK_THROWS_AS(reader.skip(), tomload::parse_error);
+        }
+        {
+            reader_t reader(src);
+            CHECK_THROWS_AS(while (reader.next().kind != tomload::TOKEN_END) {}, tomload::parse_error);
+        }
+    }
+}
+
+TEST_CASE("testing tomload::reader_t(invalid)") {
+    const char* invalids[] = {
+        "a = [1 2]\n",
+        "a = 1 b = 2\n",
+        "a = { b = 1, }\n",
+        "a = { b }\n",
+        "a = 1__0\n",
+        "[a\n",
+        "a 1\n",
+        "a = \"unclosed\n",
+    };
+    for (const char* src : invalids) {
+        reader_t reader(src);
+        CHECK_THROWS_AS(while (reader.next().kind != tomload::TOKEN_END) {}, tomload::parse_error);
+    }
+    CHECK_THROWS_AS(reader_t("a = \"\x01\"\n"), tomload::parse_error);
+}
+
+TEST_CASE("testing tomload::reader_t(offset)") {
+    // errors are located where item_t locates them.
+    const char* invalids[] = {
+        "a = 1\nb = \"x\n",
+        "a = 1\nb = [1 2]\n",
+        "a = 1\nb = 1 c = 2\n",
+        "a = 1\nb = { c = 1, }\n",
+        "a = 1\nb = 1__0\n",
+        "a = 1\nb = 9223372036854775808\n",
+        "a = 1\nb = 0x\n",
+        "a = 1\nb = \"\\q\"\n",
+        "a = 1\nb = '''x\n",
+        "a = 1\n[b\n",
+        "a = 1\nb 1\n",
+        "a = 1\n\"b\\q\" = 1\n",
+        "a = 1\nb = \"\x01\"\n",
+    };
+    for (const char* src : invalids) {
+        CAPTURE(src);
+        size_t expected = parse_error_offset(src);
+        CHECK(expected > 0);
+        CHECK(expected < std::string(src).size());  // located in the source
+        CHECK(read_error_offset(src, false) == expected);
+        CHECK(read_error_offset(src, true) == expected);
+    }
+    std::string src = "a = 1\nb = \"x\n";
+    CHECK(read_error_offset(src, false) == src.find('"') + 2);
+}
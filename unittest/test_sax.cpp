@@ -0,0 +1,151 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_sax.cpp
+ * @brief testing tomload::parse_events() using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/sax.h"
+#include "tomload/tomload.h"
+
+using tomload::view_t;
+
+namespace {
+
+/*
+ * @brief Record the events as strings.
+ */
+struct recorder_t : tomload::handler_t {
+    std::vector<std::string> events;
+    std::vector<const char*> strings;  // addresses of string values
+
+    static std::string join(const std::vector<tomload::text_t>& keys) {
+        std::string ret;
+        for (const auto& key : keys) {
+            ret += (ret.empty() ? "" : ".") + std::string(key.data(), key.size());
+        }
+        return ret;
+    }
+    void on_table_header(std::vector<tomload::text_t>& keys) override { events.push_back("[" + join(keys) + "]"); }
+    void on_key_value(std::vector<tomload::text_t>& keys) override { events.push_back(join(keys) + "="); }
+    void on_array_begin(void) override { events.push_back("a{"); }
+    void on_array_end(void) override { events.push_back("a}"); }
+    void on_inline_table_begin(void) override { events.push_back("t{"); }
+    void on_inline_table_end(void) override { events.push_back("t}"); }
+    void on_boolean(tomload::boolean_t value) override { events.push_back(value ? "true" : "false"); }
+    void on_integer(tomload::integer_t value) override { events.push_back("i:" + std::to_string(value)); }
+    void on_float(tomload::float_t value) override { events.push_back("f:" + std::to_string(value)); }
+    void on_string(view_t value) override {
+        events.push_back("s:" + std::string(value.data(), value.size()));
+        strings.push_back(value.data());
+    }
+};
+
+/*
+ * @brief Keep number tokens without conversion.
+ */
+struct token_recorder_t : tomload::handler_t {
+    std::vector<std::string> tokens;
+    void on_number(view_t token, bool is_float) override {
+        tokens.push_back((is_float ? "f:" : "i:") + std::string(token.data(), token.size()));
+    }
+};
+
+}  // namespace
+
+TEST_CASE("testing tomload::parse_events()") {
+    std::string src =
+        "title = \"x\"\n"
+        "[server.main]\n"
+        "ports = [80, 0x1bb, [1.5]]\n"
+        "opt = { a.b = true, c = 'lit' }\n"
+        "esc = \"a\\tb\"\n"
+        "multi = \"\"\"\nline\"\"\"\n";
+    recorder_t recorder;
+    tomload::parse_events(src, recorder);
+
+    std::vector<std::string> expected = {
+        "title=", "s:x",
+        "[server.main]",
+        "ports=", "a{", "i:80", "i:443", "a{", "f:1.500000", "a}", "a}",
+        "opt=", "t{", "a.b=", "true", "c=", "s:lit", "t}",
+        "esc=", "s:a\tb",
+        "multi=", "s:line",
+    };
+    CHECK(recorder.events == expected);
+
+    // strings without escape sequence refer to the source.
+    REQUIRE(recorder.strings.size() == 4);
+    CHECK(recorder.strings[0] == src.data() + src.find("x\""));
+    CHECK(recorder.strings[1] == src.data() + src.find("lit"));
+    CHECK(recorder.strings[3] == src.data() + src.find("line"));
+
+    // on_number() receives the decimal tokens before conversion.
+    token_recorder_t token_recorder;
+    tomload::parse_events("a = 1_000\nb = [6.02e23, 0xff, inf]\n", token_recorder);
+    CHECK(token_recorder.tokens == std::vector<std::string>{"i:1_000", "f:6.02e23"});
+
+    // only the syntax is checked.
+    recorder_t duplicated;
+    tomload::parse_events("a = 1\na = 2\n", duplicated);
+    CHECK(duplicated.events.size() == 4);
+    CHECK_THROWS_AS(tomload::item_t("a = 1\na = 2\n"), tomload::parse_error);
+    recorder_t invalid;
+    CHECK_THROWS_AS(tomload::parse_events("a = [1 2]\n", invalid), tomload::parse_error);
+    CHECK_THROWS_AS(tomload::parse_events("a = 1__0\n", invalid), tomload::parse_error);
+    CHECK_THROWS_AS(tomload::parse_events("a = { b = 1, }\n", invalid), tomload::parse_error);
+}
+
+TEST_CASE("testing tomload::parse_events(max_depth)") {
+    // nesting of 100k levels is parsed without recursion
+    const size_t depth = 100000;
+    std::string src = "a = " + std::string(depth, '[') + "1" + std::string(depth, ']') + "\n";
+    src += "b = " + std::string(depth / 2, '[') + std::string(depth / 2, ']') + "\n";
+    src += "c = {x = [{y = [1]}]}\n";
+
+    struct counter_t : tomload::handler_t {
+        size_t arrays = 0;
+        size_t tables = 0;
+        size_t open = 0;
+        size_t deepest = 0;
+        void on_array_begin(void) override { ++arrays; deepest = std::max(deepest, ++open); }
+        void on_array_end(void) override { --open; }
+        void on_inline_table_begin(void) override { ++tables; ++open; }
+        void on_inline_table_end(void) override { --open; }
+    };
+    counter_t counter;
+    counter.set_max_depth(depth);
+    tomload::parse_events(src, counter);
+    CHECK(counter.arrays == depth + depth / 2 + 2);
+    CHECK(counter.tables == 2);
+    CHECK(counter.open == 0);
+    CHECK(counter.deepest == depth);
+
+    // the limit
+    counter_t limited;
+    limited.set_max_depth(depth - 1);
+    try {
+        tomload::parse_events(src, limited);
+        FAIL("not thrown");
+    } catch (const tomload::parse_error& e) {
+        CHECK(e.offset() == 4 + depth - 1);
+        CHECK(std::string(e.what()) == "nesting too deep");
+    }
+    CHECK(limited.status().code() == tomload::PARSE_TOO_DEEP);
+
+    // default of item_t
+    std::string shallow = "a = " + std::string(tomload::DEFAULT_MAX_DEPTH, '[') + std::string(tomload::DEFAULT_MAX_DEPTH, ']') + "\n";
+    CHECK_NOTHROW(tomload::item_t{shallow});
+    CHECK_THROWS_AS(tomload::item_t{src}, tomload::parse_error);
+    CHECK_THROWS_AS(tomload::item_t{"a = " + std::string(depth, '[')}, tomload::parse_error);
+    tomload::parse_options_t options;
+    options.max_depth = 2;
+    CHECK_NOTHROW(tomload::item_t("a = [[1], {b = 2}]\n", options));
+    CHECK_THROWS_AS(tomload::item_t("a = [{b = [2]}]\n", options), tomload::parse_error);
+}
@@ -0,0 +1,271 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_stream_parser.cpp
+ * @brief testing tomload::stream_parser_t using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <algorithm>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/sax.h"
+#include "tomload/stream_parser.h"
+#include "tomload/tomload.h"
+#include "test_util.h"
+
+using tomload::item_t;
+using tomload::stream_parser_t;
+using tomload::view_t;
+
+namespace {
+
+const char* const source =
+    "# \"comment\" with 'quotes' [\r\n"
+    "title = \"a \\\"quoted\\\" \\u00e9 # not comment\"\r\n"
+    "lit = 'C:\\path'\n"
+    "multi = \"\"\"\n"
+    "line1 \\\n"
+    "   line2 \"\" \"\"\"\"\n"
+    "mlit = '''\n"
+    "x = [ '' ]'''\n"
+    "empty = \"\"\n"
+    "[server.\"a.b\"]  # header\n"
+    "ports = [\n"
+    "  80,  # http\n"
+    "  443,\n"
+    "]\n"
+    "limits = { cpu = 1.5e3, mem = 0x10, tags = [\"x\", 'y'] }\n"
+    "ratio = -0.25";
+
+item_t parse_in_chunks(view_t src, size_t size) {
+    stream_parser_t parser;
+    for (size_t pos = 0; pos < src.size(); pos += size) {
+        parser.feed(src.substr(pos, size));
+    }
+    parser.finish();
+    return parser.release();
+}
+
+/*
+ * @brief Message and offset of parse_error, or empty if it is accepted.
+ */
+template <typename Parse>
+std::string error_of(Parse parse) {
+    try {
+        parse();
+        return "";
+    } catch (const tomload::parse_error& e) {
+        return std::string(e.what()) + " @" + std::to_string(e.offset());
+    }
+}
+
+struct counter_t : tomload::handler_t {
+    size_t strings = 0;
+    void on_string(view_t) override { ++strings; }
+};
+
+struct broken_buf_t : std::streambuf {
+    int_type underflow(void) override { throw std::runtime_error("broken"); }
+};
+
+}  // namespace
+
+TEST_CASE("testing tomload::stream_parser_t") {
+    view_t src(source);
+    item_t expected(src);
+    REQUIRE(expected["multi"].get_string() == "line1 line2 \"\" \"");
+    REQUIRE(expected["mlit"].get_string() == "x = [ '' ]");
+
+    for (size_t size = 1; size <= src.size(); ++size) {
+        CAPTURE(size);
+        CHECK(parse_in_chunks(src, size) == expected);
+    }
+    // every split point of two chunks
+    for (size_t pos = 0; pos <= src.size(); ++pos) {
+        CAPTURE(pos);
+        stream_parser_t parser;
+        parser.feed(src.substr(0, pos));
+        parser.feed(src.substr(pos));
+        parser.finish();
+        CHECK(parser.release() == expected);
+    }
+}
+
+TEST_CASE("testing tomload::stream_parser_t(pending)") {
+    // only the incomplete statement is kept.
+    stream_parser_t parser;
+    for (int i = 0; i < 1000; ++i) {
+        parser.feed("key" + std::to_string(i) + " = \"value\"\n");
+        CHECK(parser.pending() == 0);
+    }
+    parser.feed("last = [1,\n2,");
+    CHECK(parser.pending() == 13);
+    parser.feed("3]\n");
+    CHECK(parser.pending() == 0);
+    parser.finish();
+    item_t item = parser.release();
+    CHECK(item.size() == 1001);
+    CHECK(item["last"].size() == 3);
+}
+
+TEST_CASE("testing tomload::stream_parser_t(pending, invalid)") {
+    // an unclosed array is reported at the first statement in it, not kept until finish().
+    std::string src = "a = [1,\n";
+    stream_parser_t parser;
+    parser.feed(src);
+    std::string error;
+    size_t pending = 0;
+    for (int i = 0; (i < 100000) && error.empty(); ++i) {
+        error = error_of([&] { parser.feed("b = 2\n"); });
+        src += "b = 2\n";
+        pending = (std::max)(pending, parser.pending());
+    }
+    CHECK(pending <= 16);
+    CHECK(error == error_of([&] { item_t{src + "b = 2\n"}; }));
+
+    const char* invalids[] = {
+        "a = [1,\nb = 2\nc = 3\n",
+        "a = [1,\n  \"b\" = 2\n",
+        "a = [1,\n1 = 2\n",
+        "a = [1,\ntrue = 2\n",
+        "a = [1, # comment\nb.c = [2]\n",
+        "a = {b = 1,\nc = 2\n",
+        "[a\nb = 2\n",
+        "a = [\"\"\"\nb = \"\"\", 1,\n2]\nc = 1 2\n",  // the line starts in a string
+    };
+    for (const std::string src : invalids) {
+        std::string expected = error_of([&] { item_t{src}; });
+        CAPTURE(src);
+        REQUIRE_FALSE(expected.empty());
+        for (size_t size : {size_t(1), size_t(3), tomload::default_stream_buffer_size}) {
+            CAPTURE(size);
+            CHECK(error_of([&] { parse_in_chunks(src, size); }) == expected);
+        }
+    }
+
+    // a multi-line array whose lines look like statements in strings is valid
+    src = "a = [\n  '''\nb = 1\n''',\n  \"c = 2\",\n]\nd = 3\n";
+    CHECK(parse_in_chunks(src, 1) == item_t(src));
+}
+
+TEST_CASE("testing tomload::stream_parser_t(handler)") {
+    counter_t counter;
+    stream_parser_t parser(counter);
+    parser.feed("a = \"x\"\nb = [\"y\"");
+    CHECK(counter.strings == 1);
+    parser.feed(", 'z']");
+    parser.finish();
+    CHECK(counter.strings == 3);
+    CHECK_THROWS_AS(parser.release(), std::logic_error);
+    CHECK_THROWS_AS(parser.feed("c = 1\n"), std::logic_error);
+}
+
+TEST_CASE("testing tomload::stream_parser_t(invalid)") {
+    {
+        stream_parser_t parser;
+        CHECK_THROWS_AS(parser.feed("a = 1\na = 2\n"), tomload::parse_error);
+    }
+    {
+        stream_parser_t parser;
+        parser.feed("a = \"unclosed");
+        CHECK_THROWS_AS(parser.finish(), tomload::parse_error);
+    }
+    {
+        stream_parser_t parser;
+        parser.feed("a = [1,\n");
+        CHECK_THROWS_AS(parser.finish(), tomload::parse_error);
+    }
+    {
+        stream_parser_t parser;
+        CHECK_THROWS_AS(parser.feed("a = \"x\nb = 1\n"), tomload::parse_error);
+    }
+    try {
+        // the offset is in the whole document, not in the chunk.
+        stream_parser_t parser;
+        parser.feed("a = 1\nb = ");
+        parser.feed("2\nc = 1__0\n");
+        FAIL("not thrown");
+    } catch (const tomload::parse_error& e) {
+        CHECK(e.offset() == 16);
+    }
+    {
+        stream_parser_t parser;
+        parser.finish();
+        CHECK(parser.release().size() == 0);
+    }
+}
+
+TEST_CASE("testing tomload::parse_stream()") {
+    view_t src(source);
+    item_t expected(src);
+    for (size_t size : {size_t(1), size_t(7), tomload::default_stream_buffer_size}) {
+        CAPTURE(size);
+        std::istringstream in(source);
+        CHECK(tomload::parse_stream(in, tomload::parse_options_t{}, size) == expected);
+    }
+
+    std::istringstream in(source);
+    counter_t counter;
+    tomload::parse_stream(in, counter, 16);
+    CHECK(counter.strings == 7);
+
+    std::istringstream empty("");
+    CHECK(tomload::parse_stream(empty).size() == 0);
+
+    std::istringstream invalid("a = 1\na = 2\n");
+    CHECK_THROWS_AS(tomload::parse_stream(invalid), tomload::parse_error);
+    std::istringstream zero("a = 1\n");
+    CHECK_THROWS_AS(tomload::parse_stream(zero, tomload::parse_options_t{}, 0), std::invalid_argument);
+
+    broken_buf_t buf;
+    std::istream broken(&buf);
+    CHECK_THROWS_AS(tomload::parse_stream(broken), std::ios_base::failure);
+}
+
+TEST_CASE("testing tomload::stream_parser_t(chunk size)") {
+    // a statement is cut at a newline in an unclosed string, but the error must be the same as item_t's.
+    const char* invalids[] = {
+        "a = 'x\nb = 'y'\n",
+        "a = 'x\r\nb = 1\n",
+        "a = \"x\nb = \"y\"\n",
+        "a = \"\\u1\nb = \"y\"\n",
+        "a = \"\\U0001\nb = \"y\"\n",
+        "a = \"\\\nb = \"y\"\n",
+        "a = ['x\n, 'y']\n",
+        "'k\ney' = 1\n",
+    };
+    for (const std::string src : invalids) {
+        std::string expected = error_of([&] { item_t{src}; });
+        CAPTURE(src);
+        REQUIRE_FALSE(expected.empty());
+        for (size_t size : {size_t(1), size_t(3), tomload::default_stream_buffer_size}) {
+            CAPTURE(size);
+            CHECK(error_of([&] { parse_in_chunks(src, size); }) == expected);
+        }
+    }
+}
+
+#if defined(__unix__)
+TEST_CASE("testing tomload::stream_parser_t(toml-test)") {
+    // the error does not depend on the size of chunks.
+    std::vector<std::string> files;
+    test_util::list_files(std::string(TOML_TEST_DIR) + "invalid", files);
+    REQUIRE_FALSE(files.empty());
+    for (const std::string& path : files) {
+        std::string src = test_util::read_file(path);
+        std::string expected = error_of([&] { item_t{src}; });
+        CAPTURE(path);
+        for (size_t size : {size_t(1), size_t(2), size_t(7), tomload::default_stream_buffer_size}) {
+            CAPTURE(size);
+            CHECK(error_of([&] { parse_in_chunks(src, size); }) == expected);
+        }
+    }
+}
+#endif
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_util.h
+ * @brief helpers shared by the unit tests which read the toml-test corpus.
+ * @note target version of C++ is C++14.
+ */
+
+#ifndef TOMLOAD_UNITTEST_TEST_UTIL_H_
+#define TOMLOAD_UNITTEST_TEST_UTIL_H_
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#if defined(__unix__)
+#include <dirent.h>
+#endif
+
+namespace test_util {
+
+#if defined(__unix__)
+/*
+ * @brief Append the paths of the .toml files under `dir` recursively.
+ * @param dir[in]: directory to search. nothing is appended if it does not exist.
+ * @param files[in,out]: receives the paths.
+ */
+inline void list_files(const std::string& dir, std::vector<std::string>& files) {
+    DIR* p = ::opendir(dir.c_str());
+    if (p == nullptr) {
+        return;
+    }
+    while (struct dirent* entry = ::readdir(p)) {
+        std::string name = entry->d_name;
+        if ((name == ".") || (name == "..")) {
+            continue;
+        } else if ((name.size() > 5) && (name.compare(name.size() - 5, 5, ".toml") == 0)) {
+            files.push_back(dir + "/" + name);
+        } else {
+            list_files(dir + "/" + name, files);
+        }
+    }
+    ::closedir(p);
+}
+/////////////////////////////////////////////////////////////////////////////
+#endif
+
+/*
+ * @brief Read the whole file as binary.
+ */
+inline std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+/////////////////////////////////////////////////////////////////////////////
+
+}  // namespace test_util
+
+#endif  // TOMLOAD_UNITTEST_TEST_UTIL_H_
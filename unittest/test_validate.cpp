@@ -0,0 +1,244 @@
+// Copyright (c) 2025 suomesta
+// Distributed under the MIT Software License
+
+/*
+ * @file unittest/test_validate.cpp
+ * @brief testing tomload::validate() using doctest.
+ * @note target version of C++ is C++14. 
+ */
+
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "tomload/tomload.h"
+#include "tomload/validate.h"
+#include "test_util.h"
+
+using tomload::lint;
+using tomload::lint_result_t;
+using tomload::validate;
+using tomload::validate_result_t;
+using tomload::view_t;
+
+namespace {
+
+bool is_accepted(const std::string& src) {
+    try {
+        tomload::item_t item(src);
+        return true;
+    } catch (const tomload::parse_error&) {
+        return false;
+    }
+}
+
+// the error which item_t throws, or a valid result if it accepts the source.
+validate_result_t parse_error_of(const std::string& src) {
+    validate_result_t result;
+    try {
+        tomload::item_t item(src);
+    } catch (const tomload::parse_error& e) {
+        result.valid = false;
+        result.offset = e.offset();
+        result.message = e.what();
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("testing tomload::validate()") {
+    const char* const sources[] = {
+        "",
+        "a = 1\nb = 'x'\nc = \"\\u00e9\\t\"\nd = \"\"\"\nline \\\n  next\"\"\"\n",
+        "a = [1, [2, {x = 1}], {y = 2}]\nb = {c.d = 1, c.e = {f = 2}}\n",
+        "[a.b]\nx = 1\n[a]\ny = 2\n[a.c]\nz = 3\n",
+        "a.b.c = 1\na.b.d = 2\n[x]\ny.z = 1\n",
+        "# comment\r\nkey = 0x7fffffffffffffff\r\nf = 1.7976931348623157e308\n",
+        "\"a.b\" = 1\na.b = 2\n",
+        // invalid
+        "a = 1\na = 2\n",
+        "[a]\n[a]\n",
+        "a.b = 1\n[a.b]\n",
+        "a = {b = 1}\na.c = 2\n",
+        "a = {b = 1}\n[a]\n",
+        "a = {b = 1}\n[a.c]\n",
+        "a = [1]\n[a.b]\n",
+        "a = 1\na.b = 2\n",
+        "a = {b = 1, b = 2}\n",
+        "a = {b = {c = 1}, b.d = 2}\n",
+        "a = [{b = 1, b = 2}]\n",
+        "[a.b.c]\n[a]\nb.c.d = 1\n",
+        "[a.b.c]\n[a]\nb.c = 1\n",
+        "a = \"\\uD800\"\n",
+        "a = \"\\q\"\n",
+        "a = 9223372036854775808\n",
+        "a = 1e999\n",
+        "a = 01\n",
+        "a = 1__0\n",
+        "a = 1 b = 2\n",
+        "a = [1,\n",
+        "a = 1\rb = 2\n",
+        "a = \x01\n",
+        "a = +\n",
+        "a = -\n",
+        "a = [+]\n",
+    };
+    for (const char* src : sources) {
+        CAPTURE(src);
+        CHECK(static_cast<bool>(validate(src)) == is_accepted(src));
+    }
+}
+
+TEST_CASE("testing tomload::validate(offset)") {
+    validate_result_t ok = validate("a = 1\n");
+    CHECK(ok.valid);
+    CHECK(ok.message.empty());
+
+    std::string src = "a = 1\nb = \"\\uD800\"\n";
+    validate_result_t bad_escape = validate(src);
+    CHECK_FALSE(bad_escape);
+    CHECK(bad_escape.offset == src.find("D800"));  // at the escape sequence
+    CHECK(bad_escape.code == tomload::PARSE_STRING);
+    CHECK_FALSE(bad_escape.message.empty());
+
+    src = "a = 1\nb = 01\n";
+    CHECK(validate(src).offset == src.find("01"));
+
+    src = "a = 1\nb = 2\x7f\n";
+    CHECK(validate(src).offset == src.find('\x7f'));
+    CHECK(validate(src).message == "detect disallowed character");
+
+    src = "a = +\n";  // a sign without digits
+    CHECK_FALSE(validate(src));
+    CHECK(validate(src).code == tomload::PARSE_NUMBER);
+    CHECK(validate(src).message == "missing integer digits");
+
+    src = "a = 1\r\nb = 2\r";
+    CHECK(validate(src).offset == src.size() - 1);
+    CHECK(validate(src).message == "detect single CR");
+
+    src = "a = {b = 1}\nc = 2\na.d = 3\n";
+    CHECK(validate(src).offset > src.find("a.d"));
+
+    src = "a = " + std::string(100000, '[') + "\n";
+    CHECK(validate(src).code == tomload::PARSE_TOO_DEEP);
+}
+
+TEST_CASE("testing tomload::lint()") {
+    lint_result_t ok = lint("a = 1\n[t]\nb = [1, {c = 2}]\n");
+    CHECK(ok);
+    CHECK_FALSE(ok.truncated);
+
+    // an error on each line
+    std::string src = "a = 1\na = 2\nb = 01\nc = [1 2]\nd = \"\\q\"\ne = 3\n";
+    lint_result_t result = lint(src);
+    REQUIRE(result.errors.size() == 4);
+    CHECK(result.errors[0].code == tomload::PARSE_DUPLICATE_KEY);
+    CHECK(result.errors[0].offset == src.find("2"));
+    CHECK(result.errors[1].code == tomload::PARSE_NUMBER);
+    CHECK(result.errors[1].offset == src.find("01"));
+    CHECK(result.errors[2].code == tomload::PARSE_SYNTAX);
+    CHECK(result.errors[2].offset == src.find("2]"));
+    CHECK(result.errors[3].code == tomload::PARSE_STRING);
+    CHECK_FALSE(result.truncated);
+    CHECK(result.errors[0].message == validate(src).message);
+    CHECK(result.errors[0].offset == validate(src).offset);
+
+    // resumed at the next statement, not inside the array
+    src = "a = [\n  1 2,\n  3,\n]\nb = 1\nb = 2\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 2);
+    CHECK(result.errors[0].offset == src.find("2,"));
+    CHECK(result.errors[1].offset == src.rfind('2'));
+
+    // the table of a bad header is skipped, and the registry is kept
+    src = "[a]\nx = 1\n[a]\nx = 2\n[b]\ny = 1\n[a]\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 2);
+    CHECK(result.errors[0].code == tomload::PARSE_REDEFINED_TABLE);
+    CHECK(result.errors[1].code == tomload::PARSE_REDEFINED_TABLE);
+    CHECK(result.errors[1].offset == src.rfind(']'));
+
+    // control characters are merged in the order of the offsets
+    src = "a = 1\x01\nb = 01\nc = 'x\x7f'\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 3);
+    CHECK(result.errors[0].code == tomload::PARSE_CONTROL_CHARACTER);
+    CHECK(result.errors[0].offset == src.find('\x01'));
+    CHECK(result.errors[1].code == tomload::PARSE_NUMBER);
+    CHECK(result.errors[2].code == tomload::PARSE_CONTROL_CHARACTER);
+    CHECK(result.errors[2].offset == src.find('\x7f'));
+
+    // the lines in a multi-line string which has an error are not statements
+    src = "a = \"\"\"\nfoo \\q\nb = 1\n\"\"\"\nb = 2\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 1);
+    CHECK(result.errors[0].offset == 13);
+    CHECK(result.errors[0].code == tomload::PARSE_STRING);
+    src = "a = \"\"\"\nfoo \\q\n[t]\nk = 1\n\"\"\"\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 1);
+    CHECK(result.errors[0].offset == 13);
+    src = "a = [1, '''\n[t]\n''', 01]\nb = '''\nx\n'''\nc = 2\n";
+    result = lint(src);
+    REQUIRE(result.errors.size() == 1);
+    CHECK(result.errors[0].offset == src.find("01"));
+    src = "a = \"\"\"\\q\nb = 1\nc = 1 d\n";  // unterminated
+    result = lint(src);
+    REQUIRE(result.errors.size() == 1);
+    CHECK(result.errors[0].offset == validate(src).offset);
+}
+
+TEST_CASE("testing tomload::lint(max_errors)") {
+    std::string src;
+    for (int i = 0; i < 10; ++i) {
+        src += "a = " + std::to_string(i) + "\n";
+    }
+    CHECK(lint(src).errors.size() == 9);
+    CHECK_FALSE(lint(src).truncated);
+
+    lint_result_t result = lint(src, 3);
+    CHECK(result.errors.size() == 3);
+    CHECK(result.truncated);
+    CHECK(result.errors[2].offset == src.find("3"));
+
+    CHECK(lint(src, 9).errors.size() == 9);
+    CHECK_FALSE(lint(src, 9).truncated);
+
+    CHECK(lint(src, 0).errors.empty());
+    CHECK(lint(src, 0).truncated);
+    CHECK_FALSE(lint("a = 1\n", 0).truncated);
+
+    src = "\x01\x01\x01a = 1\na = 2\n";
+    result = lint(src, 2);
+    CHECK(result.errors.size() == 2);
+    CHECK(result.errors[1].offset == 1);
+    CHECK(result.truncated);
+}
+
+#if defined(__unix__)
+TEST_CASE("testing tomload::validate(toml-test)") {
+    std::vector<std::string> files;
+    test_util::list_files(std::string(TOML_TEST_DIR) + "valid", files);
+    test_util::list_files(std::string(TOML_TEST_DIR) + "invalid", files);
+    REQUIRE_FALSE(files.empty());
+    for (const std::string& path : files) {
+        std::string src = test_util::read_file(path);
+        CAPTURE(path);
+        validate_result_t expected = parse_error_of(src);
+        validate_result_t actual = validate(src);
+        CHECK(actual.valid == expected.valid);
+        if ((actual.code == tomload::PARSE_DUPLICATE_KEY) || (actual.code == tomload::PARSE_REDEFINED_TABLE)) {
+            CHECK(actual.offset <= expected.offset);
+        } else if (not actual.valid) {
+            CHECK(actual.message == expected.message);
+            CHECK(actual.offset == expected.offset);
+        }
+        lint_result_t result = lint(src);
+        CHECK(static_cast<bool>(result) == is_accepted(src));
+        if (not result && (validate(src).code != tomload::PARSE_CONTROL_CHARACTER)) {
+            CHECK(result.errors.front().offset == validate(src).offset);
+        }
+    }
+}
+#endif